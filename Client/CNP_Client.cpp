@@ -19,7 +19,8 @@
 #include "CNP_Client.h"
 #include "../Include/CNP_Protocol.h"
 
-char g_szBuffer[512] = { 0 };
+/// large enough for a full cnp::TRANSACTION_QUERY_RESPONSE frame
+char g_szBuffer[4096] = { 0 };
 
 #define CASE_CERTYPE(cer) \
         case cer: \
@@ -288,12 +289,44 @@ cnp::CER_TYPE SendBalance(CNP_Socket& socket, cnp::WORD wClientID)
 
 
 
+/**
+    @brief Receives exactly one message frame, its header then the data
+           the header gives the length of
+
+    @retval true  on success
+    @retval false if the connection failed, or the frame is larger than cbLen
+ */
+bool ReceiveFrame(CNP_Socket& socket, void* pBuffer, size_t cbLen)
+{
+    char*  pData    = static_cast<char*>(pBuffer);
+    size_t cbFrame  = sizeof(cnp::STD_HDR);
+    size_t cbRecvd  = 0;
+
+    while (cbRecvd < cbFrame)
+    {
+        int iRecvd = socket.Receive(pData + cbRecvd, cbFrame - cbRecvd);
+        if (iRecvd <= 0)
+            return false;
+
+        cbRecvd += static_cast<size_t>(iRecvd);
+
+        if (cbRecvd == sizeof(cnp::STD_HDR))
+        {
+            cbFrame += reinterpret_cast<const cnp::STD_HDR*>( pData )->m_wDataLen;
+            if (cbFrame > cbLen)
+                return false;
+        }
+    }
+
+    return true;
+};
+
 cnp::CER_TYPE SendTransaction(CNP_Socket& socket, cnp::WORD wClientID)
 {
     cnp::CER_TYPE  cerResult = cnp::CER_ERROR;
     bool       bMoreRecords = true;
     cnp::DWORD dwStartID = 0;
-    cnp::WORD  wTransCnt = 5;
+    cnp::WORD  wTransCnt = 1000;
     while (bMoreRecords)
     {
         cnp::TRANSACTION_QUERY_REQUEST     transReq(wClientID, dwStartID, wTransCnt);
@@ -301,14 +334,25 @@ cnp::CER_TYPE SendTransaction(CNP_Socket& socket, cnp::WORD wClientID)
         std::cout << "..." << __FUNCTION__ << " Request" << std::endl;
 
         socket.Send(&transReq, transReq.get_Size());
-        socket.Receive(g_szBuffer, sizeof(g_szBuffer) - 1);
 
-        const cnp::TRANSACTION_QUERY_RESPONSE* pResp = reinterpret_cast<cnp::TRANSACTION_QUERY_RESPONSE*>( g_szBuffer );
-        cerResult = static_cast<cnp::CER_TYPE>( pResp->get_ResponseResult() );
-
-        std::cout << "..." << __FUNCTION__ << " Result:" << CerTypeToString(cerResult) << std::endl;
-        if (cnp::Succeeded(cerResult))
+        // the server streams the records back in frames of at most
+        // cnp::MAX_TRANSACTIONS_PER_RESPONSE, ended by a short frame
+        cnp::WORD wTotal      = 0;
+        bool      bMoreFrames = true;
+        while (bMoreFrames)
         {
+            if (ReceiveFrame(socket, g_szBuffer, sizeof(g_szBuffer)) == false)
+                return cnp::CER_ERROR;
+
+            const cnp::TRANSACTION_QUERY_RESPONSE* pResp = reinterpret_cast<cnp::TRANSACTION_QUERY_RESPONSE*>( g_szBuffer );
+            cerResult = static_cast<cnp::CER_TYPE>( pResp->get_ResponseResult() );
+
+            if (cnp::Succeeded(cerResult) == false)
+            {
+                std::cout << "..." << __FUNCTION__ << " Result:" << CerTypeToString(cerResult) << std::endl;
+                return cerResult;
+            }
+
             cnp::WORD wCnt = pResp->get_TransactionCount();
 
             for (cnp::WORD i = 0; i < wCnt; i++)
@@ -320,15 +364,18 @@ cnp::CER_TYPE SendTransaction(CNP_Socket& socket, cnp::WORD wClientID)
                           << " " << TransTypeToString(pResp->m_Response.m_rgTransactions[i].get_Type()) << std::endl;
             }
 
-            if (wCnt < wTransCnt)
-                bMoreRecords = false;
-            else
+            wTotal += wCnt;
+            if (wCnt > 0)
                 dwStartID = pResp->m_Response.m_rgTransactions[wCnt - 1].get_ID() + 1;
+
+            if (wCnt < cnp::MAX_TRANSACTIONS_PER_RESPONSE || wTotal >= wTransCnt)
+                bMoreFrames = false;
         }
-        else
-        {
+
+        std::cout << "..." << __FUNCTION__ << " Result:" << CerTypeToString(cerResult) << std::endl;
+
+        if (wTotal < wTransCnt)
             bMoreRecords = false;
-        }
     }
 
     return cerResult;
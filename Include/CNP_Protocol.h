@@ -155,6 +155,12 @@ constexpr DWORD g_dwValidationKey = 0x00DEAD01;
  */
 constexpr size_t MAX_NAME_LEN     = 32;
 
+/// most transaction records a single TRANSACTION_QUERY_RESPONSE frame carries
+/**
+ *  @sa TRANSACTION_QUERY_RESPONSE
+ */
+constexpr WORD   MAX_TRANSACTIONS_PER_RESPONSE = 150;
+
  /// Used for error checking & default initialization
 constexpr WORD   INVALID_CLIENT_ID = static_cast<WORD>(~0);
  /// Used for error checking & default initialization
@@ -1812,6 +1818,12 @@ struct TRANSACTION_QUERY_REQUEST
  *  |  m_Response      | m_wTransactionCount | 20         | 21       |
  *  |  m_Response      | m_rgTransactions[]  | 22         | ...      |
  *
+ *  A frame carries at most MAX_TRANSACTIONS_PER_RESPONSE records; a query
+ *  for more is answered by a stream of frames, each with the request's
+ *  m_dwSequence & m_dwContext, in transaction ID order.  Every frame of the
+ *  stream but the last is full; the stream ends with a frame of fewer
+ *  records, possibly none, or once the requested count has been sent.
+ *
  *  @sa cnp::TRANSACTION_QUERY_REQUEST
  *  @sa cnp::TRANSACTION
  *  @ingroup SvrMsgs
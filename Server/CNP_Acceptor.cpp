@@ -0,0 +1,221 @@
+/**
+ * @file   CNP_Acceptor.cpp
+ * @brief  CNP_Acceptor class implementation
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#ifdef __linux__
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
+
+#include <chrono>
+#include <thread>
+#include <iostream>
+
+#include "CNP_Reactor.h"
+#include "CNP_Server.h"
+#include "CNP_Logger.h"
+#include "CNP_Acceptor.h"
+
+/**
+    A listener thread & the listening socket it accepts on
+ */
+struct CNP_Acceptor::LISTENER
+{
+    CNP_Socket*   m_pSocket;  ///< owned by CNP_Acceptor::m_vecSockets
+#ifdef __linux__
+    int           m_hEpoll;   ///< epoll instance waiting on m_pSocket
+    int           m_hWakeup;  ///< eventfd used to interrupt epoll_wait
+#endif
+    std::thread*  m_pThread;
+
+    explicit LISTENER(CNP_Socket* pSocket) noexcept
+        : m_pSocket(pSocket),
+#ifdef __linux__
+          m_hEpoll (-1),
+          m_hWakeup(-1),
+#endif
+          m_pThread(nullptr)
+    { };
+};
+
+
+CNP_Acceptor::CNP_Acceptor(CNP_Reactor& Reactor) noexcept
+    : m_Reactor(Reactor),
+      m_vecSockets(),
+      m_vecListeners(),
+      m_bTerminate(false)
+{ };
+
+CNP_Acceptor::~CNP_Acceptor()
+{
+    Stop();
+};
+
+bool CNP_Acceptor::Start(unsigned short wPort, int iBackLog, size_t nListeners, bool bReusePort)
+{
+#ifdef __linux__
+    if (bReusePort == false && nListeners > 1)
+    {
+        std::cerr << "multiple listeners require --reuseport, using one" << std::endl;
+        nListeners = 1;
+    }
+#else
+    // SO_REUSEPORT sharding is not available
+    bReusePort = false;
+    if (nListeners > 1)
+    {
+        std::cerr << "multiple listeners are not supported, using one" << std::endl;
+        nListeners = 1;
+    }
+#endif
+
+    for (size_t i = 0; i < nListeners; i++)
+    {
+        CNP_Socket* pSocket = new CNP_Socket();
+        m_vecSockets.push_back(pSocket);
+
+        if (pSocket->Create(wPort, bReusePort) == false)
+            return false;
+
+        if (pSocket->Listen(iBackLog) == false)
+        {
+            std::cerr << "failed to listen on Port:" << wPort << " Error:" << pSocket->GetError() << std::endl;
+            return false;
+        }
+
+        LISTENER* pListener = new LISTENER(pSocket);
+        m_vecListeners.push_back(pListener);
+
+#ifdef __linux__
+        // the accept loop drains the queue until it would block
+        pSocket->SetBlocking(false);
+
+        pListener->m_hEpoll  = ::epoll_create1(EPOLL_CLOEXEC);
+        pListener->m_hWakeup = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+        if (pListener->m_hEpoll == -1 || pListener->m_hWakeup == -1)
+        {
+            std::cerr << "failed to create listener, Error:" << errno << std::endl;
+            return false;
+        }
+
+        epoll_event ev = { 0 };
+        ev.events   = EPOLLIN;
+        ev.data.ptr = pSocket;
+        ::epoll_ctl(pListener->m_hEpoll, EPOLL_CTL_ADD, pSocket->get_Handle(), &ev);
+
+        // a null data pointer identifies the wakeup descriptor
+        ev.data.ptr = nullptr;
+        ::epoll_ctl(pListener->m_hEpoll, EPOLL_CTL_ADD, pListener->m_hWakeup, &ev);
+#endif
+
+        pListener->m_pThread = new std::thread(&CNP_Acceptor::Run, this, pListener);
+    }
+
+    std::cout << "Listening for connections on Port:" << wPort
+              << " with " << nListeners << " listener(s), BackLog:" << iBackLog << std::endl;
+
+    return true;
+};
+
+void CNP_Acceptor::Stop(void) noexcept
+{
+    m_bTerminate = true;
+
+    for (auto& pListener : m_vecListeners)
+    {
+#ifdef __linux__
+        if (pListener->m_hWakeup != -1)
+        {
+            uint64_t qwSignal = 1;
+            if (::write(pListener->m_hWakeup, &qwSignal, sizeof(qwSignal)) < 0)
+                std::cerr << "failed to signal listener, Error:" << errno << std::endl;
+        }
+#elif _MSC_VER
+        // closing the socket fails any blocked accept
+        pListener->m_pSocket->Close();
+#endif
+        if (pListener->m_pThread)
+        {
+            pListener->m_pThread->join();
+            delete pListener->m_pThread;
+        }
+
+#ifdef __linux__
+        if (pListener->m_hWakeup != -1)
+            ::close(pListener->m_hWakeup);
+        if (pListener->m_hEpoll != -1)
+            ::close(pListener->m_hEpoll);
+#endif
+        delete pListener;
+    }
+    m_vecListeners.clear();
+
+    for (auto& pSocket : m_vecSockets)
+    {
+        pSocket->Close();
+        delete pSocket;
+    }
+    m_vecSockets.clear();
+};
+
+void CNP_Acceptor::Run(LISTENER* pListener)
+{
+    std::cout << "Listener ThreadID:" << GetThreadID() << std::endl;
+
+    CNP_Socket* pSocket    = pListener->m_pSocket;
+    SOCKET      hNewSocket = INVALID_SOCKET;
+    sockaddr_in remoteAddr;
+
+    while (m_bTerminate == false)
+    {
+#ifdef __linux__
+        epoll_event rgEvents[2];
+
+        // sleep until a connection is pending or Stop() is called
+        int nEvents = ::epoll_wait(pListener->m_hEpoll, rgEvents, COUNTOF(rgEvents), -1);
+        if (nEvents == -1)
+        {
+            if (errno == EINTR)
+                continue;
+
+            std::cerr << "epoll_wait failed, Error:" << errno << std::endl;
+            break;
+        }
+
+        if (m_bTerminate)
+            break;
+#endif
+
+        // accept everything that is pending in one pass
+        while (pSocket->Accept(hNewSocket, remoteAddr))
+        {
+            CNP_LOG_INFO("Accepting a new connection");
+
+            m_Reactor.Attach(hNewSocket, remoteAddr);
+        }
+
+        if (pSocket->WouldBlock() || pSocket->Interrupted() || m_bTerminate)
+            continue;
+
+#ifdef __linux__
+        if (pSocket->GetError() == ECONNABORTED)
+            continue;
+#endif
+
+        std::cerr << "failed to accept new connection, Error:" << pSocket->GetError() << std::endl;
+
+        // typically out of descriptors, back off rather than spin on a
+        // connection that is still pending
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    std::cout << "Exiting ThreadID:" << GetThreadID() << std::endl;
+};
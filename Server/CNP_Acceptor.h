@@ -0,0 +1,77 @@
+/**
+ * @file   CNP_Acceptor.h
+ * @brief  CNP_Acceptor class interface
+ *
+ * CNP_Acceptor runs one or more listener threads that block until
+ * connections are pending, accept them in batches & hand them to the
+ * CNP_Reactor.  With SO_REUSEPORT each listener owns its own socket
+ * and the kernel shards incoming connections between them, otherwise
+ * the listeners share a single socket.
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#if !defined(__CNP_ACCEPTOR_H__)
+#define __CNP_ACCEPTOR_H__
+
+#ifndef __CNP_SOCKET_H__
+    #include "CNP_Socket.h"
+#endif
+
+#ifndef _ATOMIC_
+    #include <atomic>
+#endif
+
+#ifndef _VECTOR_
+    #include <vector>
+#endif
+
+class CNP_Reactor;
+
+class CNP_Acceptor
+{
+    struct LISTENER;  ///< defined in the implementation
+
+    CNP_Reactor&              m_Reactor;
+    std::vector<CNP_Socket*>  m_vecSockets;
+    std::vector<LISTENER*>    m_vecListeners;
+    std::atomic<bool>         m_bTerminate;
+
+public:
+/**
+    @brief Initialization Constructor
+
+    @param [in] Reactor   reactor that accepted connections are handed to
+*/
+    explicit CNP_Acceptor(CNP_Reactor& Reactor) noexcept;
+
+    ~CNP_Acceptor();
+
+/**
+    @brief Creates the listening socket(s) & starts the listener threads
+
+    @param [in] wPort        port to listen on
+    @param [in] iBackLog     length of each socket's pending connection queue
+    @param [in] nListeners   number of listener threads
+    @param [in] bReusePort   give each listener its own SO_REUSEPORT socket
+
+    @retval true  on success
+    @retval false on failure
+ */
+    bool Start(unsigned short wPort, int iBackLog, size_t nListeners, bool bReusePort);
+
+/**
+    @brief Stops the listener threads & closes the listening socket(s)
+ */
+    void Stop (void) noexcept;
+
+private:
+    void Run  (LISTENER* pListener);
+
+    CNP_Acceptor(const CNP_Acceptor&);
+    CNP_Acceptor& operator=(const CNP_Acceptor&);
+};
+
+#endif
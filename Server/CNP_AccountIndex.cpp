@@ -0,0 +1,156 @@
+/**
+ * @file   CNP_AccountIndex.cpp
+ * @brief  CNP_AccountIndex class implementation
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+    #include <emmintrin.h>
+    #define CNP_ACCOUNT_INDEX_SSE2
+#endif
+
+#include "CNP_AccountIndex.h"
+
+/// control byte of an empty slot, a full slot's being the 7 bit hash
+static const signed char CTRL_EMPTY = static_cast<signed char>(0x80);
+
+
+CNP_AccountIndex::CNP_AccountIndex(void) noexcept
+    : m_vecCtrl(),
+      m_vecSlots(),
+      m_nGroupMask(0),
+      m_nSize(0)
+{ };
+
+unsigned CNP_AccountIndex::MatchGroup(const signed char* pGroup, signed char chCtrl) noexcept
+{
+#ifdef CNP_ACCOUNT_INDEX_SSE2
+    __m128i xmmGroup = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pGroup));
+    return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(xmmGroup, _mm_set1_epi8(chCtrl))));
+#else
+    unsigned uResult = 0;
+
+    for (size_t i = 0; i < GROUP_SIZE; i++)
+    {
+        if (pGroup[i] == chCtrl)
+            uResult |= 1U << i;
+    }
+
+    return uResult;
+#endif
+};
+
+/// @retval index of the lowest set bit of a non-zero mask
+static inline unsigned LowestBit(unsigned uMask) noexcept
+{
+    unsigned uResult = 0;
+
+    while ((uMask & 1U) == 0)
+    {
+        uMask >>= 1;
+        uResult++;
+    }
+
+    return uResult;
+};
+
+cnp::DWORD CNP_AccountIndex::Find(const cnp::QWORD& qwKey) const noexcept
+{
+    if (m_nSize == 0)
+        return INVALID_HANDLE;
+
+    cnp::QWORD  qwHash = Hash(qwKey);
+    signed char chHash = static_cast<signed char>(qwHash & 0x7F);
+    size_t      nGroup = static_cast<size_t>(qwHash >> 7) & m_nGroupMask;
+
+    // triangular probing visits every group of a power of two table
+    for (size_t nStep = 1; ; nStep++)
+    {
+        const signed char* pGroup = &m_vecCtrl[nGroup * GROUP_SIZE];
+
+        for (unsigned uMatch = MatchGroup(pGroup, chHash); uMatch != 0; uMatch &= uMatch - 1)
+        {
+            const SLOT& Slot = m_vecSlots[nGroup * GROUP_SIZE + LowestBit(uMatch)];
+
+            if (Slot.m_qwKey == qwKey)
+                return Slot.m_dwHandle;
+        }
+
+        // a key is placed in the first group with room, so an empty slot ends the search
+        if (MatchGroup(pGroup, CTRL_EMPTY) != 0 || nStep > m_nGroupMask)
+            return INVALID_HANDLE;
+
+        nGroup = (nGroup + nStep) & m_nGroupMask;
+    }
+};
+
+bool CNP_AccountIndex::Insert(const cnp::QWORD& qwKey, cnp::DWORD dwHandle)
+{
+    if (Find(qwKey) != INVALID_HANDLE)
+        return false;
+
+    Reserve(m_nSize + 1);
+    Place(qwKey, dwHandle);
+    return true;
+};
+
+void CNP_AccountIndex::Reserve(size_t nCount)
+{
+    size_t nGroups = m_vecCtrl.size() / GROUP_SIZE;
+
+    // kept at most 7/8 full, so that probe sequences stay short
+    if (nCount * 8 <= nGroups * GROUP_SIZE * 7)
+        return;
+
+    if (nGroups == 0)
+        nGroups = 1;
+
+    while (nCount * 8 > nGroups * GROUP_SIZE * 7)
+        nGroups *= 2;
+
+    Rehash(nGroups);
+};
+
+void CNP_AccountIndex::Rehash(size_t nGroups)
+{
+    std::vector<signed char> vecCtrl(nGroups * GROUP_SIZE, CTRL_EMPTY);
+    std::vector<SLOT>        vecSlots(nGroups * GROUP_SIZE);
+
+    vecCtrl.swap(m_vecCtrl);
+    vecSlots.swap(m_vecSlots);
+    m_nGroupMask = nGroups - 1;
+    m_nSize      = 0;
+
+    for (size_t i = 0; i < vecCtrl.size(); i++)
+    {
+        if (vecCtrl[i] != CTRL_EMPTY)
+            Place(vecSlots[i].m_qwKey, vecSlots[i].m_dwHandle);
+    }
+};
+
+void CNP_AccountIndex::Place(const cnp::QWORD& qwKey, cnp::DWORD dwHandle) noexcept
+{
+    cnp::QWORD qwHash = Hash(qwKey);
+    size_t     nGroup = static_cast<size_t>(qwHash >> 7) & m_nGroupMask;
+
+    for (size_t nStep = 1; ; nStep++)
+    {
+        unsigned uEmpty = MatchGroup(&m_vecCtrl[nGroup * GROUP_SIZE], CTRL_EMPTY);
+
+        if (uEmpty != 0)
+        {
+            size_t nSlot = nGroup * GROUP_SIZE + LowestBit(uEmpty);
+
+            m_vecCtrl[nSlot]             = static_cast<signed char>(qwHash & 0x7F);
+            m_vecSlots[nSlot].m_qwKey    = qwKey;
+            m_vecSlots[nSlot].m_dwHandle = dwHandle;
+            m_nSize++;
+            return;
+        }
+
+        nGroup = (nGroup + nStep) & m_nGroupMask;
+    }
+};
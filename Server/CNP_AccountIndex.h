@@ -0,0 +1,99 @@
+/**
+ * @file   CNP_AccountIndex.h
+ * @brief  CNP_AccountIndex class interface
+ *
+ * CNP_AccountIndex is an open addressing hash table mapping a customer
+ * ID to the handle of its account, the account's index in an array kept
+ * by the caller.  It is laid out as a Swiss table: the slots are probed
+ * a group of GROUP_SIZE at a time, each slot having a control byte that
+ * is either empty or holds 7 bits of the key's hash.  A group's control
+ * bytes are compared against the hash with a single SSE2 instruction,
+ * & only the slots whose byte matches have their keys compared, so a
+ * lookup normally touches one control group & one slot.
+ *
+ * Accounts are never deleted, so the table needs no tombstones.  It
+ * doubles in size once 7/8 full.
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#if !defined(__CNP_ACCOUNT_INDEX_H__)
+#define __CNP_ACCOUNT_INDEX_H__
+
+#ifndef __CNP_COMMON_H__
+    #include "CNP_Common.h"
+#endif
+
+#ifndef _VECTOR_
+    #include <vector>
+#endif
+
+class CNP_AccountIndex
+{
+public:
+    static const size_t     GROUP_SIZE     = 16;
+    static const cnp::DWORD INVALID_HANDLE = static_cast<cnp::DWORD>(~0U);
+
+private:
+    struct SLOT
+    {
+        cnp::QWORD  m_qwKey;
+        cnp::DWORD  m_dwHandle;
+    };
+
+    std::vector<signed char>  m_vecCtrl;     ///< a control byte per slot
+    std::vector<SLOT>         m_vecSlots;
+    size_t                    m_nGroupMask;  ///< number of groups less one
+    size_t                    m_nSize;
+
+public:
+    /// Default Constructor
+    CNP_AccountIndex(void) noexcept;
+
+/**
+    @brief Looks up the handle of a customer ID
+
+    @retval cnp::DWORD containing the handle
+    @retval INVALID_HANDLE if the customer ID is not held
+ */
+    cnp::DWORD  Find   (const cnp::QWORD& qwKey) const noexcept;
+
+/**
+    @brief Adds a customer ID & its handle
+
+    @retval true  on success
+    @retval false if the customer ID is already held
+ */
+    bool        Insert (const cnp::QWORD& qwKey, cnp::DWORD dwHandle);
+
+/**
+    @brief Grows the table to hold a number of keys without growing again
+ */
+    void        Reserve(size_t nCount);
+
+    inline size_t  Size(void) const noexcept
+    { return m_nSize; };
+
+private:
+    /// the customer ID is already a hash, but of a name & PIN in separate bits, so it is mixed
+    static inline cnp::QWORD  Hash(const cnp::QWORD& qwKey) noexcept
+    {
+        cnp::QWORD qwHash = (qwKey ^ (qwKey >> 31)) * 0xBF58476D1CE4E5B9ULL;
+        return qwHash ^ (qwHash >> 29);
+    };
+
+    /// @retval bit i set for each control byte i of a group equal to chCtrl
+    static unsigned MatchGroup(const signed char* pGroup, signed char chCtrl) noexcept;
+
+    void        Rehash (size_t nGroups);
+
+    /// places a key known not to be held, the table having room for it
+    void        Place  (const cnp::QWORD& qwKey, cnp::DWORD dwHandle) noexcept;
+
+    CNP_AccountIndex(const CNP_AccountIndex&);
+    CNP_AccountIndex& operator=(const CNP_AccountIndex&);
+};
+
+#endif
@@ -0,0 +1,193 @@
+/**
+ * @file   CNP_AccountStore.cpp
+ * @brief  CNP_AccountStore class implementation
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "CNP_AccountStore.h"
+#include "CNP_TransactionLedger.h"
+
+
+bool CNP_AccountStore::Insert(const ACCOUNT_INFO& Account)
+{
+    SHARD& Shard = get_Shard(Account.get_CustomerID());
+
+    std::lock_guard<std::shared_mutex> ShardLock(Shard.m_Mutex);
+
+    return Shard.Insert(Account);
+};
+
+size_t CNP_AccountStore::BulkInsert(const ACCOUNT_INFO* pRecords, size_t nCount)
+{
+    // below this, starting threads costs more than it saves
+    const size_t MIN_RECORDS_PER_THREAD = 64 * 1024;
+
+    size_t nThreads = std::thread::hardware_concurrency();
+    if (nThreads > nCount / MIN_RECORDS_PER_THREAD)
+        nThreads = nCount / MIN_RECORDS_PER_THREAD;
+    if (nThreads > SHARD_COUNT)
+        nThreads = SHARD_COUNT;
+    if (nThreads == 0)
+        nThreads = 1;
+
+    std::vector<size_t> vecAdded(nThreads, 0);
+
+    // each thread scans every record but only inserts those of the shards
+    // it owns, so no two threads ever touch the same shard
+    auto fnInsert = [&](size_t nThread)
+    {
+        // the hash spreads the block evenly, give or take an eighth
+        size_t nExpected = nCount / SHARD_COUNT + nCount / (SHARD_COUNT * 8) + 1;
+
+        for (size_t i = nThread; i < SHARD_COUNT; i += nThreads)
+        {
+            SHARD& Shard = m_rgShards[i];
+
+            Shard.m_Mutex.lock();
+            Shard.m_vecAccounts.reserve(Shard.m_vecAccounts.size() + nExpected);
+            Shard.m_Index.Reserve(Shard.m_Index.Size() + nExpected);
+        }
+
+        size_t nAdded = 0;
+        for (size_t i = 0; i < nCount; i++)
+        {
+            const ACCOUNT_INFO& Account = pRecords[i];
+            size_t              nShard  = get_ShardIndex(Account.get_CustomerID());
+
+            if (nShard % nThreads != nThread)
+                continue;
+
+            if (m_rgShards[nShard].Insert(Account))
+                nAdded++;
+        }
+
+        for (size_t i = nThread; i < SHARD_COUNT; i += nThreads)
+            m_rgShards[i].m_Mutex.unlock();
+
+        vecAdded[nThread] = nAdded;
+    };
+
+    std::vector<std::thread> vecThreads;
+    for (size_t i = 1; i < nThreads; i++)
+        vecThreads.emplace_back(fnInsert, i);
+
+    fnInsert(0);
+
+    size_t nResult = vecAdded[0];
+    for (size_t i = 1; i < nThreads; i++)
+    {
+        vecThreads[i - 1].join();
+        nResult += vecAdded[i];
+    }
+
+    return nResult;
+};
+
+bool CNP_AccountStore::Exists(const cnp::QWORD& qwCustomerID) const
+{
+    const SHARD& Shard = get_Shard(qwCustomerID);
+
+    std::shared_lock<std::shared_mutex> ShardLock(Shard.m_Mutex);
+
+    return Shard.Find(qwCustomerID) != nullptr;
+};
+
+bool CNP_AccountStore::Find(const cnp::QWORD& qwCustomerID, ACCOUNT_HANDLE& hAccount) const
+{
+    size_t       nShard = get_ShardIndex(qwCustomerID);
+    const SHARD& Shard  = m_rgShards[nShard];
+
+    std::shared_lock<std::shared_mutex> ShardLock(Shard.m_Mutex);
+
+    cnp::DWORD dwSlot = Shard.m_Index.Find(qwCustomerID);
+    if (dwSlot == CNP_AccountIndex::INVALID_HANDLE)
+        return false;
+
+    hAccount.m_dwShard = static_cast<cnp::DWORD>(nShard);
+    hAccount.m_dwSlot  = dwSlot;
+    return true;
+};
+
+bool CNP_AccountStore::GetBalance(const ACCOUNT_HANDLE& hAccount, cnp::DWORD& dwBalance) const
+{
+    const SHARD& Shard = get_Shard(hAccount);
+
+    std::shared_lock<std::shared_mutex> ShardLock(Shard.m_Mutex);
+
+    const ACCOUNT_INFO* pAccount = Shard.At(hAccount.m_dwSlot);
+    if (pAccount == nullptr)
+        return false;
+
+    dwBalance = pAccount->get_Balance();
+    return true;
+};
+
+size_t CNP_AccountStore::RebuildBalances(const CNP_TransactionLedger& Ledger,
+                                         const CustomerBalanceMap_t& mapSealed)
+{
+    size_t nResult = 0;
+
+    LockAll();
+
+    // every account is opened with a zero balance, to which its sealed
+    // transactions add up
+    for (auto& Shard : m_rgShards)
+    {
+        for (auto& Account : Shard.m_vecAccounts)
+        {
+            auto itS = mapSealed.find(Account.get_CustomerID());
+            Account.set_Balance((itS == mapSealed.end()) ? 0 : static_cast<cnp::DWORD>(itS->second));
+        }
+    }
+
+    Ledger.ForEach([this, &nResult](const TRANSACTION_INFO& Transaction)
+    {
+        ACCOUNT_INFO* pAccount = get_Shard(Transaction.get_CustomerID()).Find(Transaction.get_CustomerID());
+        if (pAccount == nullptr)
+        {
+            nResult++;
+            return;
+        }
+
+        if (Transaction.get_Type() == cnp::TT_DEPOSIT)
+            pAccount->incr_Balance(Transaction.get_Amount());
+        else
+            pAccount->decr_Balance(Transaction.get_Amount());
+    });
+
+    UnlockAll();
+
+    return nResult;
+};
+
+void CNP_AccountStore::LockAll(void)
+{
+    for (auto& Shard : m_rgShards)
+        Shard.m_Mutex.lock();
+};
+
+void CNP_AccountStore::UnlockAll(void)
+{
+    for (auto& Shard : m_rgShards)
+        Shard.m_Mutex.unlock();
+};
+
+size_t CNP_AccountStore::Size(void) const
+{
+    size_t nResult = 0;
+
+    for (const auto& Shard : m_rgShards)
+    {
+        std::shared_lock<std::shared_mutex> ShardLock(Shard.m_Mutex);
+        nResult += Shard.m_vecAccounts.size();
+    }
+
+    return nResult;
+};
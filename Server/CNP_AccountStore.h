@@ -0,0 +1,348 @@
+/**
+ * @file   CNP_AccountStore.h
+ * @brief  CNP_AccountStore class interface
+ *
+ * CNP_AccountStore holds the ACCOUNT_INFO table split into a fixed
+ * number of shards keyed by customer ID, each shard guarded by its own
+ * reader-writer lock.  A shard keeps its accounts in an array, in the
+ * order they were added, & finds them through a CNP_AccountIndex hash
+ * table of their positions in the array.  A logged on session holds
+ * its account's ACCOUNT_HANDLE, its shard & position, & reaches the
+ * account without the hash lookup.
+ *
+ * Lookups & balance queries take a shared lock, account creation &
+ * balance changes an exclusive one, and only ever on the single shard
+ * the account lives in, so requests against different accounts rarely
+ * contend.
+ *
+ * Balance checks & updates are made under the same lock, a withdrawal
+ * can therefore never overdraw an account however the requests for it
+ * interleave.  The change is recorded under that lock too, & only made
+ * once recorded, so a checkpoint, which takes every shard's lock, never
+ * holds a change the log lost, nor misses one it kept.
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#if !defined(__CNP_ACCOUNT_STORE_H__)
+#define __CNP_ACCOUNT_STORE_H__
+
+#ifndef __CNP_SERVER_DB_H__
+    #include "CNP_ServerDB.h"
+#endif
+
+#ifndef __CNP_ACCOUNT_INDEX_H__
+    #include "CNP_AccountIndex.h"
+#endif
+
+#ifndef _MUTEX_
+    #include <mutex>
+#endif
+
+#ifndef _SHARED_MUTEX_
+    #include <shared_mutex>
+#endif
+
+#ifndef _VECTOR_
+    #include <vector>
+#endif
+
+class CNP_AccountStore
+{
+public:
+    static const unsigned SHARD_BITS  = 6;
+    static const size_t   SHARD_COUNT = size_t(1) << SHARD_BITS;  ///< 64 shards
+
+private:
+    /// kept a cache line apart, so that locking one shard does not slow its neighbours
+    struct alignas(64) SHARD
+    {
+        mutable std::shared_mutex  m_Mutex;
+        std::vector<ACCOUNT_INFO>  m_vecAccounts;   ///< guarded by m_Mutex
+        CNP_AccountIndex           m_Index;         ///< guarded by m_Mutex, positions in m_vecAccounts
+
+        ACCOUNT_INFO*       Find  (const cnp::QWORD& qwCustomerID) noexcept
+        {
+            cnp::DWORD dwHandle = m_Index.Find(qwCustomerID);
+            return (dwHandle == CNP_AccountIndex::INVALID_HANDLE) ? nullptr : &m_vecAccounts[dwHandle];
+        };
+
+        const ACCOUNT_INFO* Find  (const cnp::QWORD& qwCustomerID) const noexcept
+        {
+            cnp::DWORD dwHandle = m_Index.Find(qwCustomerID);
+            return (dwHandle == CNP_AccountIndex::INVALID_HANDLE) ? nullptr : &m_vecAccounts[dwHandle];
+        };
+
+        /// @retval the account at a position, nullptr if there is none
+        ACCOUNT_INFO*       At    (cnp::DWORD dwSlot) noexcept
+        { return (dwSlot < m_vecAccounts.size()) ? &m_vecAccounts[dwSlot] : nullptr; };
+
+        const ACCOUNT_INFO* At    (cnp::DWORD dwSlot) const noexcept
+        { return (dwSlot < m_vecAccounts.size()) ? &m_vecAccounts[dwSlot] : nullptr; };
+
+        /// @retval false if the customer ID is already held
+        bool                Insert(const ACCOUNT_INFO& Account)
+        {
+            if (m_Index.Insert(Account.get_CustomerID(), static_cast<cnp::DWORD>(m_vecAccounts.size())) == false)
+                return false;
+
+            m_vecAccounts.push_back(Account);
+            return true;
+        };
+    };
+
+    SHARD  m_rgShards[SHARD_COUNT];
+
+public:
+    /// Default Constructor
+    CNP_AccountStore(void) noexcept
+        : m_rgShards()
+    { };
+
+/**
+    @brief Adds a new account
+
+    @param [in] Account   account to add, keyed by its customer ID
+
+    @retval true  on success
+    @retval false if an account with the same customer ID already exists
+ */
+    bool          Insert    (const ACCOUNT_INFO& Account);
+
+/**
+    @brief Adds a new account, once fnRecord() has recorded it
+
+    fnRecord() is called under the shard's lock, so that no checkpoint
+    falls between the account being recorded & being added.
+
+    @param [in] Account    account to add, keyed by its customer ID
+    @param [in] fnRecord   cnp::CER_TYPE fnRecord(void), the account only
+                           being added if it succeeds
+
+    @retval cnp::CER_SUCCESS         on success
+    @retval cnp::CER_ACCOUNT_EXISTS  if an account with the same customer ID already exists
+    @retval cnp::CER_TYPE            containing fnRecord()'s failure
+ */
+    template <class _Fn>
+    cnp::CER_TYPE Insert    (const ACCOUNT_INFO& Account, _Fn fnRecord)
+    {
+        SHARD& Shard = get_Shard(Account.get_CustomerID());
+
+        std::lock_guard<std::shared_mutex> ShardLock(Shard.m_Mutex);
+
+        if (Shard.Find(Account.get_CustomerID()) != nullptr)
+            return cnp::CER_ACCOUNT_EXISTS;
+
+        cnp::CER_TYPE cerRR = fnRecord();
+        if (cnp::Succeeded(cerRR))
+            Shard.Insert(Account);
+
+        return cerRR;
+    };
+
+/**
+    @brief Adds a block of accounts, such as a loaded table, spreading
+           the shards over several threads
+
+    Each shard's array & index are grown once up front, rather than
+    repeatedly as the block is inserted.
+
+    @param [in] pRecords   address of the first account
+    @param [in] nCount     number of accounts
+
+    @retval size_t containing the number of accounts added, duplicates
+            being skipped
+ */
+    size_t        BulkInsert(const ACCOUNT_INFO* pRecords, size_t nCount);
+
+/**
+    @retval true if an account exists for the customer ID
+ */
+    bool          Exists    (const cnp::QWORD& qwCustomerID) const;
+
+/**
+    @brief Looks up an account's handle
+
+    @param [in]  qwCustomerID   customer ID of the account
+    @param [out] hAccount       receives the account's handle
+
+    @retval true  on success
+    @retval false if no such account exists
+ */
+    bool          Find      (const cnp::QWORD& qwCustomerID, ACCOUNT_HANDLE& hAccount) const;
+
+/**
+    @brief Retrieves an account's current balance
+
+    @param [in]  hAccount    handle of the account
+    @param [out] dwBalance   receives the balance
+
+    @retval true  on success
+    @retval false if the handle refers to no account
+ */
+    bool          GetBalance(const ACCOUNT_HANDLE& hAccount, cnp::DWORD& dwBalance) const;
+
+/**
+    @brief Adds an amount to an account's balance, once fnRecord() has
+           recorded the transaction
+
+    fnRecord() is called under the account's lock, so that no checkpoint
+    falls between the transaction being recorded & the balance changing.
+
+    @param [in] hAccount   handle of the account
+    @param [in] dwAmount   amount to add
+    @param [in] fnRecord   cnp::CER_TYPE fnRecord(void), the balance only
+                           being changed if it succeeds
+
+    @retval cnp::CER_SUCCESS            on success
+    @retval cnp::CER_ACCOUNT_NOT_FOUND  if the handle refers to no account
+    @retval cnp::CER_TYPE               containing fnRecord()'s failure
+ */
+    template <class _Fn>
+    cnp::CER_TYPE Deposit   (const ACCOUNT_HANDLE& hAccount, cnp::DWORD dwAmount, _Fn fnRecord)
+    {
+        SHARD& Shard = get_Shard(hAccount);
+
+        std::lock_guard<std::shared_mutex> ShardLock(Shard.m_Mutex);
+
+        ACCOUNT_INFO* pAccount = Shard.At(hAccount.m_dwSlot);
+        if (pAccount == nullptr)
+            return cnp::CER_ACCOUNT_NOT_FOUND;
+
+        cnp::CER_TYPE cerRR = fnRecord();
+        if (cnp::Succeeded(cerRR))
+            pAccount->incr_Balance(dwAmount);
+
+        return cerRR;
+    };
+
+/**
+    @brief Subtracts an amount from an account's balance, provided it
+           does not exceed the balance, once fnRecord() has recorded the
+           transaction
+
+    fnRecord() is called under the account's lock, after the balance has
+    been checked, so that no checkpoint falls between the transaction
+    being recorded & the balance changing.
+
+    @param [in] hAccount   handle of the account
+    @param [in] dwAmount   amount to subtract
+    @param [in] fnRecord   cnp::CER_TYPE fnRecord(void), the balance only
+                           being changed if it succeeds
+
+    @retval cnp::CER_SUCCESS             on success
+    @retval cnp::CER_ACCOUNT_NOT_FOUND   if the handle refers to no account
+    @retval cnp::CER_INSUFFICIENT_FUNDS  if the amount exceeds the balance
+    @retval cnp::CER_TYPE                containing fnRecord()'s failure
+ */
+    template <class _Fn>
+    cnp::CER_TYPE Withdraw  (const ACCOUNT_HANDLE& hAccount, cnp::DWORD dwAmount, _Fn fnRecord)
+    {
+        SHARD& Shard = get_Shard(hAccount);
+
+        std::lock_guard<std::shared_mutex> ShardLock(Shard.m_Mutex);
+
+        ACCOUNT_INFO* pAccount = Shard.At(hAccount.m_dwSlot);
+        if (pAccount == nullptr)
+            return cnp::CER_ACCOUNT_NOT_FOUND;
+
+        if (dwAmount > pAccount->get_Balance())
+            return cnp::CER_INSUFFICIENT_FUNDS;
+
+        cnp::CER_TYPE cerRR = fnRecord();
+        if (cnp::Succeeded(cerRR))
+            pAccount->decr_Balance(dwAmount);
+
+        return cerRR;
+    };
+
+/**
+    @brief Recomputes every account's balance from its transactions
+
+    Used after replaying the write-ahead log, as a checkpoint's saved
+    balances may already include transactions it did not save, or not yet
+    include ones it did.
+
+    @param [in] Ledger      every in-memory transaction
+    @param [in] mapSealed   net amount of each customer's sealed transactions
+
+    @retval size_t containing the number of transactions whose account does not exist
+ */
+    size_t        RebuildBalances(const CNP_TransactionLedger& Ledger,
+                                  const CustomerBalanceMap_t& mapSealed);
+
+/**
+    @brief Takes every shard's exclusive lock, in order, freezing the store
+           for a point-in-time snapshot
+ */
+    void          LockAll   (void);
+
+/**
+    @brief Releases the locks taken by LockAll()
+ */
+    void          UnlockAll (void);
+
+/**
+    @retval size_t containing the number of accounts, only a snapshot
+            while the store is in use
+ */
+    size_t        Size      (void) const;
+
+/**
+    @brief Invokes fnVisit(const ACCOUNT_INFO&) for every account
+
+    Each shard is visited under its shared lock, in turn.
+ */
+    template <class _Fn>
+    void          ForEach   (_Fn fnVisit) const
+    {
+        for (const auto& Shard : m_rgShards)
+        {
+            std::shared_lock<std::shared_mutex> ShardLock(Shard.m_Mutex);
+            for (const auto& Account : Shard.m_vecAccounts)
+                fnVisit(Account);
+        }
+    };
+
+/**
+    @brief Invokes fnVisit(const ACCOUNT_INFO&) for every account, without
+           locking
+
+    Only safe while the caller holds LockAll(), or in a process forked
+    while it was held.
+ */
+    template <class _Fn>
+    void          ForEachLocked(_Fn fnVisit) const
+    {
+        for (const auto& Shard : m_rgShards)
+        {
+            for (const auto& Account : Shard.m_vecAccounts)
+                fnVisit(Account);
+        }
+    };
+
+private:
+    /// Fibonacci hashing, spreads the customer ID's high bits over the shards
+    static inline size_t get_ShardIndex(const cnp::QWORD& qwCustomerID) noexcept
+    { return static_cast<size_t>((qwCustomerID * 0x9E3779B97F4A7C15ULL) >> (64 - SHARD_BITS)); };
+
+    inline SHARD&       get_Shard(const cnp::QWORD& qwCustomerID) noexcept
+    { return m_rgShards[get_ShardIndex(qwCustomerID)]; };
+
+    inline const SHARD& get_Shard(const cnp::QWORD& qwCustomerID) const noexcept
+    { return m_rgShards[get_ShardIndex(qwCustomerID)]; };
+
+    /// the shard of a handle, SHARD::At() then rejecting the slot of an invalid one
+    inline SHARD&       get_Shard(const ACCOUNT_HANDLE& hAccount) noexcept
+    { return m_rgShards[hAccount.m_dwShard & (SHARD_COUNT - 1)]; };
+
+    inline const SHARD& get_Shard(const ACCOUNT_HANDLE& hAccount) const noexcept
+    { return m_rgShards[hAccount.m_dwShard & (SHARD_COUNT - 1)]; };
+
+    CNP_AccountStore(const CNP_AccountStore&);
+    CNP_AccountStore& operator=(const CNP_AccountStore&);
+};
+
+#endif
@@ -0,0 +1,113 @@
+/**
+ * @file   CNP_AdminEndpoint.cpp
+ * @brief  CNP_AdminEndpoint class implementation
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#ifdef __linux__
+    #include <sys/socket.h>
+#endif
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "CNP_Metrics.h"
+#include "CNP_AdminEndpoint.h"
+
+
+CNP_AdminEndpoint::CNP_AdminEndpoint(void) noexcept
+    : m_Socket(),
+      m_pThread(nullptr),
+      m_bTerminate(false)
+{ };
+
+CNP_AdminEndpoint::~CNP_AdminEndpoint()
+{
+    Stop();
+};
+
+bool CNP_AdminEndpoint::Start(unsigned short wPort)
+{
+    if (m_pThread)
+        return false;
+
+    if (m_Socket.Create(wPort, false, true) == false || m_Socket.Listen(16) == false)
+    {
+        std::cerr << "failed to start admin endpoint on Port:" << wPort
+                  << " Error:" << m_Socket.GetError() << std::endl;
+        m_Socket.Close();
+        return false;
+    }
+
+    m_bTerminate = false;
+    m_pThread    = new std::thread(&CNP_AdminEndpoint::Run, this);
+
+    std::cout << "Admin endpoint listening on 127.0.0.1:" << wPort << std::endl;
+    return true;
+};
+
+void CNP_AdminEndpoint::Stop(void) noexcept
+{
+    if (m_pThread == nullptr)
+        return;
+
+    m_bTerminate = true;
+
+#ifdef __linux__
+    // fails the blocked accept
+    m_Socket.Shutdown(SHUT_RDWR);
+#elif _MSC_VER
+    m_Socket.Close();
+#endif
+
+    m_pThread->join();
+    delete m_pThread;
+    m_pThread = nullptr;
+
+    m_Socket.Close();
+};
+
+void CNP_AdminEndpoint::Run(void)
+{
+    SOCKET      hSocket = INVALID_SOCKET;
+    sockaddr_in remoteAddr;
+
+    while (m_bTerminate == false)
+    {
+        if (m_Socket.Accept(hSocket, remoteAddr) == false)
+        {
+            if (m_bTerminate || m_Socket.Interrupted())
+                continue;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            continue;
+        }
+
+        CNP_Socket Client(hSocket, remoteAddr);
+
+        // a client that stops reading only holds up the endpoint for a second
+        Client.SetBlocking(true);
+#ifdef __linux__
+        Client.SetSocketSendTimeout(1, 0);
+#elif _MSC_VER
+        Client.SetSocketSendTimeout(1000UL);
+#endif
+
+        std::string strReport;
+        g_Metrics.Report(strReport);
+
+        size_t cbSent = 0;
+        while (cbSent < strReport.size())
+        {
+            int iSent = Client.Send(strReport.data() + cbSent, strReport.size() - cbSent);
+            if (iSent <= 0)
+                break;
+
+            cbSent += static_cast<size_t>(iSent);
+        }
+    }
+};
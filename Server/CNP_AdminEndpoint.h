@@ -0,0 +1,64 @@
+/**
+ * @file   CNP_AdminEndpoint.h
+ * @brief  CNP_AdminEndpoint class interface
+ *
+ * CNP_AdminEndpoint listens on a loopback-only TCP port, for operators
+ * & monitoring agents on the server's host.  Each client connecting to
+ * it is sent a CNP_Metrics report, after which the connection is closed;
+ * anything the client sends is ignored.
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#if !defined(__CNP_ADMIN_ENDPOINT_H__)
+#define __CNP_ADMIN_ENDPOINT_H__
+
+#ifndef __CNP_SOCKET_H__
+    #include "CNP_Socket.h"
+#endif
+
+#ifndef _ATOMIC_
+    #include <atomic>
+#endif
+
+#ifndef _THREAD_
+    #include <thread>
+#endif
+
+class CNP_AdminEndpoint
+{
+    CNP_Socket         m_Socket;
+    std::thread*       m_pThread;
+    std::atomic<bool>  m_bTerminate;
+
+public:
+    /// Default Constructor
+    CNP_AdminEndpoint(void) noexcept;
+
+    ~CNP_AdminEndpoint();
+
+/**
+    @brief Starts listening on the loopback address
+
+    @param [in] wPort   local port to listen on
+
+    @retval true  on success
+    @retval false on failure
+ */
+    bool        Start(unsigned short wPort);
+
+/**
+    @brief Stops listening & waits for the endpoint's thread
+ */
+    void        Stop (void) noexcept;
+
+private:
+    void        Run  (void);
+
+    CNP_AdminEndpoint(const CNP_AdminEndpoint&);
+    CNP_AdminEndpoint& operator=(const CNP_AdminEndpoint&);
+};
+
+#endif
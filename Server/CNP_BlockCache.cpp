@@ -0,0 +1,173 @@
+/**
+ * @file   CNP_BlockCache.cpp
+ * @brief  CNP_BlockCache class implementation
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#ifdef __linux__
+    #include <unistd.h>
+#elif _MSC_VER
+    #include <io.h>
+#endif
+
+#include "CNP_BlockCache.h"
+
+
+CNP_BlockCache::CNP_BlockCache(size_t cbCapacity)
+    : m_Mutex(),
+      m_lstBlocks(),
+      m_mapBlocks(),
+      m_nMaxBlocks(1)
+{
+    set_Capacity(cbCapacity);
+};
+
+void CNP_BlockCache::set_Capacity(size_t cbCapacity)
+{
+    std::lock_guard<std::mutex> CacheLock(m_Mutex);
+
+    m_nMaxBlocks = (cbCapacity < BLOCK_SIZE) ? 1 : cbCapacity / BLOCK_SIZE;
+
+    while (m_lstBlocks.size() > m_nMaxBlocks)
+    {
+        m_mapBlocks.erase(m_lstBlocks.back().first);
+        m_lstBlocks.pop_back();
+    }
+};
+
+bool CNP_BlockCache::Read(int hFile, cnp::QWORD qwFileKey, cnp::QWORD qwOffset, void* pDest, size_t cbLen)
+{
+    char* pOut = static_cast<char*>(pDest);
+
+    while (cbLen > 0)
+    {
+        cnp::QWORD qwBlock  = qwOffset / BLOCK_SIZE;
+        size_t     cbOffset = static_cast<size_t>(qwOffset % BLOCK_SIZE);
+
+        block_type pBlock = GetBlock(hFile, qwFileKey, qwBlock);
+        if (!pBlock || pBlock->size() <= cbOffset)
+            return false;
+
+        size_t cbCopy = pBlock->size() - cbOffset;
+        if (cbCopy > cbLen)
+            cbCopy = cbLen;
+
+        memcpy(pOut, pBlock->data() + cbOffset, cbCopy);
+
+        pOut     += cbCopy;
+        qwOffset += cbCopy;
+        cbLen    -= cbCopy;
+    }
+
+    return true;
+};
+
+void CNP_BlockCache::Evict(cnp::QWORD qwFileKey)
+{
+    std::lock_guard<std::mutex> CacheLock(m_Mutex);
+
+    for (auto it = m_lstBlocks.begin(); it != m_lstBlocks.end(); )
+    {
+        if (it->first.m_qwFileKey == qwFileKey)
+        {
+            m_mapBlocks.erase(it->first);
+            it = m_lstBlocks.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+};
+
+CNP_BlockCache::block_type CNP_BlockCache::GetBlock(int hFile, cnp::QWORD qwFileKey, cnp::QWORD qwBlock)
+{
+    BLOCK_KEY Key = { qwFileKey, qwBlock };
+
+    {
+        std::lock_guard<std::mutex> CacheLock(m_Mutex);
+
+        auto itB = m_mapBlocks.find(Key);
+        if (itB != m_mapBlocks.end())
+        {
+            // move to the front of the LRU list
+            m_lstBlocks.splice(m_lstBlocks.begin(), m_lstBlocks, itB->second);
+            return itB->second->second;
+        }
+    }
+
+    block_type pBlock = LoadBlock(hFile, qwBlock);
+    if (!pBlock)
+        return pBlock;
+
+    std::lock_guard<std::mutex> CacheLock(m_Mutex);
+
+    // another reader may have loaded the same block in the meantime
+    auto itB = m_mapBlocks.find(Key);
+    if (itB != m_mapBlocks.end())
+        return itB->second->second;
+
+    m_lstBlocks.emplace_front(Key, pBlock);
+    m_mapBlocks[Key] = m_lstBlocks.begin();
+
+    if (m_lstBlocks.size() > m_nMaxBlocks)
+    {
+        m_mapBlocks.erase(m_lstBlocks.back().first);
+        m_lstBlocks.pop_back();
+    }
+
+    return pBlock;
+};
+
+CNP_BlockCache::block_type CNP_BlockCache::LoadBlock(int hFile, cnp::QWORD qwBlock)
+{
+    auto   pBlock  = std::make_shared<std::vector<char> >(size_t(BLOCK_SIZE));
+    size_t cbTotal = 0;
+
+#ifdef __linux__
+    off_t offBlock = static_cast<off_t>(qwBlock * BLOCK_SIZE);
+
+    while (cbTotal < BLOCK_SIZE)
+    {
+        ssize_t cbRead = ::pread(hFile, pBlock->data() + cbTotal, BLOCK_SIZE - cbTotal, offBlock + cbTotal);
+        if (cbRead < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return block_type();
+        }
+
+        // the last block of a file is short
+        if (cbRead == 0)
+            break;
+
+        cbTotal += static_cast<size_t>(cbRead);
+    }
+#elif _MSC_VER
+    std::lock_guard<std::mutex> IoLock(m_IoMutex);
+
+    if (::_lseeki64(hFile, static_cast<__int64>(qwBlock * BLOCK_SIZE), SEEK_SET) == -1)
+        return block_type();
+
+    while (cbTotal < BLOCK_SIZE)
+    {
+        int cbRead = ::_read(hFile, pBlock->data() + cbTotal, static_cast<unsigned>(BLOCK_SIZE - cbTotal));
+        if (cbRead < 0)
+            return block_type();
+
+        if (cbRead == 0)
+            break;
+
+        cbTotal += static_cast<size_t>(cbRead);
+    }
+#endif
+
+    pBlock->resize(cbTotal);
+    return pBlock;
+};
@@ -0,0 +1,119 @@
+/**
+ * @file   CNP_BlockCache.h
+ * @brief  CNP_BlockCache class interface
+ *
+ * CNP_BlockCache holds recently read fixed size blocks of read-only
+ * files, such as sealed ledger segments, evicting the least recently
+ * used block once it is full.  A miss reads the whole block outside the
+ * cache's lock, so concurrent readers of cached blocks are never held
+ * up by disk I/O.
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#if !defined(__CNP_BLOCK_CACHE_H__)
+#define __CNP_BLOCK_CACHE_H__
+
+#ifndef __CNP_COMMON_H__
+    #include "CNP_Common.h"
+#endif
+
+#ifndef _LIST_
+    #include <list>
+#endif
+
+#ifndef _MEMORY_
+    #include <memory>
+#endif
+
+#ifndef _MUTEX_
+    #include <mutex>
+#endif
+
+#ifndef _UNORDERED_MAP_
+    #include <unordered_map>
+#endif
+
+#ifndef _VECTOR_
+    #include <vector>
+#endif
+
+class CNP_BlockCache
+{
+public:
+    static const size_t BLOCK_SIZE = 64 * 1024;
+
+private:
+    typedef std::shared_ptr<const std::vector<char> >  block_type;
+
+    /// identifies a block, the file key is chosen by the caller & unique per file
+    struct BLOCK_KEY
+    {
+        cnp::QWORD  m_qwFileKey;
+        cnp::QWORD  m_qwBlock;
+
+        inline bool operator==(const BLOCK_KEY& rhs) const noexcept
+        { return m_qwFileKey == rhs.m_qwFileKey && m_qwBlock == rhs.m_qwBlock; };
+    };
+
+    struct BLOCK_KEY_HASH
+    {
+        inline size_t operator()(const BLOCK_KEY& Key) const noexcept
+        { return static_cast<size_t>((Key.m_qwFileKey * 0x9E3779B97F4A7C15ULL) ^ Key.m_qwBlock); };
+    };
+
+    typedef std::list<std::pair<BLOCK_KEY, block_type> >                             lru_type;
+    typedef std::unordered_map<BLOCK_KEY, lru_type::iterator, BLOCK_KEY_HASH>        index_type;
+
+    std::mutex   m_Mutex;
+    lru_type     m_lstBlocks;      ///< most recently used first, guarded by m_Mutex
+    index_type   m_mapBlocks;      ///< guarded by m_Mutex
+    size_t       m_nMaxBlocks;
+#ifdef _MSC_VER
+    std::mutex   m_IoMutex;        ///< serializes the seek & read pairs, which share a file position
+#endif
+
+public:
+/**
+    @brief Initialization Constructor
+
+    @param [in] cbCapacity   bytes of blocks to hold, at least one block
+ */
+    explicit CNP_BlockCache(size_t cbCapacity = 64 * 1024 * 1024);
+
+/**
+    @brief Changes the capacity, evicting blocks as needed
+ */
+    void    set_Capacity(size_t cbCapacity);
+
+/**
+    @brief Copies a byte range of a file, through the cache
+
+    @param [in]  hFile       descriptor of the file, opened for reading
+    @param [in]  qwFileKey   caller chosen key, unique to the file
+    @param [in]  qwOffset    offset of the range in the file
+    @param [out] pDest       receives the bytes
+    @param [in]  cbLen       length of the range
+
+    @retval true  on success
+    @retval false if the range extends past the end of the file, or on
+                  a read error
+ */
+    bool    Read(int hFile, cnp::QWORD qwFileKey, cnp::QWORD qwOffset, void* pDest, size_t cbLen);
+
+/**
+    @brief Drops every block of a file
+ */
+    void    Evict(cnp::QWORD qwFileKey);
+
+private:
+    block_type  GetBlock (int hFile, cnp::QWORD qwFileKey, cnp::QWORD qwBlock);
+    block_type  LoadBlock(int hFile, cnp::QWORD qwBlock);
+
+    CNP_BlockCache(const CNP_BlockCache&);
+    CNP_BlockCache& operator=(const CNP_BlockCache&);
+};
+
+#endif
@@ -0,0 +1,184 @@
+/**
+ * @file   CNP_ClientIdAllocator.cpp
+ * @brief  CNP_ClientIdAllocator class implementation
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#include <stddef.h>
+
+#include "CNP_ClientIdAllocator.h"
+
+/**
+    ID_CACHE holds the indices a thread has taken from an allocator's
+    queue but not yet issued, returning them once the thread ends.
+ */
+struct ID_CACHE
+{
+    CNP_ClientIdAllocator* m_pOwner;
+    size_t                 m_nCount;
+    cnp::WORD              m_rgIndices[CNP_ClientIdAllocator::CACHE_BATCH];
+
+    ~ID_CACHE()
+    {
+        Flush();
+    };
+
+    void Flush(void) noexcept
+    {
+        while (m_nCount > 0)
+            m_pOwner->Return(m_rgIndices[--m_nCount]);
+    };
+};
+
+static thread_local ID_CACHE t_IdCache = { nullptr, 0, { } };
+
+
+CNP_ClientIdAllocator::CNP_ClientIdAllocator(void) noexcept
+    : m_nEnqueuePos(0),
+      m_nDequeuePos(0)
+{
+    for (size_t i = 0; i < INDEX_COUNT; i++)
+    {
+        m_rgCells[i].m_nSequence.store(i, std::memory_order_relaxed);
+        m_rgCells[i].m_wIndex = 0;
+        m_rgIssued[i].store(cnp::INVALID_CLIENT_ID, std::memory_order_relaxed);
+        m_rgTags[i] = 0;
+    }
+
+    // the first & last indices would make IDs of 0 & cnp::INVALID_CLIENT_ID
+    for (size_t i = 1; i < INDEX_MASK; i++)
+        Enqueue(static_cast<cnp::WORD>(i));
+};
+
+cnp::WORD CNP_ClientIdAllocator::Allocate(void)
+{
+    ID_CACHE& Cache = t_IdCache;
+
+    // a cache filled from another allocator goes back to it first
+    if (Cache.m_pOwner != this)
+    {
+        if (Cache.m_pOwner)
+            Cache.Flush();
+        Cache.m_pOwner = this;
+    }
+
+    if (Cache.m_nCount == 0)
+        Cache.m_nCount = Take(Cache.m_rgIndices, CACHE_BATCH);
+
+    if (Cache.m_nCount == 0)
+        return cnp::INVALID_CLIENT_ID;
+
+    cnp::WORD wIndex = Cache.m_rgIndices[--Cache.m_nCount];
+
+    cnp::WORD wClientID = static_cast<cnp::WORD>((m_rgTags[wIndex] << INDEX_BITS) | wIndex);
+    m_rgIssued[wIndex].store(wClientID, std::memory_order_release);
+
+    return wClientID;
+};
+
+bool CNP_ClientIdAllocator::Release(cnp::WORD wClientID)
+{
+    cnp::WORD wIndex = static_cast<cnp::WORD>(wClientID & INDEX_MASK);
+
+    if (wIndex == 0 || wIndex == INDEX_MASK)
+        return false;
+
+    // only the current holder of the index gets to release it
+    cnp::WORD wExpected = wClientID;
+    if (m_rgIssued[wIndex].compare_exchange_strong(wExpected, cnp::INVALID_CLIENT_ID,
+                                                   std::memory_order_acq_rel) == false)
+        return false;
+
+    // the index is this thread's alone until it is queued, the next
+    // holder being issued the following tag
+    m_rgTags[wIndex] = static_cast<cnp::WORD>((m_rgTags[wIndex] + 1) & ((1U << TAG_BITS) - 1));
+
+    // straight back to the queue rather than the cache, delaying its reuse
+    Return(wIndex);
+    return true;
+};
+
+size_t CNP_ClientIdAllocator::Take(cnp::WORD* rgIndices, size_t nMax) noexcept
+{
+    size_t nResult = 0;
+
+    while (nResult < nMax && Dequeue(rgIndices[nResult]))
+        nResult++;
+
+    return nResult;
+};
+
+void CNP_ClientIdAllocator::Return(cnp::WORD wIndex) noexcept
+{
+    // the queue holds every index, so it always has room for one
+    Enqueue(wIndex);
+};
+
+bool CNP_ClientIdAllocator::Enqueue(cnp::WORD wIndex) noexcept
+{
+    size_t nPos = m_nEnqueuePos.load(std::memory_order_relaxed);
+    CELL*  pCell;
+
+    for (;;)
+    {
+        pCell = &m_rgCells[nPos & INDEX_MASK];
+
+        size_t    nSequence = pCell->m_nSequence.load(std::memory_order_acquire);
+        ptrdiff_t nDiff     = static_cast<ptrdiff_t>(nSequence) - static_cast<ptrdiff_t>(nPos);
+
+        if (nDiff == 0)
+        {
+            if (m_nEnqueuePos.compare_exchange_weak(nPos, nPos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (nDiff < 0)
+        {
+            // full
+            return false;
+        }
+        else
+        {
+            nPos = m_nEnqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    pCell->m_wIndex = wIndex;
+    pCell->m_nSequence.store(nPos + 1, std::memory_order_release);
+    return true;
+};
+
+bool CNP_ClientIdAllocator::Dequeue(cnp::WORD& wIndex) noexcept
+{
+    size_t nPos = m_nDequeuePos.load(std::memory_order_relaxed);
+    CELL*  pCell;
+
+    for (;;)
+    {
+        pCell = &m_rgCells[nPos & INDEX_MASK];
+
+        size_t    nSequence = pCell->m_nSequence.load(std::memory_order_acquire);
+        ptrdiff_t nDiff     = static_cast<ptrdiff_t>(nSequence) - static_cast<ptrdiff_t>(nPos + 1);
+
+        if (nDiff == 0)
+        {
+            if (m_nDequeuePos.compare_exchange_weak(nPos, nPos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (nDiff < 0)
+        {
+            // empty
+            return false;
+        }
+        else
+        {
+            nPos = m_nDequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    wIndex = pCell->m_wIndex;
+    pCell->m_nSequence.store(nPos + INDEX_COUNT, std::memory_order_release);
+    return true;
+};
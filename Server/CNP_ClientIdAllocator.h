@@ -0,0 +1,115 @@
+/**
+ * @file   CNP_ClientIdAllocator.h
+ * @brief  CNP_ClientIdAllocator class interface
+ *
+ * CNP_ClientIdAllocator issues the Client IDs of new sessions & takes
+ * them back once the session ends, so that the 16 bit ID space is never
+ * exhausted by clients that have long since disconnected.
+ *
+ * A Client ID is made of an index, in its low INDEX_BITS, & a tag in the
+ * bits above it, the tag being advanced each time the index is released.
+ * An ID kept by a stale client therefore no longer matches the one
+ * issued since, & is rejected; it could only match again once its index
+ * has been issued 2^TAG_BITS more times.
+ *
+ * Free indices are kept in a lock-free bounded queue, so that released
+ * indices are reissued in the order they were released, as late as
+ * possible.  Each thread takes a few indices from the queue at a time
+ * into a cache of its own, keeping the threads of a connect storm from
+ * contending on the queue for every ID.
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#if !defined(__CNP_CLIENT_ID_ALLOCATOR_H__)
+#define __CNP_CLIENT_ID_ALLOCATOR_H__
+
+#ifndef __CNP_COMMON_H__
+    #include "CNP_Common.h"
+#endif
+
+#ifndef _ATOMIC_
+    #include <atomic>
+#endif
+
+class CNP_ClientIdAllocator
+{
+public:
+    static const unsigned INDEX_BITS  = 14;
+    static const unsigned TAG_BITS    = 16 - INDEX_BITS;
+    static const size_t   INDEX_COUNT = size_t(1) << INDEX_BITS;
+    static const size_t   INDEX_MASK  = INDEX_COUNT - 1;
+    /// indices taken from the queue into a thread's cache at a time
+    static const size_t   CACHE_BATCH = 8;
+
+private:
+    /// a queue entry, whose sequence tells whether it is to be written or read next
+    struct CELL
+    {
+        std::atomic<size_t>  m_nSequence;
+        cnp::WORD            m_wIndex;
+    };
+
+    CELL                     m_rgCells[INDEX_COUNT];
+    /// kept a cache line apart, as producers & consumers update them independently
+    alignas(64) std::atomic<size_t>  m_nEnqueuePos;
+    alignas(64) std::atomic<size_t>  m_nDequeuePos;
+
+    /// the ID each index is issued as, cnp::INVALID_CLIENT_ID while free
+    std::atomic<cnp::WORD>   m_rgIssued[INDEX_COUNT];
+    /// the tag each index is next issued with, only changed by the thread releasing it
+    cnp::WORD                m_rgTags[INDEX_COUNT];
+
+public:
+    /// Default Constructor
+    CNP_ClientIdAllocator(void) noexcept;
+
+/**
+    @brief Issues a Client ID
+
+    Indices 0 & INDEX_MASK are never issued, so neither 0 nor
+    cnp::INVALID_CLIENT_ID can be.
+
+    @retval cnp::WORD containing the new Client ID
+    @retval cnp::INVALID_CLIENT_ID if every index is in use
+ */
+    cnp::WORD   Allocate(void);
+
+/**
+    @brief Takes back an issued Client ID, whose index goes to the back
+           of the queue
+
+    @retval true  on success
+    @retval false if the ID is not currently issued, being stale or
+                  already released
+ */
+    bool        Release (cnp::WORD wClientID);
+
+private:
+    friend struct ID_CACHE;
+
+/**
+    @brief Takes indices from the queue, to fill a thread's cache
+
+    @param [out] rgIndices   receives the indices
+    @param [in]  nMax        most indices to take
+
+    @retval size_t containing the number of indices taken
+ */
+    size_t      Take    (cnp::WORD* rgIndices, size_t nMax) noexcept;
+
+/**
+    @brief Returns an unissued index to the back of the queue
+ */
+    void        Return  (cnp::WORD wIndex) noexcept;
+
+    bool        Enqueue (cnp::WORD wIndex) noexcept;
+    bool        Dequeue (cnp::WORD& wIndex) noexcept;
+
+    CNP_ClientIdAllocator(const CNP_ClientIdAllocator&);
+    CNP_ClientIdAllocator& operator=(const CNP_ClientIdAllocator&);
+};
+
+#endif
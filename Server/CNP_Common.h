@@ -21,6 +21,24 @@ constexpr cnp::QWORD INVALID_CUSTOMER_ID     = 0;
 /// for error checking and data initialization
 constexpr cnp::DWORD INVALID_BALANCE         = static_cast<cnp::DWORD>(~0);
 
+/**
+    ACCOUNT_HANDLE locates an account in the CNP_AccountStore by its shard
+    & its position in the shard, rather than by its customer ID.  Accounts
+    are never removed, so a handle stays valid for as long as the server
+    runs.
+ */
+struct ACCOUNT_HANDLE
+{
+    cnp::DWORD  m_dwShard;
+    cnp::DWORD  m_dwSlot;
+
+    /// Default Constructor, referring to no account
+    constexpr ACCOUNT_HANDLE(void) noexcept
+        : m_dwShard(static_cast<cnp::DWORD>(~0)),
+          m_dwSlot (static_cast<cnp::DWORD>(~0))
+    { };
+};
+
 constexpr cnp::WORD  g_wServerMajorVersion   = 1;
 constexpr cnp::WORD  g_wServerMinorVersion   = 1;
 
@@ -0,0 +1,245 @@
+/**
+ * @file   CNP_Config.cpp
+ * @brief  Server command-line configuration implementation
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+    #include <sys/socket.h>
+#elif _MSC_VER
+    #include <winsock2.h>
+#endif
+
+#include "CNP_WriteAheadLog.h"
+#include "CNP_Logger.h"
+#include "CNP_Config.h"
+
+SERVER_CONFIG::SERVER_CONFIG(void) noexcept
+    : m_wPort      (0),
+      m_iBackLog   (SOMAXCONN),
+      m_nListeners (1),
+      m_bReusePort (false),
+      m_nEventLoops(0),
+      m_nWorkers   (0),
+      m_nWriters   (1),
+      m_bIoUring   (false),
+      m_cbMaxBatch (64 * 1024),
+      m_ulMaxBatchDelay(200),
+      m_cbMaxOutput(256 * 1024),
+      m_cbZeroCopyMin(0),
+      m_iLogMode   (CNP_WriteAheadLog::SM_BATCH),
+      m_ulLogDelay (2000),
+      m_ulCheckpoint(300),
+      m_nLedgerHot (1000000),
+      m_cbLedgerCache(64 * 1024 * 1024),
+      m_iTraceLevel(LL_INFO),
+      m_ulTraceSample(1),
+      m_wAdminPort (0)
+{ };
+
+static void PrintUsage(const char* szProgram) noexcept
+{
+    printf("usage: %s [options]\n"
+           "  --port=<n>        listening port (prompted for if omitted)\n"
+           "  --backlog=<n>     pending connection queue length (default: %i)\n"
+           "  --listeners=<n>   number of acceptor threads (default: 1)\n"
+           "  --reuseport       give each acceptor its own SO_REUSEPORT socket\n"
+           "  --loops=<n>       number of event loops (default: one per core)\n"
+           "  --workers=<n>     number of request worker threads (default: one per core)\n"
+           "  --writers=<n>     number of response writer threads (default: 1)\n"
+           "  --io-uring        use the io_uring transport, falling back to epoll if unsupported;\n"
+           "                    cannot be combined with --wal=sync\n"
+           "  --batch-bytes=<n> output batch size sent early (default: 65536)\n"
+           "  --batch-usecs=<n> output batch age in microseconds sent early (default: 200)\n"
+           "  --send-queue=<n>  unsent bytes per connection at which reading pauses (default: 262144)\n"
+           "  --zerocopy-bytes=<n> smallest output write sent with MSG_ZEROCOPY, 0 for none (default: 0)\n"
+           "  --wal=<mode>      database log durability: sync, batch, async or off (default: batch)\n"
+           "  --wal-usecs=<n>   batched log commit interval in microseconds (default: 2000)\n"
+           "  --checkpoint-secs=<n> background database checkpoint interval, 0 for none (default: 300)\n"
+           "  --ledger-hot=<n>  transactions kept in memory, older ones are sealed to disk, 0 keeps all (default: 1000000)\n"
+           "  --ledger-cache-mb=<n> megabytes of sealed transactions cached in memory (default: 64)\n"
+           "  --log-level=<lvl> console log level: off, error, warn, info or debug (default: info)\n"
+           "  --log-sample=<n>  log 1 in every n requests (default: 1)\n"
+           "  --admin-port=<n>  loopback port serving metrics reports, also dumped on SIGUSR2 (default: none)\n",
+           szProgram, SOMAXCONN);
+}
+
+/**
+    Matches an argument of the form --name=value
+
+    @retval address of the value string, or nullptr if szArg is not for szName
+ */
+static const char* MatchOption(const char* szArg, const char* szName) noexcept
+{
+    size_t cbName = strlen(szName);
+
+    if (strncmp(szArg, szName, cbName) == 0 && szArg[cbName] == '=')
+        return szArg + cbName + 1;
+
+    return nullptr;
+}
+
+/**
+    Parses a strictly positive decimal value
+
+    @retval true if szValue was a well formed value in the range [1, ulMax]
+ */
+static bool ParseCount(const char* szValue, unsigned long ulMax, unsigned long& ulResult) noexcept
+{
+    char* pEnd = nullptr;
+    ulResult   = strtoul(szValue, &pEnd, 10);
+
+    return (pEnd != szValue) && (*pEnd == '\0') && (ulResult > 0) && (ulResult <= ulMax);
+}
+
+bool ParseServerConfig(int argc, char* argv[], SERVER_CONFIG& Config)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char*   szArg   = argv[i];
+        const char*   szValue = nullptr;
+        unsigned long ulValue = 0;
+        bool          bValid  = true;
+
+        if ((szValue = MatchOption(szArg, "--port")) != nullptr)
+        {
+            if ((bValid = ParseCount(szValue, 0xFFFF, ulValue)))
+                Config.m_wPort = static_cast<unsigned short>(ulValue);
+        }
+        else if ((szValue = MatchOption(szArg, "--backlog")) != nullptr)
+        {
+            if ((bValid = ParseCount(szValue, 0x7FFFFFFF, ulValue)))
+                Config.m_iBackLog = static_cast<int>(ulValue);
+        }
+        else if ((szValue = MatchOption(szArg, "--listeners")) != nullptr)
+        {
+            if ((bValid = ParseCount(szValue, 1024, ulValue)))
+                Config.m_nListeners = ulValue;
+        }
+        else if ((szValue = MatchOption(szArg, "--loops")) != nullptr)
+        {
+            if ((bValid = ParseCount(szValue, 1024, ulValue)))
+                Config.m_nEventLoops = ulValue;
+        }
+        else if ((szValue = MatchOption(szArg, "--workers")) != nullptr)
+        {
+            if ((bValid = ParseCount(szValue, 1024, ulValue)))
+                Config.m_nWorkers = ulValue;
+        }
+        else if ((szValue = MatchOption(szArg, "--writers")) != nullptr)
+        {
+            if ((bValid = ParseCount(szValue, 1024, ulValue)))
+                Config.m_nWriters = ulValue;
+        }
+        else if ((szValue = MatchOption(szArg, "--batch-bytes")) != nullptr)
+        {
+            if ((bValid = ParseCount(szValue, 0x7FFFFFFF, ulValue)))
+                Config.m_cbMaxBatch = ulValue;
+        }
+        else if ((szValue = MatchOption(szArg, "--batch-usecs")) != nullptr)
+        {
+            if ((bValid = ParseCount(szValue, 10000000, ulValue)))
+                Config.m_ulMaxBatchDelay = ulValue;
+        }
+        else if ((szValue = MatchOption(szArg, "--send-queue")) != nullptr)
+        {
+            if ((bValid = ParseCount(szValue, 0x7FFFFFFF, ulValue)))
+                Config.m_cbMaxOutput = ulValue;
+        }
+        else if ((szValue = MatchOption(szArg, "--zerocopy-bytes")) != nullptr)
+        {
+            if (strcmp(szValue, "0") == 0)
+                Config.m_cbZeroCopyMin = 0;
+            else if ((bValid = ParseCount(szValue, 0x7FFFFFFF, ulValue)))
+                Config.m_cbZeroCopyMin = ulValue;
+        }
+        else if ((szValue = MatchOption(szArg, "--wal")) != nullptr)
+        {
+            if      (strcmp(szValue, "sync")  == 0) Config.m_iLogMode = CNP_WriteAheadLog::SM_SYNC;
+            else if (strcmp(szValue, "batch") == 0) Config.m_iLogMode = CNP_WriteAheadLog::SM_BATCH;
+            else if (strcmp(szValue, "async") == 0) Config.m_iLogMode = CNP_WriteAheadLog::SM_ASYNC;
+            else if (strcmp(szValue, "off")   == 0) Config.m_iLogMode = CNP_WriteAheadLog::SM_OFF;
+            else                                    bValid = false;
+        }
+        else if ((szValue = MatchOption(szArg, "--wal-usecs")) != nullptr)
+        {
+            if ((bValid = ParseCount(szValue, 10000000, ulValue)))
+                Config.m_ulLogDelay = ulValue;
+        }
+        else if ((szValue = MatchOption(szArg, "--checkpoint-secs")) != nullptr)
+        {
+            if (strcmp(szValue, "0") == 0)
+                Config.m_ulCheckpoint = 0;
+            else if ((bValid = ParseCount(szValue, 86400, ulValue)))
+                Config.m_ulCheckpoint = ulValue;
+        }
+        else if ((szValue = MatchOption(szArg, "--ledger-hot")) != nullptr)
+        {
+            if (strcmp(szValue, "0") == 0)
+                Config.m_nLedgerHot = 0;
+            else if ((bValid = ParseCount(szValue, 0x7FFFFFFF, ulValue)))
+                Config.m_nLedgerHot = ulValue;
+        }
+        else if ((szValue = MatchOption(szArg, "--ledger-cache-mb")) != nullptr)
+        {
+            if ((bValid = ParseCount(szValue, 65536, ulValue)))
+                Config.m_cbLedgerCache = static_cast<size_t>(ulValue) * 1024 * 1024;
+        }
+        else if ((szValue = MatchOption(szArg, "--log-level")) != nullptr)
+        {
+            if      (strcmp(szValue, "off")   == 0) Config.m_iTraceLevel = LL_OFF;
+            else if (strcmp(szValue, "error") == 0) Config.m_iTraceLevel = LL_ERROR;
+            else if (strcmp(szValue, "warn")  == 0) Config.m_iTraceLevel = LL_WARN;
+            else if (strcmp(szValue, "info")  == 0) Config.m_iTraceLevel = LL_INFO;
+            else if (strcmp(szValue, "debug") == 0) Config.m_iTraceLevel = LL_DEBUG;
+            else                                    bValid = false;
+        }
+        else if ((szValue = MatchOption(szArg, "--log-sample")) != nullptr)
+        {
+            if ((bValid = ParseCount(szValue, 0x7FFFFFFF, ulValue)))
+                Config.m_ulTraceSample = ulValue;
+        }
+        else if ((szValue = MatchOption(szArg, "--admin-port")) != nullptr)
+        {
+            if ((bValid = ParseCount(szValue, 0xFFFF, ulValue)))
+                Config.m_wAdminPort = static_cast<unsigned short>(ulValue);
+        }
+        else if (strcmp(szArg, "--reuseport") == 0)
+        {
+            Config.m_bReusePort = true;
+        }
+        else if (strcmp(szArg, "--io-uring") == 0)
+        {
+            Config.m_bIoUring = true;
+        }
+        else
+        {
+            bValid = false;
+        }
+
+        if (bValid == false)
+        {
+            fprintf(stderr, "invalid argument: %s\n", szArg);
+            PrintUsage(argv[0]);
+            return false;
+        }
+    }
+
+    // io_uring runs the handlers on its ring thread, where waiting out each
+    // log commit would stall every connection on the ring
+    if (Config.m_bIoUring && Config.m_iLogMode == CNP_WriteAheadLog::SM_SYNC)
+    {
+        fprintf(stderr, "--io-uring cannot be combined with --wal=sync\n");
+        PrintUsage(argv[0]);
+        return false;
+    }
+
+    return true;
+};
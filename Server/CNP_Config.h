@@ -0,0 +1,63 @@
+/**
+ * @file   CNP_Config.h
+ * @brief  SERVER_CONFIG struct definition
+ *
+ * Runtime tunables of the server, optionally supplied on the
+ * command-line as --name=value pairs.
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#if !defined(__CNP_CONFIG_H__)
+#define __CNP_CONFIG_H__
+
+#include <stddef.h>
+
+/**
+    SERVER_CONFIG holds the server's runtime configuration,
+    initialized to the defaults used when no command-line
+    arguments are given.
+ */
+struct SERVER_CONFIG
+{
+    unsigned short  m_wPort;        ///< listening port, 0 prompts the user for it
+    int             m_iBackLog;     ///< length of each listener's pending connection queue
+    size_t          m_nListeners;   ///< number of acceptor threads
+    bool            m_bReusePort;   ///< give each acceptor its own SO_REUSEPORT socket
+    size_t          m_nEventLoops;  ///< number of reactor event loops, 0 for one per core
+    size_t          m_nWorkers;     ///< number of request worker threads, 0 for one per core
+    size_t          m_nWriters;     ///< number of response writer threads
+    bool            m_bIoUring;     ///< [Linux] use the io_uring transport, if the kernel supports it
+    size_t          m_cbMaxBatch;   ///< size in bytes at which a connection's output batch is sent early
+    unsigned long   m_ulMaxBatchDelay; ///< age in microseconds at which an output batch is sent early
+    size_t          m_cbMaxOutput;  ///< unsent output in bytes at which reading from a connection pauses
+    size_t          m_cbZeroCopyMin;///< [Linux] smallest output write made with MSG_ZEROCOPY, 0 for none
+    int             m_iLogMode;     ///< CNP_WriteAheadLog::SYNC_MODE of the server database's log
+    unsigned long   m_ulLogDelay;   ///< microseconds a batched group commit collects log records for
+    unsigned long   m_ulCheckpoint; ///< seconds between background database checkpoints, 0 for none
+    size_t          m_nLedgerHot;   ///< transactions kept in memory, older ones are sealed to disk, 0 keeps all
+    size_t          m_cbLedgerCache;///< bytes of sealed ledger segments cached in memory
+    int             m_iTraceLevel;  ///< LOG_LEVEL of the console log
+    unsigned long   m_ulTraceSample;///< 1 in how many requests are written to the console log
+    unsigned short  m_wAdminPort;   ///< loopback port serving metrics reports, 0 for none
+
+    /// Default Constructor
+    SERVER_CONFIG(void) noexcept;
+};
+
+/**
+    Parses the server's command-line arguments
+
+    @param [in]  argc     count of arguments, as passed to main()
+    @param [in]  argv     argument vector, as passed to main()
+    @param [out] Config   receives the parsed configuration
+
+    @retval true  on success
+    @retval false on an unknown or malformed argument, or arguments that
+                  cannot be combined, after printing usage
+ */
+bool ParseServerConfig(int argc, char* argv[], SERVER_CONFIG& Config);
+
+#endif
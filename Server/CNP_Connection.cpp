@@ -0,0 +1,378 @@
+/**
+ * @file   CNP_Connection.cpp
+ * @brief  CNP_Connection class implementation
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#include "CNP_Connection.h"
+#include "CNP_Messaging.h"
+#include "CNP_Metrics.h"
+#include "CNP_ResponseDispatcher.h"
+
+/// output batch size limit, set by SetBatchLimits()
+static size_t                    g_cbMaxBatch = 64 * 1024;
+/// output batch latency limit, set by SetBatchLimits()
+static std::chrono::microseconds g_usMaxBatchDelay(200);
+/// unwritten output at which reading pauses, set by SetOutputLimit()
+static size_t                    g_cbMaxOutput = 256 * 1024;
+/// smallest output write made with MSG_ZEROCOPY, set by SetZeroCopyLimit()
+static size_t                    g_cbZeroCopyMin = 0;
+/// milliseconds a closing connection waits for its zero-copy writes to complete
+static const unsigned long       ZEROCOPY_LINGER = 100;
+
+
+CNP_Connection::CNP_Connection(void) noexcept
+    : m_Socket    (),
+      m_Session   (),
+      m_nEventLoop(0),
+      m_RecvBuffer(),
+      m_vecFrame  (),
+      m_OutputMutex(),
+      m_Output    (),
+      m_pDispatcher(nullptr),
+      m_bWriteScheduled(false),
+      m_bWriteFailed(false),
+      m_bReadPaused(false)
+{ };
+
+CNP_Connection::~CNP_Connection()
+{
+    m_Socket.Close();
+};
+
+void CNP_Connection::Open(SOCKET hSocket, const sockaddr_in& remoteAddr, size_t nEventLoop,
+                          CNP_ResponseDispatcher* pDispatcher) noexcept
+{
+    m_Socket.Attach(hSocket, remoteAddr);
+    m_Session.Reset();
+    m_nEventLoop = nEventLoop;
+    m_RecvBuffer.Clear();
+    m_Output.Clear();
+    m_pDispatcher     = pDispatcher;
+    m_bWriteScheduled = false;
+    m_bWriteFailed    = false;
+    m_bReadPaused     = false;
+
+    // only writes made by the dispatcher, an io_uring transport submits its own
+    if (m_pDispatcher && g_cbZeroCopyMin > 0)
+        m_Output.EnableZeroCopy(m_Socket, g_cbZeroCopyMin);
+
+#ifdef _MSC_VER
+    m_Socket.SetBlocking(false);
+#endif
+};
+
+bool CNP_Connection::OnReadable(void)
+{
+    // first the messages left buffered when the output last reached its limit
+    if ( DispatchFrames() == false )
+    {
+        Flush();
+        return true;
+    }
+
+    for (;;)
+    {
+        char*  pData  = nullptr;
+        size_t cbFree = m_RecvBuffer.get_WriteSpan(pData);
+
+        if (cbFree == 0)
+        {
+            m_RecvBuffer.Reserve(m_RecvBuffer.get_Capacity() * 2);
+            cbFree = m_RecvBuffer.get_WriteSpan(pData);
+        }
+
+        int cbRecvLen = m_Socket.Receive(pData, cbFree);
+
+        if ( cbRecvLen == SOCKET_ERROR )
+        {
+            if ( m_Socket.Interrupted() )
+                continue;
+
+            // the socket has been drained, send what the cycle generated
+            if ( m_Socket.WouldBlock() )
+            {
+                Flush();
+                return true;
+            }
+
+            return false;
+        }
+        else if ( cbRecvLen == 0 )
+        {
+            // Client has disconnected or terminated, it may only have
+            // shut down its sending side, OnClose() still answers it
+            return false;
+        }
+
+        m_RecvBuffer.Commit(cbRecvLen);
+
+        // leave the rest in the socket until the client catches up
+        if ( DispatchFrames() == false || IsOutputFull() )
+        {
+            Flush();
+            return true;
+        }
+    }
+};
+
+void CNP_Connection::OnReceived(const char* pData, size_t cbLen)
+{
+    m_RecvBuffer.Write(pData, cbLen);
+    DispatchFrames();
+};
+
+bool CNP_Connection::DispatchPending(void)
+{
+    return DispatchFrames();
+};
+
+bool CNP_Connection::HasPendingRequests(void) const noexcept
+{
+    cnp::STD_HDR hdr;
+
+    if (m_Session.m_Query.IsPending())
+        return true;
+
+    if (m_RecvBuffer.get_Size() < sizeof(hdr))
+        return false;
+
+    m_RecvBuffer.Peek(&hdr, sizeof(hdr));
+
+    return m_RecvBuffer.get_Size() >= sizeof(hdr) + hdr.m_wDataLen;
+};
+
+void CNP_Connection::OnClose(void) noexcept
+{
+    if (m_Session.IsOpen())
+        ProcessDisconnect(m_Session.m_Info.get_ClientID());
+    m_Session.Reset();
+
+    {
+        std::lock_guard<std::mutex> OutputLock(m_OutputMutex);
+
+        // copied, the chunks being freed as the socket closes
+        if ( m_pDispatcher && m_bWriteFailed == false )
+            m_Output.Flush(m_Socket, false);
+        m_Output.Linger(m_Socket, ZEROCOPY_LINGER);
+        m_Output.Clear();
+    }
+
+    m_Socket.Close();
+};
+
+bool CNP_Connection::QueueResponse(const void* pMsg, size_t cbLen)
+{
+    bool bSchedule = false;
+    {
+        std::lock_guard<std::mutex> OutputLock(m_OutputMutex);
+
+        if ( m_bWriteFailed )
+            return false;
+
+        m_Output.Append(pMsg, cbLen);
+        bSchedule = IsBatchDue();
+    }
+
+    if ( bSchedule )
+        ScheduleWrite();
+
+    return true;
+};
+
+bool CNP_Connection::IsBatchDue(void) noexcept
+{
+    if ( m_pDispatcher && m_bWriteScheduled == false &&
+         ( m_Output.get_Size() >= g_cbMaxBatch ||
+           CNP_OutputBatch::clock_type::now() - m_Output.get_FirstTime() >= g_usMaxBatchDelay ) )
+    {
+        m_bWriteScheduled = true;
+        return true;
+    }
+
+    return false;
+};
+
+void CNP_Connection::ScheduleWrite(void)
+{
+    m_pDispatcher->Schedule(this);
+};
+
+void CNP_Connection::Flush(void)
+{
+    bool bSchedule = false;
+    {
+        std::lock_guard<std::mutex> OutputLock(m_OutputMutex);
+
+        // the completion notices of zero-copy writes also wake the reader
+        m_Output.Reap(m_Socket);
+
+        if ( m_pDispatcher && m_bWriteScheduled == false && m_Output.IsEmpty() == false )
+            m_bWriteScheduled = bSchedule = true;
+    }
+
+    if ( bSchedule )
+        m_pDispatcher->Schedule(this);
+};
+
+CNP_Connection::WRITE_RESULT CNP_Connection::WriteOutput(bool& bResumeReading)
+{
+    std::lock_guard<std::mutex> OutputLock(m_OutputMutex);
+
+    bResumeReading = false;
+
+    m_Output.Reap(m_Socket);
+
+    if ( m_Output.Flush(m_Socket) == false )
+    {
+        // have the reader notice the failure & close the connection
+        m_Output.Clear();
+        m_bWriteFailed    = true;
+        m_bWriteScheduled = false;
+#ifdef __linux__
+        m_Socket.Shutdown(SHUT_RDWR);
+#elif _MSC_VER
+        m_Socket.Shutdown(SD_BOTH);
+#endif
+        bResumeReading = m_bReadPaused;
+        m_bReadPaused  = false;
+        return WR_FAILED;
+    }
+
+    if ( m_bReadPaused && m_Output.get_Size() <= g_cbMaxOutput / 2 )
+    {
+        m_bReadPaused  = false;
+        bResumeReading = true;
+    }
+
+    if ( m_Output.IsEmpty() )
+    {
+        m_bWriteScheduled = false;
+        return WR_COMPLETE;
+    }
+
+    return WR_BLOCKED;
+};
+
+bool CNP_Connection::PauseReading(void)
+{
+    std::lock_guard<std::mutex> OutputLock(m_OutputMutex);
+
+    if ( m_Output.get_Size() >= g_cbMaxOutput )
+        m_bReadPaused = true;
+
+    return m_bReadPaused;
+};
+
+bool CNP_Connection::IsOutputFull(void)
+{
+    std::lock_guard<std::mutex> OutputLock(m_OutputMutex);
+
+    return m_Output.get_Size() >= g_cbMaxOutput;
+};
+
+bool CNP_Connection::IsReadPaused(void)
+{
+    std::lock_guard<std::mutex> OutputLock(m_OutputMutex);
+
+    return m_bReadPaused;
+};
+
+size_t CNP_Connection::get_OutputBuffers(IO_BUFFER* rgBuffers, size_t nMax)
+{
+    std::lock_guard<std::mutex> OutputLock(m_OutputMutex);
+
+    return m_Output.get_IOBuffers(rgBuffers, nMax);
+};
+
+bool CNP_Connection::ConsumeOutput(size_t cbLen)
+{
+    std::lock_guard<std::mutex> OutputLock(m_OutputMutex);
+
+    m_Output.Consume(cbLen);
+
+    if ( m_bReadPaused && m_Output.get_Size() <= g_cbMaxOutput / 2 )
+    {
+        m_bReadPaused = false;
+        return true;
+    }
+
+    return false;
+};
+
+void CNP_Connection::SetBatchLimits(size_t cbMaxBatch, unsigned long ulMaxDelayUSecs) noexcept
+{
+    g_cbMaxBatch      = cbMaxBatch;
+    g_usMaxBatchDelay = std::chrono::microseconds(ulMaxDelayUSecs);
+};
+
+void CNP_Connection::SetOutputLimit(size_t cbMaxOutput) noexcept
+{
+    g_cbMaxOutput = cbMaxOutput;
+};
+
+void CNP_Connection::SetZeroCopyLimit(size_t cbMin) noexcept
+{
+    g_cbZeroCopyMin = cbMin;
+};
+
+bool CNP_Connection::DispatchFrames(void)
+{
+    cnp::STD_HDR hdr;
+
+    // a transaction query cut short at the output limit goes ahead of the
+    // requests that followed it
+    if (m_Session.m_Query.IsPending() && ContinueTransactionQuery(this) == false)
+        return false;
+
+    while (m_RecvBuffer.get_Size() >= sizeof(hdr))
+    {
+        m_RecvBuffer.Peek(&hdr, sizeof(hdr));
+
+        size_t cbFrame = sizeof(hdr) + hdr.m_wDataLen;
+
+        if (m_RecvBuffer.get_Size() < cbFrame)
+        {
+            // make room for the remainder of the message to arrive
+            m_RecvBuffer.Reserve(cbFrame);
+            break;
+        }
+
+        // the rest stays buffered until the output has drained
+        if (IsOutputFull())
+            return false;
+
+        const char* pMsg = nullptr;
+
+        if (m_RecvBuffer.get_ReadSpan(pMsg) < cbFrame)
+        {
+            // the message wraps around the end of the ring
+            m_vecFrame.resize(cbFrame);
+            m_RecvBuffer.Peek(m_vecFrame.data(), cbFrame);
+            pMsg = m_vecFrame.data();
+        }
+
+        DispatchMessage(pMsg, cbFrame);
+        m_RecvBuffer.Consume(cbFrame);
+    }
+
+    return true;
+};
+
+void CNP_Connection::DispatchMessage(const char* pMsg, size_t cbMsgLen)
+{
+    // the frame is at least a header, whatever its type
+    const cnp::STD_HDR* pHdr = reinterpret_cast<const cnp::STD_HDR*>( pMsg );
+
+    auto tmStart = std::chrono::steady_clock::now();
+
+    cnp::CER_TYPE cerRR = DispatchRequest(pMsg, cbMsgLen, this);
+
+    auto tmElapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now() - tmStart);
+    g_Metrics.Record(pHdr->get_MsgType(), cerRR, cbMsgLen,
+                     static_cast<cnp::QWORD>(tmElapsed.count()));
+};
@@ -0,0 +1,355 @@
+/**
+ * @file   CNP_Connection.h
+ * @brief  CNP_Connection class interface
+ *
+ * CNP_Connection is the per-connection context owned by the
+ * CNP_Reactor.  It binds an accepted CNP_Socket to the session of
+ * the Client ID issued on that connection, frames the received byte stream into
+ * messages using STD_HDR::m_wDataLen & routes each one to its
+ * Process*Request handler.  The responses generated during a read
+ * cycle are built in place in an output batch that is handed to the
+ * CNP_ResponseDispatcher once the cycle ends, or sooner if the batch
+ * reaches its size or age limit, so the request processing never waits
+ * on the socket.  Once the unwritten output reaches its limit, reading
+ * from the connection pauses until the output has drained to half of
+ * it.  Closed contexts are kept on the reactor's free list & reopened
+ * for later connections.
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#if !defined(__CNP_CONNECTION_H__)
+#define __CNP_CONNECTION_H__
+
+#ifndef __CNP_COMMON_H__
+    #include "CNP_Common.h"
+#endif
+
+#ifndef __CNP_SESSION_H__
+    #include "CNP_Session.h"
+#endif
+
+#ifndef __CNP_SOCKET_H__
+    #include "CNP_Socket.h"
+#endif
+
+#ifndef __CNP_RING_BUFFER_H__
+    #include "CNP_RingBuffer.h"
+#endif
+
+#ifndef __CNP_OUTPUT_BATCH_H__
+    #include "CNP_OutputBatch.h"
+#endif
+
+#ifndef _MUTEX_
+    #include <mutex>
+#endif
+
+#ifndef _NEW_
+    #include <new>
+#endif
+
+#ifndef _UTILITY_
+    #include <utility>
+#endif
+
+#ifndef _VECTOR_
+    #include <vector>
+#endif
+
+class CNP_ResponseDispatcher;
+
+class CNP_Connection
+{
+public:
+    /// outcome of WriteOutput()
+    enum WRITE_RESULT
+    {
+        WR_COMPLETE,    ///< all of the output has been written
+        WR_BLOCKED,     ///< the socket would block with output remaining
+        WR_FAILED       ///< the socket has failed & the output was discarded
+    };
+
+private:
+    CNP_Socket        m_Socket;
+    SESSION_CONTEXT   m_Session;      ///< session of the Client ID issued on this connection
+    size_t            m_nEventLoop;   ///< index of the reactor event loop servicing it
+    CNP_RingBuffer    m_RecvBuffer;   ///< received bytes not yet framed into a message
+    std::vector<char> m_vecFrame;     ///< contiguous copy of a frame that wraps m_RecvBuffer
+    std::mutex        m_OutputMutex;
+    CNP_OutputBatch   m_Output;       ///< responses not yet written, guarded by m_OutputMutex
+    CNP_ResponseDispatcher* m_pDispatcher; ///< writes the output, if null the transport does
+    bool              m_bWriteScheduled; ///< handed to m_pDispatcher & not yet drained
+    bool              m_bWriteFailed; ///< the output can no longer be written
+    bool              m_bReadPaused;  ///< reading waits for the output to drain
+
+public:
+/**
+    @brief Default Constructor
+
+    Constructs a closed connection, ready to be opened
+*/
+    CNP_Connection(void) noexcept;
+
+    ~CNP_Connection();
+
+/**
+    @brief Binds the connection to a newly accepted socket
+
+    Takes ownership of an accepted socket handle, which must be
+    non-blocking (on Windows, Open() makes it so).
+
+    @param [in] hSocket       accepted socket handle
+    @param [in] remoteAddr    address of the connected peer
+    @param [in] nEventLoop    index of the event loop that will service it
+    @param [in] pDispatcher   writes the batched output, if null the transport
+                              submits it itself, as with io_uring
+ */
+    void Open(SOCKET hSocket, const sockaddr_in& remoteAddr, size_t nEventLoop,
+              CNP_ResponseDispatcher* pDispatcher) noexcept;
+
+    inline CNP_Socket&  get_Socket(void) noexcept
+    { return m_Socket; };
+
+    inline cnp::WORD    get_ClientID(void) const noexcept
+    { return m_Session.m_Info.get_ClientID(); };
+
+    /// only to be used by the event loop servicing the connection
+    inline SESSION_CONTEXT& get_Session(void) noexcept
+    { return m_Session; };
+
+    inline size_t       get_EventLoop(void) const noexcept
+    { return m_nEventLoop; };
+
+/**
+    @brief Drains the socket of all pending data
+
+    Reads until the socket would block, dispatching every complete
+    message received.  A partial message is kept buffered until the
+    rest of it arrives.  Dispatching & reading stop early once the
+    unwritten output has reached its limit, see PauseReading(); the
+    messages not yet dispatched stay buffered & are dispatched first
+    by the next call.  Intended to be called on an edge-triggered read
+    readiness notification.
+
+    @retval true  if the connection remains open
+    @retval false if the peer has disconnected or the socket has failed,
+                  in which case the caller is expected to call OnClose()
+ */
+    bool OnReadable(void);
+
+/**
+    @brief Frames & dispatches data received on the connection by the
+           transport, for transports that complete reads on their own
+
+    @param [in] pData   received data
+    @param [in] cbLen   length of the received data in bytes
+ */
+    void OnReceived(const char* pData, size_t cbLen);
+
+/**
+    @brief Once reading resumes, continues a transaction query cut short
+           at the output limit & dispatches the messages left buffered,
+           for transports that complete reads on their own
+
+    @retval true  if every complete message has been dispatched
+    @retval false if the output has reached its limit again
+ */
+    bool DispatchPending(void);
+
+/**
+    @retval true  if a complete message is buffered, not yet dispatched, or
+                  a transaction query's response stream is yet to continue
+ */
+    bool HasPendingRequests(void) const noexcept;
+
+/**
+    @brief Releases the session associated with this connection & closes
+           the underlying socket
+
+    Output still queued is written if the socket accepts it without
+    blocking, the rest is discarded.
+ */
+    void OnClose   (void) noexcept;
+
+/**
+    @brief Adds a response message to the connection's output batch
+
+    The batch is handed to the response dispatcher immediately if it has
+    grown past the size limit or its oldest response has been waiting
+    longer than the latency limit, otherwise at the end of the current
+    read cycle.  Never writes to the socket itself.
+
+    @param [in] pMsg    response message
+    @param [in] cbLen   length of the message in bytes
+
+    @retval true  on success
+    @retval false if the connection's output has failed, the message is discarded
+ */
+    bool QueueResponse(const void* pMsg, size_t cbLen);
+
+/**
+    @brief Builds a response in place in the connection's output batch,
+           rather than copying it in
+
+    The batch is handed to the response dispatcher as by QueueResponse().
+    The output lock is held while fnBuild runs, so it is expected to do no
+    more than encode the response.
+
+    @param [in] cbMaxLen   most bytes the response may take, at most
+                           CNP_OutputBatch::CHUNK_SIZE
+    @param [in] fnBuild    size_t fnBuild(void* pBuffer), constructs the
+                           response at pBuffer & returns its length
+
+    @retval true  on success
+    @retval false if the connection's output has failed, or cbMaxLen is
+                  too large, & no response was built
+ */
+    template <class _Fn>
+    bool BuildResponse(size_t cbMaxLen, _Fn fnBuild)
+    {
+        bool bSchedule = false;
+        {
+            std::lock_guard<std::mutex> OutputLock(m_OutputMutex);
+
+            void* pBuffer = m_bWriteFailed ? nullptr : m_Output.Reserve(cbMaxLen);
+            if (pBuffer == nullptr)
+                return false;
+
+            m_Output.Commit(fnBuild(pBuffer));
+            bSchedule = IsBatchDue();
+        }
+
+        if (bSchedule)
+            ScheduleWrite();
+
+        return true;
+    };
+
+/**
+    @brief Constructs a fixed size response message, such as a
+           cnp::DEPOSIT_RESPONSE, in place in the output batch
+
+    @param [in] args   the message's constructor arguments
+
+    @retval true  on success
+    @retval false if the connection's output has failed
+ */
+    template <class _Msg, class... _Args>
+    bool EmplaceResponse(_Args&&... args)
+    {
+        return BuildResponse(sizeof(_Msg), [&args...](void* pBuffer) -> size_t
+        {
+            return (new (pBuffer) _Msg(std::forward<_Args>(args)...))->get_Size();
+        });
+    };
+
+/**
+    @brief Hands any batched responses to the response dispatcher
+ */
+    void Flush     (void);
+
+/**
+    @brief Writes as much of the queued output as the socket accepts,
+           called by the response dispatcher
+
+    @param [out] bResumeReading   set if reading was paused & the output
+                                  has now drained far enough for it to resume
+
+    @retval WRITE_RESULT  describing the state of the output
+ */
+    WRITE_RESULT WriteOutput(bool& bResumeReading);
+
+/**
+    @brief Pauses reading if the unwritten output has reached its limit
+
+    Whoever drains the output below the low watermark is then told to
+    resume reading, by WriteOutput() or ConsumeOutput().
+
+    @retval true  if reading has been paused
+    @retval false if reading may continue
+ */
+    bool PauseReading(void);
+
+/**
+    @retval true  if the unwritten output has reached its limit
+ */
+    bool IsOutputFull(void);
+
+/**
+    @retval true  if reading has been paused by PauseReading() & not yet resumed
+ */
+    bool IsReadPaused(void);
+
+/**
+    @brief Describes the batched output not yet written, for a transport
+           that submits it asynchronously
+
+    @retval size_t containing the number of buffers filled in
+    @sa CNP_OutputBatch::get_IOBuffers
+ */
+    size_t get_OutputBuffers(IO_BUFFER* rgBuffers, size_t nMax);
+
+/**
+    @brief Releases cbLen bytes of batched output, once the transport has
+           completed writing them
+
+    @retval true  if reading was paused & may now resume
+ */
+    bool   ConsumeOutput(size_t cbLen);
+
+/**
+    @brief Sets the output batch limits shared by all connections
+
+    @param [in] cbMaxBatch       size in bytes at which a batch is written early
+    @param [in] ulMaxDelayUSecs  age in microseconds at which a batch is written early
+ */
+    static void SetBatchLimits(size_t cbMaxBatch, unsigned long ulMaxDelayUSecs) noexcept;
+
+/**
+    @brief Sets the limit on each connection's unwritten output, at which
+           reading from the connection pauses
+
+    @param [in] cbMaxOutput   high watermark in bytes, reading resumes at half of it
+ */
+    static void SetOutputLimit(size_t cbMaxOutput) noexcept;
+
+/**
+    @brief Sets the size from which a connection's batched output is
+           written with MSG_ZEROCOPY, by the response dispatcher
+
+    Only supported on Linux, & takes effect for connections opened later.
+
+    @param [in] cbMin   smallest write made without copying, 0 to copy all
+ */
+    static void SetZeroCopyLimit(size_t cbMin) noexcept;
+
+private:
+/**
+    @brief Dispatches the complete messages held in m_RecvBuffer, after
+           continuing a pending transaction query, stopping once the
+           unwritten output has reached its limit
+
+    @retval true  if every complete message has been dispatched
+    @retval false if messages were left buffered at the output limit
+ */
+    bool DispatchFrames (void);
+
+/// Routes a single received message to its Process*Request handler
+    void DispatchMessage(const char* pMsg, size_t cbMsgLen);
+
+/// @retval true if the output batch is to be written early, called under m_OutputMutex
+    bool IsBatchDue     (void) noexcept;
+
+/// Hands the output batch to the response dispatcher
+    void ScheduleWrite  (void);
+
+// Cannot allow shallow copies since the connection
+// owns the underlying socket handle
+    CNP_Connection(const CNP_Connection&);
+    CNP_Connection& operator=(const CNP_Connection&);
+};
+
+#endif
@@ -0,0 +1,364 @@
+/**
+ * @file   CNP_IoUring.cpp
+ * @brief  CNP_IoUring class implementation
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "CNP_IoUring.h"
+
+// liburing is not a build dependency, the system calls are made directly
+
+static int io_uring_setup(unsigned nEntries, io_uring_params* pParams) noexcept
+{
+    return static_cast<int>(::syscall(__NR_io_uring_setup, nEntries, pParams));
+}
+
+static int io_uring_enter(int hRing, unsigned nSubmit, unsigned nWaitFor, unsigned uFlags) noexcept
+{
+    return static_cast<int>(::syscall(__NR_io_uring_enter, hRing, nSubmit, nWaitFor, uFlags, nullptr, 0));
+}
+
+static int io_uring_register(int hRing, unsigned uOpcode, void* pArg, unsigned nArgs) noexcept
+{
+    return static_cast<int>(::syscall(__NR_io_uring_register, hRing, uOpcode, pArg, nArgs));
+}
+
+/// the ring indices are shared with the kernel & need acquire/release ordering
+static inline unsigned LoadAcquire(const unsigned* pValue) noexcept
+{
+    return __atomic_load_n(pValue, __ATOMIC_ACQUIRE);
+}
+
+static inline void StoreRelease(unsigned* pValue, unsigned uValue) noexcept
+{
+    __atomic_store_n(pValue, uValue, __ATOMIC_RELEASE);
+}
+
+
+CNP_IoUring::CNP_IoUring(void) noexcept
+    : m_hRing(-1),
+      m_pSqHead(nullptr),
+      m_pSqTail(nullptr),
+      m_pSqArray(nullptr),
+      m_uSqMask(0),
+      m_nSqEntries(0),
+      m_uSqTail(0),
+      m_uSqSubmitted(0),
+      m_pSqes(nullptr),
+      m_pCqHead(nullptr),
+      m_pCqTail(nullptr),
+      m_uCqMask(0),
+      m_pCqes(nullptr),
+      m_pSqRing(MAP_FAILED),
+      m_cbSqRing(0),
+      m_pCqRing(MAP_FAILED),
+      m_cbCqRing(0),
+      m_cbSqes(0),
+      m_uFeatures(0),
+      m_pBufRing(nullptr),
+      m_cbBufRing(0),
+      m_pBufData(nullptr),
+      m_nBuffers(0),
+      m_cbBuffer(0),
+      m_wBufGroup(0)
+{ };
+
+CNP_IoUring::~CNP_IoUring()
+{
+    Close();
+};
+
+bool CNP_IoUring::Create(unsigned nEntries) noexcept
+{
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    m_hRing = io_uring_setup(nEntries, &params);
+    if (m_hRing == -1)
+        return false;
+
+    m_cbSqRing = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    m_cbCqRing = params.cq_off.cqes  + params.cq_entries * sizeof(io_uring_cqe);
+    m_cbSqes   = params.sq_entries * sizeof(io_uring_sqe);
+    m_uFeatures = params.features;
+
+    // both queues share a single mapping on any kernel recent enough to matter
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        if (m_cbCqRing > m_cbSqRing)
+            m_cbSqRing = m_cbCqRing;
+        m_cbCqRing = m_cbSqRing;
+    }
+
+    m_pSqRing = ::mmap(nullptr, m_cbSqRing, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       m_hRing, IORING_OFF_SQ_RING);
+    if (m_pSqRing == MAP_FAILED)
+    {
+        Close();
+        return false;
+    }
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        m_pCqRing = m_pSqRing;
+    }
+    else
+    {
+        m_pCqRing = ::mmap(nullptr, m_cbCqRing, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                           m_hRing, IORING_OFF_CQ_RING);
+        if (m_pCqRing == MAP_FAILED)
+        {
+            Close();
+            return false;
+        }
+    }
+
+    void* pSqes = ::mmap(nullptr, m_cbSqes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         m_hRing, IORING_OFF_SQES);
+    if (pSqes == MAP_FAILED)
+    {
+        Close();
+        return false;
+    }
+
+    char* pSq = static_cast<char*>(m_pSqRing);
+    char* pCq = static_cast<char*>(m_pCqRing);
+
+    m_pSqHead    = reinterpret_cast<unsigned*>(pSq + params.sq_off.head);
+    m_pSqTail    = reinterpret_cast<unsigned*>(pSq + params.sq_off.tail);
+    m_pSqArray   = reinterpret_cast<unsigned*>(pSq + params.sq_off.array);
+    m_uSqMask    = *reinterpret_cast<unsigned*>(pSq + params.sq_off.ring_mask);
+    m_nSqEntries = params.sq_entries;
+    m_pSqes      = static_cast<io_uring_sqe*>(pSqes);
+    m_uSqTail    = *m_pSqTail;
+    m_uSqSubmitted = m_uSqTail;
+
+    m_pCqHead    = reinterpret_cast<unsigned*>(pCq + params.cq_off.head);
+    m_pCqTail    = reinterpret_cast<unsigned*>(pCq + params.cq_off.tail);
+    m_uCqMask    = *reinterpret_cast<unsigned*>(pCq + params.cq_off.ring_mask);
+    m_pCqes      = reinterpret_cast<io_uring_cqe*>(pCq + params.cq_off.cqes);
+
+    // the submission queue array is a fixed identity mapping onto m_pSqes
+    for (unsigned i = 0; i < m_nSqEntries; i++)
+        m_pSqArray[i] = i;
+
+    return true;
+};
+
+void CNP_IoUring::Close(void) noexcept
+{
+    if (m_pSqes)
+        ::munmap(m_pSqes, m_cbSqes);
+    if (m_pCqRing != MAP_FAILED && m_pCqRing != m_pSqRing)
+        ::munmap(m_pCqRing, m_cbCqRing);
+    if (m_pSqRing != MAP_FAILED)
+        ::munmap(m_pSqRing, m_cbSqRing);
+
+    // closing the ring releases the buffer ring registration
+    if (m_hRing != -1)
+        ::close(m_hRing);
+
+    if (m_pBufRing)
+        ::munmap(m_pBufRing, m_cbBufRing);
+    free(m_pBufData);
+
+    m_hRing    = -1;
+    m_pSqes    = nullptr;
+    m_pSqRing  = MAP_FAILED;
+    m_pCqRing  = MAP_FAILED;
+    m_pBufRing = nullptr;
+    m_pBufData = nullptr;
+};
+
+bool CNP_IoUring::ProvideBuffers(unsigned short wGroup, unsigned nBuffers, unsigned cbBuffer,
+                                 bool bBufferRing) noexcept
+{
+    m_pBufData = static_cast<char*>(malloc(static_cast<size_t>(nBuffers) * cbBuffer));
+    if (m_pBufData == nullptr)
+    {
+        errno = ENOMEM;
+        return false;
+    }
+
+    m_nBuffers  = nBuffers;
+    m_cbBuffer  = cbBuffer;
+    m_wBufGroup = wGroup;
+
+    if (bBufferRing == false)
+    {
+        io_uring_sqe* pSqe = GetSQE();
+        if (pSqe == nullptr)
+            return false;
+
+        pSqe->opcode    = IORING_OP_PROVIDE_BUFFERS;
+        pSqe->fd        = static_cast<int>(nBuffers);
+        pSqe->addr      = reinterpret_cast<__u64>(m_pBufData);
+        pSqe->len       = cbBuffer;
+        pSqe->off       = 0;
+        pSqe->buf_group = wGroup;
+
+        if (Submit(1) == -1)
+            return false;
+
+        io_uring_cqe* pCqe = PeekCQE();
+        if (pCqe == nullptr)
+        {
+            errno = EIO;
+            return false;
+        }
+
+        int iResult = pCqe->res;
+        SeenCQE();
+
+        if (iResult < 0)
+        {
+            errno = -iResult;
+            return false;
+        }
+        return true;
+    }
+
+    // the buffer ring must be page aligned & a power of 2 in length
+    size_t cbBufRing = nBuffers * sizeof(io_uring_buf);
+    void*  pBufRing  = ::mmap(nullptr, cbBufRing, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (pBufRing == MAP_FAILED)
+        return false;
+
+    m_pBufRing  = static_cast<io_uring_buf_ring*>(pBufRing);
+    m_cbBufRing = cbBufRing;
+
+    io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr    = reinterpret_cast<__u64>(m_pBufRing);
+    reg.ring_entries = nBuffers;
+    reg.bgid         = wGroup;
+
+    if (io_uring_register(m_hRing, IORING_REGISTER_PBUF_RING, &reg, 1) == -1)
+        return false;
+
+    for (unsigned i = 0; i < nBuffers; i++)
+    {
+        io_uring_buf& buf = m_pBufRing->bufs[i];
+        buf.addr = reinterpret_cast<__u64>(get_Buffer(static_cast<unsigned short>(i)));
+        buf.len  = cbBuffer;
+        buf.bid  = static_cast<__u16>(i);
+    }
+    __atomic_store_n(&m_pBufRing->tail, static_cast<__u16>(nBuffers), __ATOMIC_RELEASE);
+
+    return true;
+};
+
+void CNP_IoUring::RecycleBuffer(unsigned short wBufferID) noexcept
+{
+    if (m_pBufRing == nullptr)
+    {
+        io_uring_sqe* pSqe = GetSQE();
+        if (pSqe == nullptr)
+            return;
+
+        pSqe->opcode    = IORING_OP_PROVIDE_BUFFERS;
+        pSqe->fd        = 1;
+        pSqe->addr      = reinterpret_cast<__u64>(get_Buffer(wBufferID));
+        pSqe->len       = m_cbBuffer;
+        pSqe->off       = wBufferID;
+        pSqe->buf_group = m_wBufGroup;
+        if (m_uFeatures & IORING_FEAT_CQE_SKIP)
+            pSqe->flags = IOSQE_CQE_SKIP_SUCCESS;
+        return;
+    }
+
+    __u16         wTail = m_pBufRing->tail;
+    io_uring_buf& buf   = m_pBufRing->bufs[wTail & (m_nBuffers - 1)];
+
+    buf.addr = reinterpret_cast<__u64>(get_Buffer(wBufferID));
+    buf.len  = m_cbBuffer;
+    buf.bid  = wBufferID;
+
+    __atomic_store_n(&m_pBufRing->tail, static_cast<__u16>(wTail + 1), __ATOMIC_RELEASE);
+};
+
+unsigned CNP_IoUring::get_SqSpace(void) const noexcept
+{
+    return m_nSqEntries - (m_uSqTail - LoadAcquire(m_pSqHead));
+};
+
+io_uring_sqe* CNP_IoUring::GetSQE(void) noexcept
+{
+    if (get_SqSpace() == 0)
+    {
+        if (Submit() == -1 || get_SqSpace() == 0)
+            return nullptr;
+    }
+
+    io_uring_sqe* pSqe = &m_pSqes[m_uSqTail & m_uSqMask];
+    m_uSqTail++;
+
+    memset(pSqe, 0, sizeof(*pSqe));
+    return pSqe;
+};
+
+int CNP_IoUring::Submit(unsigned nWaitFor /* = 0 */) noexcept
+{
+    unsigned nSubmit = m_uSqTail - m_uSqSubmitted;
+
+    StoreRelease(m_pSqTail, m_uSqTail);
+    m_uSqSubmitted = m_uSqTail;
+
+    unsigned uFlags = (nWaitFor > 0) ? IORING_ENTER_GETEVENTS : 0;
+
+    if (nSubmit == 0 && uFlags == 0)
+        return 0;
+
+    return io_uring_enter(m_hRing, nSubmit, nWaitFor, uFlags);
+};
+
+io_uring_cqe* CNP_IoUring::PeekCQE(void) noexcept
+{
+    unsigned uHead = *m_pCqHead;
+
+    if (uHead == LoadAcquire(m_pCqTail))
+        return nullptr;
+
+    return &m_pCqes[uHead & m_uCqMask];
+};
+
+void CNP_IoUring::SeenCQE(void) noexcept
+{
+    StoreRelease(m_pCqHead, *m_pCqHead + 1);
+};
+
+bool CNP_IoUring::ProbeOps(const unsigned char* rgOps, size_t nOps) noexcept
+{
+    const unsigned nProbeOps = 256;
+    size_t         cbProbe   = sizeof(io_uring_probe) + nProbeOps * sizeof(io_uring_probe_op);
+
+    io_uring_probe* pProbe = static_cast<io_uring_probe*>(calloc(1, cbProbe));
+    if (pProbe == nullptr)
+        return false;
+
+    bool bResult = (io_uring_register(m_hRing, IORING_REGISTER_PROBE, pProbe, nProbeOps) != -1);
+
+    for (size_t i = 0; bResult && i < nOps; i++)
+    {
+        bResult = (rgOps[i] <= pProbe->last_op) &&
+                  (pProbe->ops[rgOps[i]].flags & IO_URING_OP_SUPPORTED);
+    }
+
+    free(pProbe);
+    return bResult;
+};
+
+#endif  // __linux__
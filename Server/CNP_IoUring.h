@@ -0,0 +1,174 @@
+/**
+ * @file   CNP_IoUring.h
+ * @brief  CNP_IoUring class interface
+ *
+ * CNP_IoUring is a thin wrapper around a Linux io_uring instance,
+ * implemented directly on top of the io_uring_setup, io_uring_enter &
+ * io_uring_register system calls.  It maps the submission & completion
+ * queues, hands out submission queue entries & manages a pool of
+ * kernel-selected ("provided") receive buffers.  The buffers are handed
+ * to the kernel through a registered buffer ring, or on kernels where
+ * that is unavailable, with IORING_OP_PROVIDE_BUFFERS requests.
+ *
+ * A CNP_IoUring instance is not thread safe, it is meant to be driven
+ * by the single event loop thread that owns it.
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#if !defined(__CNP_IO_URING_H__)
+#define __CNP_IO_URING_H__
+
+#ifdef __linux__
+
+#include <stddef.h>
+#include <linux/io_uring.h>
+
+class CNP_IoUring
+{
+    int                 m_hRing;
+
+    // submission queue
+    unsigned*           m_pSqHead;
+    unsigned*           m_pSqTail;
+    unsigned*           m_pSqArray;
+    unsigned            m_uSqMask;
+    unsigned            m_nSqEntries;
+    unsigned            m_uSqTail;      ///< local tail, including entries not yet published
+    unsigned            m_uSqSubmitted; ///< tail last published to the kernel
+    io_uring_sqe*       m_pSqes;
+
+    // completion queue
+    unsigned*           m_pCqHead;
+    unsigned*           m_pCqTail;
+    unsigned            m_uCqMask;
+    io_uring_cqe*       m_pCqes;
+
+    void*               m_pSqRing;
+    size_t              m_cbSqRing;
+    void*               m_pCqRing;
+    size_t              m_cbCqRing;
+    size_t              m_cbSqes;
+    unsigned            m_uFeatures;    ///< IORING_FEAT_* reported by io_uring_setup
+
+    // provided buffers, m_pBufRing is null when provided by request
+    io_uring_buf_ring*  m_pBufRing;
+    size_t              m_cbBufRing;
+    char*               m_pBufData;
+    unsigned            m_nBuffers;
+    unsigned            m_cbBuffer;
+    unsigned short      m_wBufGroup;
+
+public:
+    /// Default Constructor
+    CNP_IoUring(void) noexcept;
+
+    ~CNP_IoUring();
+
+/**
+    @brief Creates the io_uring instance & maps its queues
+
+    @param [in] nEntries   submission queue size, rounded up by the kernel
+                           to a power of 2
+
+    @retval true  on success
+    @retval false on failure, errno holds the specific error code
+ */
+    bool   Create(unsigned nEntries) noexcept;
+
+/**
+    @brief Unmaps the queues & closes the io_uring instance
+ */
+    void   Close (void) noexcept;
+
+/**
+    @brief Provides nBuffers receive buffers of cbBuffer bytes each, from
+           which the kernel picks for IOSQE_BUFFER_SELECT requests in
+           buffer group wGroup
+
+    Must be called while no other requests are pending, since providing
+    the buffers by request waits for that request to complete.
+
+    @param [in] wGroup        buffer group ID
+    @param [in] nBuffers      number of buffers, a power of 2
+    @param [in] cbBuffer      size of each buffer
+    @param [in] bBufferRing   register a buffer ring, otherwise the buffers
+                              are provided with IORING_OP_PROVIDE_BUFFERS
+
+    @retval true  on success
+    @retval false on failure, errno holds the specific error code
+ */
+    bool   ProvideBuffers(unsigned short wGroup, unsigned nBuffers, unsigned cbBuffer,
+                          bool bBufferRing) noexcept;
+
+/**
+    @retval char* containing the address of provided buffer wBufferID
+ */
+    inline char* get_Buffer(unsigned short wBufferID) const noexcept
+    { return m_pBufData + static_cast<size_t>(wBufferID) * m_cbBuffer; };
+
+    inline unsigned short get_BufferGroup(void) const noexcept
+    { return m_wBufGroup; };
+
+/**
+    @brief Hands a provided buffer, consumed by a completion, back to the kernel
+
+    Without a buffer ring this queues a request, with user data of 0,
+    whose completion is only posted should it fail.
+ */
+    void   RecycleBuffer(unsigned short wBufferID) noexcept;
+
+/**
+    @retval unsigned containing the number of submission queue entries
+            that can be obtained before the queue has to be submitted
+ */
+    unsigned get_SqSpace(void) const noexcept;
+
+/**
+    @brief Obtains a zeroed submission queue entry, submitting the pending
+           entries first if the queue is full
+
+    @retval io_uring_sqe*  to be filled in by the caller
+    @retval nullptr        if the queue could not be drained
+ */
+    io_uring_sqe* GetSQE(void) noexcept;
+
+/**
+    @brief Submits all pending entries to the kernel, optionally waiting
+           for completions
+
+    @param [in] nWaitFor   minimum number of completions to wait for
+
+    @retval int containing the number of entries submitted, or -1 on
+            failure with errno holding the specific error code
+ */
+    int    Submit(unsigned nWaitFor = 0) noexcept;
+
+/**
+    @brief Retrieves the oldest unconsumed completion
+
+    @retval io_uring_cqe* to be released with SeenCQE()
+    @retval nullptr       if the completion queue is empty
+ */
+    io_uring_cqe* PeekCQE(void) noexcept;
+
+/**
+    @brief Releases the completion returned by PeekCQE()
+ */
+    void   SeenCQE(void) noexcept;
+
+/**
+    @retval true  if every opcode in rgOps is supported by the running kernel
+ */
+    bool   ProbeOps(const unsigned char* rgOps, size_t nOps) noexcept;
+
+private:
+    CNP_IoUring(const CNP_IoUring&);
+    CNP_IoUring& operator=(const CNP_IoUring&);
+};
+
+#endif  // __linux__
+
+#endif
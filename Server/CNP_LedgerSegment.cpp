@@ -0,0 +1,310 @@
+/**
+ * @file   CNP_LedgerSegment.cpp
+ * @brief  CNP_LedgerSegment class implementation
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+
+#ifdef __linux__
+    #include <sys/stat.h>
+    #include <unistd.h>
+#elif _MSC_VER
+    #include <io.h>
+    #include <sys/stat.h>
+#endif
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+
+#include "CNP_LedgerSegment.h"
+
+/// postings read per cache access while scanning a customer's list
+static const size_t POSTING_BATCH = 256;
+
+
+CNP_LedgerSegment::CNP_LedgerSegment(void) noexcept
+    : m_strFileName(),
+      m_hFile(-1),
+      m_Hdr(),
+      m_vecCustomers(),
+      m_pCache(nullptr)
+{ };
+
+CNP_LedgerSegment::~CNP_LedgerSegment()
+{
+    Close();
+};
+
+bool CNP_LedgerSegment::Create(const char* szFileName, const std::vector<TRANSACTION_INFO>& vecTransactions)
+{
+    if (vecTransactions.empty())
+        return false;
+
+    // 1. Group the transactions by customer
+    std::map<cnp::QWORD, LEDGER_SEGMENT_CUSTOMER>       mapCustomers;
+    std::map<cnp::QWORD, std::vector<LEDGER_SEGMENT_POSTING> > mapPostings;
+
+    for (size_t i = 0; i < vecTransactions.size(); i++)
+    {
+        const TRANSACTION_INFO& Transaction = vecTransactions[i];
+
+        LEDGER_SEGMENT_CUSTOMER& Customer = mapCustomers[Transaction.get_CustomerID()];
+        Customer.m_qwCustomerID = Transaction.get_CustomerID();
+
+        if (Transaction.get_Type() == cnp::TT_DEPOSIT)
+            Customer.m_llNetAmount += Transaction.get_Amount();
+        else
+            Customer.m_llNetAmount -= Transaction.get_Amount();
+
+        LEDGER_SEGMENT_POSTING Posting = { Transaction.get_ID(), static_cast<cnp::DWORD>(i) };
+        mapPostings[Transaction.get_CustomerID()].push_back(Posting);
+    }
+
+    // 2. Lay out the directory & posting list
+    std::vector<LEDGER_SEGMENT_CUSTOMER> vecCustomers;
+    std::vector<LEDGER_SEGMENT_POSTING>  vecPostings;
+
+    vecCustomers.reserve(mapCustomers.size());
+    vecPostings.reserve(vecTransactions.size());
+
+    for (auto& it : mapCustomers)
+    {
+        const auto& vecList = mapPostings[it.first];
+
+        it.second.m_qwFirstPosting = vecPostings.size();
+        it.second.m_qwPostings     = vecList.size();
+        vecCustomers.push_back(it.second);
+
+        vecPostings.insert(vecPostings.end(), vecList.begin(), vecList.end());
+    }
+
+    LEDGER_SEGMENT_HDR Hdr = { };
+    Hdr.m_dwMagic     = LEDGER_SEGMENT_MAGIC;
+    Hdr.m_dwVersion   = LEDGER_SEGMENT_VERSION;
+    Hdr.m_cbRecord    = sizeof(TRANSACTION_INFO);
+    Hdr.m_dwFirstID   = vecTransactions.front().get_ID();
+    Hdr.m_dwLastID    = vecTransactions.back().get_ID();
+    Hdr.m_qwRecords   = vecTransactions.size();
+    Hdr.m_qwCustomers = vecCustomers.size();
+    Hdr.m_qwPostings  = vecPostings.size();
+
+    // 3. Write each section in a single call
+    std::string strTemp = std::string(szFileName) + ".tmp";
+
+    std::ofstream ofs(strTemp, std::ios_base::binary | std::ios_base::trunc);
+    ofs.write(reinterpret_cast<const char*>( &Hdr ), sizeof(Hdr));
+    ofs.write(reinterpret_cast<const char*>( vecTransactions.data() ), vecTransactions.size() * sizeof(TRANSACTION_INFO));
+    ofs.write(reinterpret_cast<const char*>( vecCustomers.data() ),    vecCustomers.size()    * sizeof(LEDGER_SEGMENT_CUSTOMER));
+    ofs.write(reinterpret_cast<const char*>( vecPostings.data() ),     vecPostings.size()     * sizeof(LEDGER_SEGMENT_POSTING));
+    ofs.close();
+
+    bool bResult = !ofs.fail();
+
+    // 4. Sync it, a sealed transaction is dropped from memory once this returns
+    if (bResult)
+    {
+#ifdef __linux__
+        int hFile = ::open(strTemp.c_str(), O_RDONLY | O_CLOEXEC);
+        bResult   = (hFile != -1) && (::fsync(hFile) == 0);
+#elif _MSC_VER
+        int hFile = ::_open(strTemp.c_str(), _O_RDWR | _O_BINARY);
+        bResult   = (hFile != -1) && (::_commit(hFile) == 0);
+#endif
+        if (hFile != -1)
+        {
+#ifdef __linux__
+            ::close(hFile);
+#elif _MSC_VER
+            ::_close(hFile);
+#endif
+        }
+    }
+
+    std::error_code ec;
+    if (bResult)
+    {
+        std::filesystem::rename(strTemp, szFileName, ec);
+        bResult = !ec;
+    }
+
+    if (bResult == false)
+    {
+        std::cerr << "failed to create ledger segment:" << szFileName << ", Error:" << errno << std::endl;
+        ::remove(strTemp.c_str());
+        return false;
+    }
+
+#ifdef __linux__
+    std::string strDir = std::filesystem::path(szFileName).parent_path().string();
+
+    int hDir = ::open(strDir.empty() ? "." : strDir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (hDir != -1)
+    {
+        ::fsync(hDir);
+        ::close(hDir);
+    }
+#endif
+
+    return true;
+};
+
+bool CNP_LedgerSegment::Open(const char* szFileName, CNP_BlockCache* pCache)
+{
+    Close();
+
+    m_strFileName = szFileName;
+    m_pCache      = pCache;
+
+    std::ifstream ifs(szFileName, std::ios_base::binary);
+    if (!ifs.read(reinterpret_cast<char*>( &m_Hdr ), sizeof(m_Hdr)))
+    {
+        std::cerr << "failed to read ledger segment:" << szFileName << std::endl;
+        return false;
+    }
+
+    if (m_Hdr.m_dwMagic != LEDGER_SEGMENT_MAGIC || m_Hdr.m_dwVersion != LEDGER_SEGMENT_VERSION ||
+        m_Hdr.m_cbRecord != sizeof(TRANSACTION_INFO))
+    {
+        std::cerr << "ledger segment " << szFileName << " has an unsupported layout" << std::endl;
+        return false;
+    }
+
+    cnp::QWORD cbExpected = sizeof(m_Hdr) + m_Hdr.m_qwRecords   * sizeof(TRANSACTION_INFO)
+                                          + m_Hdr.m_qwCustomers * sizeof(LEDGER_SEGMENT_CUSTOMER)
+                                          + m_Hdr.m_qwPostings  * sizeof(LEDGER_SEGMENT_POSTING);
+
+    std::error_code ec;
+    if (std::filesystem::file_size(szFileName, ec) != cbExpected || ec)
+    {
+        std::cerr << "ledger segment " << szFileName << " is truncated" << std::endl;
+        return false;
+    }
+
+    // only the directory is kept in memory
+    m_vecCustomers.resize(static_cast<size_t>(m_Hdr.m_qwCustomers));
+
+    ifs.seekg(sizeof(m_Hdr) + m_Hdr.m_qwRecords * sizeof(TRANSACTION_INFO));
+    if (!ifs.read(reinterpret_cast<char*>( m_vecCustomers.data() ), m_vecCustomers.size() * sizeof(LEDGER_SEGMENT_CUSTOMER)))
+    {
+        std::cerr << "failed to read ledger segment directory:" << szFileName << std::endl;
+        m_vecCustomers.clear();
+        return false;
+    }
+
+    ifs.close();
+
+#ifdef __linux__
+    m_hFile = ::open(szFileName, O_RDONLY | O_CLOEXEC);
+#elif _MSC_VER
+    m_hFile = ::_open(szFileName, _O_RDONLY | _O_BINARY);
+#endif
+
+    if (m_hFile == -1)
+    {
+        std::cerr << "failed to open ledger segment:" << szFileName << ", Error:" << errno << std::endl;
+        m_vecCustomers.clear();
+        return false;
+    }
+
+    return true;
+};
+
+void CNP_LedgerSegment::Close(void) noexcept
+{
+    if (m_hFile != -1)
+    {
+        if (m_pCache)
+            m_pCache->Evict(get_CacheKey());
+#ifdef __linux__
+        ::close(m_hFile);
+#elif _MSC_VER
+        ::_close(m_hFile);
+#endif
+        m_hFile = -1;
+    }
+
+    m_vecCustomers.clear();
+};
+
+bool CNP_LedgerSegment::ReadPostings(cnp::QWORD qwFirst, size_t nCount, LEDGER_SEGMENT_POSTING* pPostings)
+{
+    cnp::QWORD qwOffset = sizeof(m_Hdr) + m_Hdr.m_qwRecords   * sizeof(TRANSACTION_INFO)
+                                        + m_Hdr.m_qwCustomers * sizeof(LEDGER_SEGMENT_CUSTOMER)
+                                        + qwFirst             * sizeof(LEDGER_SEGMENT_POSTING);
+
+    return m_pCache->Read(m_hFile, get_CacheKey(), qwOffset, pPostings, nCount * sizeof(LEDGER_SEGMENT_POSTING));
+};
+
+size_t CNP_LedgerSegment::Query(const cnp::QWORD& qwCustomerID, cnp::DWORD dwStartID, size_t nMax,
+                                std::vector<cnp::TRANSACTION>& vecTransactions)
+{
+    if (m_hFile == -1 || nMax == 0 || m_Hdr.m_dwLastID < dwStartID)
+        return 0;
+
+// 1. Find the customer in the directory
+    auto itC = std::lower_bound(m_vecCustomers.begin(), m_vecCustomers.end(), qwCustomerID,
+                                [](const LEDGER_SEGMENT_CUSTOMER& Customer, const cnp::QWORD& qwID)
+                                { return Customer.m_qwCustomerID < qwID; });
+
+    if (itC == m_vecCustomers.end() || itC->m_qwCustomerID != qwCustomerID)
+        return 0;
+
+// 2. Binary search the posting list for the first ID >= dwStartID
+    cnp::QWORD qwLow  = 0;
+    cnp::QWORD qwHigh = itC->m_qwPostings;
+
+    while (qwLow < qwHigh)
+    {
+        cnp::QWORD              qwMid = qwLow + (qwHigh - qwLow) / 2;
+        LEDGER_SEGMENT_POSTING  Posting;
+
+        if (ReadPostings(itC->m_qwFirstPosting + qwMid, 1, &Posting) == false)
+            return 0;
+
+        if (Posting.m_dwID < dwStartID)
+            qwLow  = qwMid + 1;
+        else
+            qwHigh = qwMid;
+    }
+
+// 3. Read the transactions the postings refer to
+    size_t                  nResult = 0;
+    LEDGER_SEGMENT_POSTING  rgPostings[POSTING_BATCH];
+
+    while (qwLow < itC->m_qwPostings && nResult < nMax)
+    {
+        size_t nBatch = static_cast<size_t>(itC->m_qwPostings - qwLow);
+        if (nBatch > nMax - nResult)
+            nBatch = nMax - nResult;
+        if (nBatch > POSTING_BATCH)
+            nBatch = POSTING_BATCH;
+
+        if (ReadPostings(itC->m_qwFirstPosting + qwLow, nBatch, rgPostings) == false)
+            break;
+
+        for (size_t i = 0; i < nBatch; i++)
+        {
+            TRANSACTION_INFO Transaction;
+            cnp::QWORD       qwOffset = sizeof(m_Hdr) + static_cast<cnp::QWORD>(rgPostings[i].m_dwRecord) * sizeof(TRANSACTION_INFO);
+
+            if (m_pCache->Read(m_hFile, get_CacheKey(), qwOffset, &Transaction, sizeof(Transaction)) == false)
+                return nResult;
+
+            vecTransactions.push_back(Transaction);
+            nResult++;
+        }
+
+        qwLow += nBatch;
+    }
+
+    return nResult;
+};
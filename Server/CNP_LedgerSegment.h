@@ -0,0 +1,164 @@
+/**
+ * @file   CNP_LedgerSegment.h
+ * @brief  CNP_LedgerSegment class interface
+ *
+ * CNP_LedgerSegment is an immutable file of sealed transactions, those
+ * that have aged out of the in-memory transaction table.  Besides the
+ * transactions, in ID order, it holds an index by customer: a directory
+ * sorted by customer ID, kept in memory while the segment is open, &
+ * a posting list of each customer's transactions, read on demand.
+ *
+ *   LEDGER_SEGMENT_HDR
+ *   TRANSACTION_INFO         [m_qwRecords]     in ascending ID order
+ *   LEDGER_SEGMENT_CUSTOMER  [m_qwCustomers]   in ascending customer ID order
+ *   LEDGER_SEGMENT_POSTING   [m_qwPostings]    grouped by customer, ascending ID
+ *
+ * Transactions & postings are only ever read through a CNP_BlockCache,
+ * so the memory a segment uses is bounded by its directory.
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#if !defined(__CNP_LEDGER_SEGMENT_H__)
+#define __CNP_LEDGER_SEGMENT_H__
+
+#ifndef __CNP_SERVER_DB_H__
+    #include "CNP_ServerDB.h"
+#endif
+
+#ifndef __CNP_BLOCK_CACHE_H__
+    #include "CNP_BlockCache.h"
+#endif
+
+#ifndef _STRING_
+    #include <string>
+#endif
+
+#ifndef _VECTOR_
+    #include <vector>
+#endif
+
+/// identifies a ledger segment file, "CNPL" in file order
+const cnp::DWORD LEDGER_SEGMENT_MAGIC   = 0x4C504E43;
+/// layout version of a ledger segment file
+const cnp::DWORD LEDGER_SEGMENT_VERSION = 1;
+
+struct LEDGER_SEGMENT_HDR
+{
+    cnp::DWORD  m_dwMagic;       ///< LEDGER_SEGMENT_MAGIC
+    cnp::DWORD  m_dwVersion;     ///< LEDGER_SEGMENT_VERSION
+    cnp::DWORD  m_cbRecord;      ///< sizeof(TRANSACTION_INFO)
+    cnp::DWORD  m_dwFirstID;     ///< lowest transaction ID held
+    cnp::DWORD  m_dwLastID;      ///< highest transaction ID held
+    cnp::QWORD  m_qwRecords;
+    cnp::QWORD  m_qwCustomers;
+    cnp::QWORD  m_qwPostings;
+};
+
+/// a customer's entry in a segment's directory
+struct LEDGER_SEGMENT_CUSTOMER
+{
+    cnp::QWORD  m_qwCustomerID;
+    cnp::QWORD  m_qwFirstPosting;   ///< index of the customer's first posting
+    cnp::QWORD  m_qwPostings;       ///< number of the customer's transactions
+    long long   m_llNetAmount;      ///< deposits less withdrawals & purchases
+};
+
+/// a customer's transaction, in a segment's posting list
+struct LEDGER_SEGMENT_POSTING
+{
+    cnp::DWORD  m_dwID;             ///< transaction ID
+    cnp::DWORD  m_dwRecord;         ///< index of the transaction in the segment
+};
+
+class CNP_LedgerSegment
+{
+    std::string                           m_strFileName;
+    int                                   m_hFile;
+    LEDGER_SEGMENT_HDR                    m_Hdr;
+    std::vector<LEDGER_SEGMENT_CUSTOMER>  m_vecCustomers;
+    CNP_BlockCache*                       m_pCache;
+
+public:
+    /// Default Constructor
+    CNP_LedgerSegment(void) noexcept;
+
+    ~CNP_LedgerSegment();
+
+/**
+    @brief Writes a new segment file, through a temporary file renamed
+           into place once synced
+
+    @param [in] szFileName       address of the NULL terminated string that
+                                 contains the name of the file to create
+    @param [in] vecTransactions  transactions to seal, in ascending ID order
+
+    @retval true  on success
+    @retval false on failure
+ */
+    static bool  Create(const char* szFileName, const std::vector<TRANSACTION_INFO>& vecTransactions);
+
+/**
+    @brief Opens a segment file & reads its directory
+
+    @param [in] szFileName   address of the NULL terminated string that
+                             contains the name of the file to open
+    @param [in] pCache       cache to read the transactions & postings through
+
+    @retval true  on success
+    @retval false if the file is missing, truncated or of another layout
+ */
+    bool         Open (const char* szFileName, CNP_BlockCache* pCache);
+
+    void         Close(void) noexcept;
+
+/**
+    @brief Retrieves a customer's transactions
+
+    @param [in]  qwCustomerID      customer whose transactions to retrieve
+    @param [in]  dwStartID         lowest transaction ID to retrieve
+    @param [in]  nMax              most transactions to retrieve
+    @param [out] vecTransactions   receives the transactions, in ID order
+
+    @retval size_t containing the number of transactions appended
+ */
+    size_t       Query(const cnp::QWORD& qwCustomerID, cnp::DWORD dwStartID, size_t nMax,
+                       std::vector<cnp::TRANSACTION>& vecTransactions);
+
+/**
+    @brief Invokes fnVisit(const LEDGER_SEGMENT_CUSTOMER&) for each
+           customer of the segment
+ */
+    template <class _Fn>
+    void         ForEachCustomer(_Fn fnVisit) const
+    {
+        for (const auto& it : m_vecCustomers)
+            fnVisit(it);
+    };
+
+    inline cnp::DWORD  get_FirstID(void) const noexcept
+    { return m_Hdr.m_dwFirstID; };
+
+    inline cnp::DWORD  get_LastID(void) const noexcept
+    { return m_Hdr.m_dwLastID; };
+
+    inline size_t      get_Count(void) const noexcept
+    { return static_cast<size_t>(m_Hdr.m_qwRecords); };
+
+    inline const std::string& get_FileName(void) const noexcept
+    { return m_strFileName; };
+
+private:
+    /// key of the segment's blocks in the cache, its first ID being unique
+    inline cnp::QWORD  get_CacheKey(void) const noexcept
+    { return m_Hdr.m_dwFirstID; };
+
+    bool         ReadPostings(cnp::QWORD qwFirst, size_t nCount, LEDGER_SEGMENT_POSTING* pPostings);
+
+    CNP_LedgerSegment(const CNP_LedgerSegment&);
+    CNP_LedgerSegment& operator=(const CNP_LedgerSegment&);
+};
+
+#endif
@@ -0,0 +1,261 @@
+/**
+ * @file   CNP_Logger.cpp
+ * @brief  CNP_Logger class implementation
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#include <string.h>
+#include <time.h>
+
+#include <algorithm>
+#include <chrono>
+#include <new>
+
+#include "CNP_Server.h"
+#include "CNP_Logger.h"
+
+/// Global CNP_Logger instance
+CNP_Logger                                  g_Logger;
+
+/**
+    RING_HOLDER holds the ring a thread logs into, handing it back for
+    reuse once the thread ends.  Records still pending in it are written
+    out all the same.
+ */
+struct RING_HOLDER
+{
+    CNP_Logger*        m_pOwner;
+    CNP_Logger::RING*  m_pRing;
+
+    ~RING_HOLDER()
+    {
+        Detach();
+    };
+
+    void Detach(void) noexcept
+    {
+        if (m_pRing)
+            m_pRing->m_bInUse.store(false, std::memory_order_release);
+
+        m_pOwner = nullptr;
+        m_pRing  = nullptr;
+    };
+};
+
+static thread_local RING_HOLDER t_RingHolder = { nullptr, nullptr };
+
+
+CNP_Logger::CNP_Logger(void) noexcept
+    : m_iLevel(LL_INFO),
+      m_ulSample(1),
+      m_pStream(nullptr),
+      m_pThread(nullptr),
+      m_Mutex(),
+      m_cvTerminate(),
+      m_vecRings(),
+      m_bTerminate(false)
+{ };
+
+CNP_Logger::~CNP_Logger()
+{
+    Stop();
+};
+
+bool CNP_Logger::Start(FILE* pStream, int iLevel, unsigned long ulSample)
+{
+    if (m_pThread)
+        return false;
+
+    m_pStream    = pStream;
+    m_ulSample   = (ulSample == 0) ? 1 : ulSample;
+    m_bTerminate = false;
+    m_iLevel.store(iLevel, std::memory_order_relaxed);
+
+    m_pThread = new std::thread(&CNP_Logger::Run, this);
+    return true;
+};
+
+void CNP_Logger::Stop(void) noexcept
+{
+    if (m_pThread == nullptr)
+        return;
+
+    {
+        std::lock_guard<std::mutex> LogLock(m_Mutex);
+        m_bTerminate = true;
+    }
+    m_cvTerminate.notify_one();
+
+    m_pThread->join();
+    delete m_pThread;
+    m_pThread = nullptr;
+};
+
+void CNP_Logger::Write(int iLevel, bool bSampled, const char* szSource, const char* szFormat,
+                       const cnp::QWORD* rgArgs, size_t nArgs) noexcept
+{
+    RING_HOLDER& Holder = t_RingHolder;
+
+    if (Holder.m_pOwner != this)
+    {
+        Holder.Detach();
+        Holder.m_pRing  = Attach();
+        Holder.m_pOwner = this;
+    }
+
+    RING* pRing = Holder.m_pRing;
+    if (pRing == nullptr)
+        return;
+
+    if (bSampled && m_ulSample > 1 && (++pRing->m_ulSampleCount % m_ulSample) != 0)
+        return;
+
+    size_t nHead = pRing->m_nHead.load(std::memory_order_relaxed);
+
+    // never wait for the writer thread, the record is lost instead
+    if (nHead - pRing->m_nTail.load(std::memory_order_acquire) >= RING_SIZE)
+    {
+        pRing->m_nDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    LOG_RECORD& Record = pRing->m_rgRecords[nHead & (RING_SIZE - 1)];
+
+    Record.m_qwTimestamp = std::chrono::duration_cast<std::chrono::microseconds>(
+                               std::chrono::system_clock::now().time_since_epoch()).count();
+    Record.m_szSource    = szSource;
+    Record.m_szFormat    = szFormat;
+    Record.m_dwThreadID  = pRing->m_dwThreadID;
+    Record.m_iLevel      = iLevel;
+    memcpy(Record.m_rgArgs, rgArgs, nArgs * sizeof(cnp::QWORD));
+
+    pRing->m_nHead.store(nHead + 1, std::memory_order_release);
+};
+
+CNP_Logger::RING* CNP_Logger::Attach(void) noexcept
+{
+    std::lock_guard<std::mutex> LogLock(m_Mutex);
+
+    RING* pRing = nullptr;
+
+    for (auto& pFree : m_vecRings)
+    {
+        bool bInUse = false;
+        if (pFree->m_bInUse.compare_exchange_strong(bInUse, true, std::memory_order_acquire))
+        {
+            pRing = pFree.get();
+            break;
+        }
+    }
+
+    if (pRing == nullptr)
+    {
+        pRing = new (std::nothrow) RING();
+        if (pRing == nullptr)
+            return nullptr;
+
+        try
+        {
+            m_vecRings.emplace_back(pRing);
+        }
+        catch (...)
+        {
+            delete pRing;
+            return nullptr;
+        }
+
+        pRing->m_bInUse.store(true, std::memory_order_relaxed);
+    }
+
+    pRing->m_ulSampleCount = 0;
+    pRing->m_dwThreadID    = static_cast<cnp::DWORD>(GetThreadID());
+    return pRing;
+};
+
+void CNP_Logger::Run(void)
+{
+    std::vector<LOG_RECORD> vecBatch;
+    vecBatch.reserve(RING_SIZE);
+
+    bool bTerminate = false;
+
+    while (bTerminate == false)
+    {
+        {
+            std::unique_lock<std::mutex> LogLock(m_Mutex);
+            m_cvTerminate.wait_for(LogLock,
+                                   std::chrono::milliseconds(static_cast<unsigned long>(DRAIN_INTERVAL)),
+                                   [this] { return m_bTerminate; });
+            bTerminate = m_bTerminate;
+        }
+
+        // the last pass, once terminating, catches every record logged before Stop()
+        Drain(vecBatch);
+    }
+};
+
+size_t CNP_Logger::Drain(std::vector<LOG_RECORD>& vecBatch)
+{
+    std::vector<RING*> vecRings;
+    {
+        std::lock_guard<std::mutex> LogLock(m_Mutex);
+        for (auto& pRing : m_vecRings)
+            vecRings.push_back(pRing.get());
+    }
+
+    vecBatch.clear();
+    size_t nDropped = 0;
+
+    for (RING* pRing : vecRings)
+    {
+        size_t nHead = pRing->m_nHead.load(std::memory_order_acquire);
+        size_t nTail = pRing->m_nTail.load(std::memory_order_relaxed);
+
+        for ( ; nTail != nHead; nTail++)
+            vecBatch.push_back(pRing->m_rgRecords[nTail & (RING_SIZE - 1)]);
+
+        pRing->m_nTail.store(nTail, std::memory_order_release);
+        nDropped += pRing->m_nDropped.exchange(0, std::memory_order_relaxed);
+    }
+
+    // each ring is in order, interleave them back into a single timeline
+    std::stable_sort(vecBatch.begin(), vecBatch.end(),
+                     [](const LOG_RECORD& lhs, const LOG_RECORD& rhs)
+                     { return lhs.m_qwTimestamp < rhs.m_qwTimestamp; });
+
+    for (const auto& Record : vecBatch)
+    {
+        time_t tmSeconds = static_cast<time_t>(Record.m_qwTimestamp / 1000000);
+        struct tm tmLocal;
+
+#ifdef __linux__
+        localtime_r(&tmSeconds, &tmLocal);
+#elif _MSC_VER
+        localtime_s(&tmLocal, &tmSeconds);
+#endif
+
+        fprintf(m_pStream, "%02d:%02d:%02d.%06llu [%5lu] %s ",
+                tmLocal.tm_hour, tmLocal.tm_min, tmLocal.tm_sec,
+                static_cast<unsigned long long>(Record.m_qwTimestamp % 1000000),
+                static_cast<unsigned long>(Record.m_dwThreadID), Record.m_szSource);
+
+        fprintf(m_pStream, Record.m_szFormat,
+                static_cast<unsigned long long>(Record.m_rgArgs[0]),
+                static_cast<unsigned long long>(Record.m_rgArgs[1]),
+                static_cast<unsigned long long>(Record.m_rgArgs[2]),
+                static_cast<unsigned long long>(Record.m_rgArgs[3]));
+
+        fputc('\n', m_pStream);
+    }
+
+    if (nDropped > 0)
+        fprintf(m_pStream, "logger dropped %zu record(s), the rings being full\n", nDropped);
+
+    if (vecBatch.empty() == false || nDropped > 0)
+        fflush(m_pStream);
+
+    return vecBatch.size();
+};
@@ -0,0 +1,232 @@
+/**
+ * @file   CNP_Logger.h
+ * @brief  CNP_Logger class interface
+ *
+ * CNP_Logger is an asynchronous logger for the request paths, where a
+ * formatted & flushed std::cout line per request would serialize every
+ * thread on the stream's lock & a write() call.  A logging thread only
+ * copies a fixed size LOG_RECORD, holding the address of its static
+ * format string & up to MAX_ARGS integral arguments, into a ring buffer
+ * of its own; no lock is taken & nothing is formatted.  A background
+ * thread drains every ring, formats the records in timestamp order &
+ * writes them out with a single flush per pass.
+ *
+ * Records are dropped, & counted, rather than waited for should a
+ * thread's ring be full.  Request logging is sampled, only 1 in every
+ * get_Sample() requests of a thread being logged.
+ *
+ * Levels above CNP_LOG_MAX_LEVEL compile to nothing, those above the
+ * level passed to Start() cost a single comparison.
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#if !defined(__CNP_LOGGER_H__)
+#define __CNP_LOGGER_H__
+
+#ifndef __CNP_COMMON_H__
+    #include "CNP_Common.h"
+#endif
+
+#include <stdio.h>
+
+#ifndef _ATOMIC_
+    #include <atomic>
+#endif
+
+#ifndef _CONDITION_VARIABLE_
+    #include <condition_variable>
+#endif
+
+#ifndef _MEMORY_
+    #include <memory>
+#endif
+
+#ifndef _MUTEX_
+    #include <mutex>
+#endif
+
+#ifndef _THREAD_
+    #include <thread>
+#endif
+
+#ifndef _VECTOR_
+    #include <vector>
+#endif
+
+enum LOG_LEVEL
+{
+    LL_OFF   = 0,
+    LL_ERROR = 1,
+    LL_WARN  = 2,
+    LL_INFO  = 3,
+    LL_DEBUG = 4
+};
+
+/// most verbose level compiled in
+#ifndef CNP_LOG_MAX_LEVEL
+    #define CNP_LOG_MAX_LEVEL  3
+#endif
+
+/**
+    LOG_RECORD is a log line as captured by the logging thread, its
+    arguments yet to be formatted.
+ */
+struct LOG_RECORD
+{
+    static const size_t MAX_ARGS = 4;
+
+    cnp::QWORD   m_qwTimestamp;       ///< microseconds since the epoch
+    const char*  m_szSource;          ///< static name of the logging function
+    const char*  m_szFormat;          ///< static printf format of the arguments
+    cnp::QWORD   m_rgArgs[MAX_ARGS];
+    cnp::DWORD   m_dwThreadID;
+    int          m_iLevel;
+};
+
+class CNP_Logger
+{
+public:
+    /// records held by a thread's ring, a power of 2
+    static const size_t RING_SIZE     = 1024;
+    /// milliseconds the writer thread sleeps between passes
+    static const unsigned long DRAIN_INTERVAL = 20;
+
+private:
+    /// a single producer, single consumer ring of a logging thread
+    struct RING
+    {
+        alignas(64) std::atomic<size_t>  m_nHead;      ///< written by the logging thread
+        alignas(64) std::atomic<size_t>  m_nTail;      ///< written by the writer thread
+        std::atomic<size_t>  m_nDropped;
+        std::atomic<bool>    m_bInUse;                 ///< owned by a live thread
+        unsigned long        m_ulSampleCount;          ///< requests seen by the owning thread
+        cnp::DWORD           m_dwThreadID;
+        LOG_RECORD           m_rgRecords[RING_SIZE];
+    };
+
+    std::atomic<int>                    m_iLevel;
+    unsigned long                       m_ulSample;
+    FILE*                               m_pStream;
+    std::thread*                        m_pThread;
+    std::mutex                          m_Mutex;       ///< guards m_vecRings & m_bTerminate
+    std::condition_variable             m_cvTerminate;
+    std::vector<std::unique_ptr<RING>>  m_vecRings;    ///< only ever grows
+    bool                                m_bTerminate;
+
+public:
+    /// Default Constructor
+    CNP_Logger(void) noexcept;
+
+    ~CNP_Logger();
+
+/**
+    @brief Starts the writer thread
+
+    @param [in] pStream    stream the records are written to
+    @param [in] iLevel     most verbose LOG_LEVEL logged
+    @param [in] ulSample   1 in how many requests are logged
+
+    @retval true  on success
+    @retval false if already started
+ */
+    bool        Start (FILE* pStream, int iLevel, unsigned long ulSample);
+
+/**
+    @brief Writes out every pending record & stops the writer thread
+ */
+    void        Stop  (void) noexcept;
+
+    inline bool IsEnabled(int iLevel) const noexcept
+    { return iLevel <= m_iLevel.load(std::memory_order_relaxed); };
+
+    inline unsigned long get_Sample(void) const noexcept
+    { return m_ulSample; };
+
+/**
+    @brief Captures a record into the calling thread's ring
+
+    Each argument is widened to 64 bits, the format should therefore
+    only use ll conversions such as %llu or %4lld.
+
+    @param [in] iLevel     LOG_LEVEL of the record
+    @param [in] bSampled   the record is subject to request sampling
+    @param [in] szSource   static name of the logging function
+    @param [in] szFormat   static printf format of the arguments
+ */
+    template <class... _Args>
+    void        Log   (int iLevel, bool bSampled, const char* szSource,
+                       const char* szFormat, _Args... args) noexcept
+    {
+        static_assert(sizeof...(_Args) <= LOG_RECORD::MAX_ARGS, "too many log arguments");
+
+        const cnp::QWORD rgArgs[LOG_RECORD::MAX_ARGS + 1] = { static_cast<cnp::QWORD>(args)... };
+        Write(iLevel, bSampled, szSource, szFormat, rgArgs, sizeof...(_Args));
+    };
+
+private:
+    friend struct RING_HOLDER;
+
+    void        Write (int iLevel, bool bSampled, const char* szSource, const char* szFormat,
+                       const cnp::QWORD* rgArgs, size_t nArgs) noexcept;
+
+/**
+    @brief Gives the calling thread a ring, reusing one left by an
+           exited thread if possible
+
+    @retval RING* address of the ring, or nullptr if out of memory
+ */
+    RING*       Attach(void) noexcept;
+
+    void        Run   (void);
+
+/**
+    @brief Writes out every record pending in the rings
+
+    @retval size_t containing the number of records written
+ */
+    size_t      Drain (std::vector<LOG_RECORD>& vecBatch);
+
+    CNP_Logger(const CNP_Logger&);
+    CNP_Logger& operator=(const CNP_Logger&);
+};
+
+/// Global CNP_Logger instance
+extern CNP_Logger  g_Logger;
+
+#define CNP_LOG(iLevel, ...) \
+    do { if (g_Logger.IsEnabled(iLevel)) g_Logger.Log((iLevel), false, __FUNCTION__, __VA_ARGS__); } while (0)
+
+#define CNP_LOG_SAMPLED(iLevel, ...) \
+    do { if (g_Logger.IsEnabled(iLevel)) g_Logger.Log((iLevel), true, __FUNCTION__, __VA_ARGS__); } while (0)
+
+#if CNP_LOG_MAX_LEVEL >= 1
+    #define CNP_LOG_ERROR(...)    CNP_LOG(LL_ERROR, __VA_ARGS__)
+#else
+    #define CNP_LOG_ERROR(...)    ((void) 0)
+#endif
+
+#if CNP_LOG_MAX_LEVEL >= 2
+    #define CNP_LOG_WARN(...)     CNP_LOG(LL_WARN, __VA_ARGS__)
+#else
+    #define CNP_LOG_WARN(...)     ((void) 0)
+#endif
+
+#if CNP_LOG_MAX_LEVEL >= 3
+    #define CNP_LOG_INFO(...)     CNP_LOG(LL_INFO, __VA_ARGS__)
+    /// a request's log line, sampled
+    #define CNP_LOG_REQUEST(...)  CNP_LOG_SAMPLED(LL_INFO, __VA_ARGS__)
+#else
+    #define CNP_LOG_INFO(...)     ((void) 0)
+    #define CNP_LOG_REQUEST(...)  ((void) 0)
+#endif
+
+#if CNP_LOG_MAX_LEVEL >= 4
+    #define CNP_LOG_DEBUG(...)    CNP_LOG(LL_DEBUG, __VA_ARGS__)
+#else
+    #define CNP_LOG_DEBUG(...)    ((void) 0)
+#endif
+
+#endif
@@ -0,0 +1,144 @@
+/**
+ * @file   CNP_MappedFile.cpp
+ * @brief  CNP_MappedFile class implementation
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#include <errno.h>
+
+#ifdef __linux__
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#elif _MSC_VER
+    #include <windows.h>
+#endif
+
+#include <iostream>
+
+#include "CNP_MappedFile.h"
+
+
+CNP_MappedFile::CNP_MappedFile(void) noexcept
+    : m_pData(nullptr),
+      m_cbSize(0)
+#ifdef _MSC_VER
+      , m_hFile(INVALID_HANDLE_VALUE),
+      m_hMapping(NULL)
+#endif
+{ };
+
+CNP_MappedFile::~CNP_MappedFile()
+{
+    Close();
+};
+
+bool CNP_MappedFile::Open(const char* szFileName)
+{
+    Close();
+
+#ifdef __linux__
+    int hFile = ::open(szFileName, O_RDONLY | O_CLOEXEC);
+    if (hFile == -1)
+    {
+        if (errno != ENOENT)
+            std::cerr << "failed to open " << szFileName << ", Error:" << errno << std::endl;
+        return false;
+    }
+
+    struct stat Stat;
+    if (::fstat(hFile, &Stat) != 0)
+    {
+        std::cerr << "failed to stat " << szFileName << ", Error:" << errno << std::endl;
+        ::close(hFile);
+        return false;
+    }
+
+    m_cbSize = static_cast<size_t>(Stat.st_size);
+
+    if (m_cbSize > 0)
+    {
+        void* pData = ::mmap(nullptr, m_cbSize, PROT_READ, MAP_PRIVATE, hFile, 0);
+        if (pData == MAP_FAILED)
+        {
+            std::cerr << "failed to map " << szFileName << ", Error:" << errno << std::endl;
+            m_cbSize = 0;
+            ::close(hFile);
+            return false;
+        }
+
+        // the records are read front to back, so read ahead aggressively
+        ::madvise(pData, m_cbSize, MADV_SEQUENTIAL);
+        ::madvise(pData, m_cbSize, MADV_WILLNEED);
+        m_pData = static_cast<const char*>(pData);
+    }
+
+    // the mapping outlives the descriptor
+    ::close(hFile);
+#elif _MSC_VER
+    m_hFile = ::CreateFileA(szFileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                            FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (m_hFile == INVALID_HANDLE_VALUE)
+    {
+        if (::GetLastError() != ERROR_FILE_NOT_FOUND)
+            std::cerr << "failed to open " << szFileName << ", Error:" << ::GetLastError() << std::endl;
+        return false;
+    }
+
+    LARGE_INTEGER liSize;
+    if (::GetFileSizeEx(m_hFile, &liSize) == FALSE)
+    {
+        std::cerr << "failed to size " << szFileName << ", Error:" << ::GetLastError() << std::endl;
+        Close();
+        return false;
+    }
+
+    m_cbSize = static_cast<size_t>(liSize.QuadPart);
+
+    if (m_cbSize > 0)
+    {
+        m_hMapping = ::CreateFileMappingA(m_hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (m_hMapping != NULL)
+            m_pData = static_cast<const char*>(::MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0));
+
+        if (m_pData == nullptr)
+        {
+            std::cerr << "failed to map " << szFileName << ", Error:" << ::GetLastError() << std::endl;
+            Close();
+            return false;
+        }
+    }
+#endif
+
+    return true;
+};
+
+void CNP_MappedFile::Close(void) noexcept
+{
+#ifdef __linux__
+    if (m_pData)
+        ::munmap(const_cast<char*>(m_pData), m_cbSize);
+#elif _MSC_VER
+    if (m_pData)
+        ::UnmapViewOfFile(const_cast<char*>(m_pData));
+
+    if (m_hMapping != NULL)
+    {
+        ::CloseHandle(m_hMapping);
+        m_hMapping = NULL;
+    }
+
+    if (m_hFile != INVALID_HANDLE_VALUE)
+    {
+        ::CloseHandle(m_hFile);
+        m_hFile = INVALID_HANDLE_VALUE;
+    }
+#endif
+
+    m_pData  = nullptr;
+    m_cbSize = 0;
+};
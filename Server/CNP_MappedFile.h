@@ -0,0 +1,62 @@
+/**
+ * @file   CNP_MappedFile.h
+ * @brief  CNP_MappedFile class interface
+ *
+ * CNP_MappedFile maps a whole file read-only into memory, so that its
+ * records can be read in place rather than copied through a stream.
+ * The pages are only read in as they are first touched, & the kernel
+ * is told that they will be read sequentially.
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#if !defined(__CNP_MAPPED_FILE_H__)
+#define __CNP_MAPPED_FILE_H__
+
+#include <stddef.h>
+
+class CNP_MappedFile
+{
+    const char*  m_pData;
+    size_t       m_cbSize;
+#ifdef _MSC_VER
+    void*        m_hFile;      ///< HANDLE, kept opaque so that windows.h stays out of the header
+    void*        m_hMapping;
+#endif
+
+public:
+    /// Default Constructor
+    CNP_MappedFile(void) noexcept;
+
+    ~CNP_MappedFile();
+
+/**
+    @brief Maps a file into memory, any previous mapping is released
+
+    @param [in] szFileName   address of the NULL terminated string that
+                             contains the name of the file to map
+
+    @retval true  on success, an empty file maps to no data
+    @retval false on failure
+ */
+    bool   Open (const char* szFileName);
+
+/**
+    @brief Releases the mapping
+ */
+    void   Close(void) noexcept;
+
+    inline const char* get_Data(void) const noexcept
+    { return m_pData; };
+
+    inline size_t      get_Size(void) const noexcept
+    { return m_cbSize; };
+
+private:
+    CNP_MappedFile(const CNP_MappedFile&);
+    CNP_MappedFile& operator=(const CNP_MappedFile&);
+};
+
+#endif
@@ -7,36 +7,33 @@
  * 
  */
 
+#include <algorithm>
 #include <chrono>
 #include <vector>
-#include <iostream>
-#include <iomanip>
 #include <mutex>
 
 #include "CNP_ServerDB.h"
-#include "CNP_Session.h"
+#include "CNP_AccountStore.h"
+#include "CNP_TransactionLedger.h"
+#include "CNP_SessionTable.h"
+#include "CNP_ClientIdAllocator.h"
+#include "CNP_Logger.h"
+#include "CNP_Connection.h"
 #include "CNP_Messaging.h"
 
 
-extern SessionMap_t                         g_SessionInfo;
-std::mutex                                  g_SessionMutex; 
+extern CNP_SessionTable                     g_SessionTable;
+extern CNP_ClientIdAllocator                g_ClientIdAllocator;
 
-extern AccountMap_t                         g_AccountInfo;
-std::mutex                                  g_AccountMutex;
+extern CNP_AccountStore                     g_AccountInfo;
 
-extern TransactionMap_t                     g_TransactionInfo;
+extern CNP_TransactionLedger                g_TransactionLedger;
+extern CustomerTransactionIndex_t           g_CustomerTransactions;
+/// guards g_CustomerTransactions, the ledger itself needs no lock
 std::mutex                                  g_TransactionMutex;
 
+extern CNP_WriteAheadLog                    g_ServerLog;
 
-#ifdef __linux__
-
-pid_t GetThreadID( void );
-
-#elif _MSC_VER
-
-DWORD GetThreadID( void );
-
-#endif
 
 /*
 struct SERVER_RESPONSE
@@ -113,16 +110,139 @@ struct SERVER_RESPONSE
 
 
 
-cnp::WORD ProcessConnectRequest(const void* pMsg, size_t cbMsgLen, CNP_Socket* pSocket)
+/**
+    Generates a new transaction & logs it, then once it is committed
+    publishes it to the transaction ledger & adds it to the customer's
+    index entry
+
+    Called under the account's lock, by the balance change it records.
+
+    @param [in] qwCustomerID  customer the transaction belongs to
+    @param [in] dwAmount      transaction amount
+    @param [in] wType         cnp::TT_DEPOSIT, cnp::TT_WITHDRAWAL or cnp::TT_STAMP_PURCHASE
+
+    @retval cnp::CER_TYPE containing cnp::CER_SUCCESS, or cnp::CER_ERROR if
+            the log failed before the transaction could be committed, the
+            transaction then being dropped
+ */
+static cnp::CER_TYPE RecordTransaction(const cnp::QWORD& qwCustomerID, cnp::DWORD dwAmount, cnp::WORD wType)
+{
+    cnp::QWORD qwNow   = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    cnp::DWORD dwNewID = g_TransactionLedger.Reserve();
+
+    TRANSACTION_INFO newTrans(dwNewID,
+                              qwNow,
+                              dwAmount,
+                              wType,
+                              qwCustomerID);
+
+    // the log may hold transactions out of ID order, each being replayed into its own slot
+    cnp::QWORD qwLogSequence = g_ServerLog.Append(SLR_TRANSACTION, &newTrans, sizeof(newTrans));
+
+    // other workers' records join the same group commit while this one
+    // waits.  A dropped transaction leaves its reserved slot unpublished,
+    // holding back sealing, but the log stays failed & none follow it
+    if (g_ServerLog.WaitDurable(qwLogSequence) == false)
+        return cnp::CER_ERROR;
+
+    g_TransactionLedger.Publish(newTrans);
+    {
+        std::lock_guard<std::mutex> IndexLock(g_TransactionMutex);
+
+        // concurrent transactions of one customer may get here out of ID order
+        auto& vecIDs = g_CustomerTransactions[qwCustomerID];
+        vecIDs.insert(std::upper_bound(vecIDs.begin(), vecIDs.end(), dwNewID), dwNewID);
+    }
+
+    return cnp::CER_SUCCESS;
+};
+
+/// session states allowed to send a request, SS_DISCONNECTING never being
+static constexpr unsigned g_uAnySession = SessionStateBit(SS_CONNECTED)  | SessionStateBit(SS_ACCOUNT_CREATED) |
+                                          SessionStateBit(SS_LOGGED_ON)  | SessionStateBit(SS_LOGGED_OFF);
+static constexpr unsigned g_uLoggedOn   = SessionStateBit(SS_LOGGED_ON);
+
+/// request handlers, indexed by CNP_MSG_TYPE less cnp::CMT_CONNECT
+static constexpr REQUEST_ENTRY g_rgRequestHandlers[] =
 {
-    const cnp::CONNECT_REQUEST* pReqMsg = static_cast<const cnp::CONNECT_REQUEST*>( pMsg );
+    { cnp::MT_CONNECT_REQUEST,           sizeof(cnp::CONNECT_REQUEST),           0,             ProcessConnectRequest          },
+    { cnp::MT_CREATE_ACCOUNT_REQUEST,    sizeof(cnp::CREATE_ACCOUNT_REQUEST),    g_uAnySession, ProcessCreateAccountRequest    },
+    { cnp::MT_LOGON_REQUEST,             sizeof(cnp::LOGON_REQUEST),             g_uAnySession, ProcessLogonRequest            },
+    { cnp::MT_LOGOFF_REQUEST,            sizeof(cnp::LOGOFF_REQUEST),            g_uAnySession, ProcessLogoffRequest           },
+    { cnp::MT_DEPOSIT_REQUEST,           sizeof(cnp::DEPOSIT_REQUEST),           g_uLoggedOn,   ProcessDepositRequest          },
+    { cnp::MT_WITHDRAWAL_REQUEST,        sizeof(cnp::WITHDRAWAL_REQUEST),        g_uLoggedOn,   ProcessWithdrawalRequest       },
+    { cnp::MT_BALANCE_QUERY_REQUEST,     sizeof(cnp::BALANCE_QUERY_REQUEST),     g_uLoggedOn,   ProcessBalanceQueryRequest     },
+    { cnp::MT_TRANSACTION_QUERY_REQUEST, sizeof(cnp::TRANSACTION_QUERY_REQUEST), g_uLoggedOn,   ProcessTransactionQueryRequest },
+    { cnp::MT_PURCHASE_STAMPS_REQUEST,   sizeof(cnp::STAMP_PURCHASE_REQUEST),    g_uLoggedOn,   ProcessStampPurchaseRequest    }
+};
+
+/// @retval true if every entry of g_rgRequestHandlers is at its type's index
+static constexpr bool IsRequestRegistryOrdered(void) noexcept
+{
+    for (size_t i = 0; i < sizeof(g_rgRequestHandlers) / sizeof(g_rgRequestHandlers[0]); i++)
+    {
+        if (g_rgRequestHandlers[i].m_dwMsgType != cnp::MT_CONNECT_REQUEST + i)
+            return false;
+    }
+    return true;
+};
+
+static_assert(sizeof(g_rgRequestHandlers) / sizeof(g_rgRequestHandlers[0]) == cnp::CMT_PURCHASE_STAMPS - cnp::CMT_CONNECT + 1,
+              "a request type is missing from g_rgRequestHandlers");
+static_assert(IsRequestRegistryOrdered(), "g_rgRequestHandlers is not in CNP_MSG_TYPE order");
+
+cnp::CER_TYPE DispatchRequest(const void* pMsg, size_t cbMsgLen, CNP_Connection* pConn)
+{
+    // the frame is at least a header, the rest is only read once its size is checked
+    const cnp::STD_HDR* pHdr = static_cast<const cnp::STD_HDR*>( pMsg );
+
+// 1. Look up the request type, any other type or subtype falling outside the registry
+    size_t nIndex = static_cast<size_t>(pHdr->get_MsgType()) - static_cast<size_t>(cnp::MT_CONNECT_REQUEST);
+    if (nIndex >= sizeof(g_rgRequestHandlers) / sizeof(g_rgRequestHandlers[0]))
+        return cnp::CER_ERROR;
+
+    const REQUEST_ENTRY& Entry = g_rgRequestHandlers[nIndex];
+
+// 2. Validate the size, ahead of the handler casting the request to its type
+    if (cbMsgLen != Entry.m_cbRequest)
+        return cnp::CER_INVALID_ARGUMENTS;
+
+    REQUEST_CONTEXT Context;
+    Context.m_pMsg     = pMsg;
+    Context.m_cbMsgLen = cbMsgLen;
+    Context.m_pConn    = pConn;
+    Context.m_pSession = &pConn->get_Session();
+    Context.m_cerAdmit = cnp::CER_SUCCESS;
+
+// 3. Validate the header's Client ID against the connection's own session,
+//    so one connection can never act on another's, & that the session's
+//    state allows the request
+    if (Entry.m_uStates != 0)
+    {
+        const SESSION_INFO& Session = Context.m_pSession->m_Info;
+
+        if (Session.get_State() == SS_INVALID || pHdr->get_ClientID() != Session.get_ClientID())
+        {
+            Context.m_cerAdmit = cnp::CER_INVALID_CLIENT_ID;
+        }
+        else if ((Entry.m_uStates & SessionStateBit(static_cast<SESSION_STATE>(Session.get_State()))) == 0)
+        {
+            Context.m_cerAdmit = cnp::CER_CLIENT_NOT_LOGGEDON;
+        }
+    }
+
+// 4. The handler answers, a refused request included
+    return Entry.m_pfnHandler(Context);
+};
+
+cnp::CER_TYPE ProcessConnectRequest(const REQUEST_CONTEXT& Context)
+{
+    const cnp::CONNECT_REQUEST* pReqMsg = static_cast<const cnp::CONNECT_REQUEST*>( Context.m_pMsg );
 
     cnp::CER_TYPE cerRR    = cnp::CER_ERROR;
     cnp::WORD wNewClientID = cnp::INVALID_CLIENT_ID;
 
-    std::cout << "[" << std::setw(5) << GetThreadID() 
-              << "] Client: NA  " << __FUNCTION__ 
-              << " MsgLen:" << cbMsgLen << std::endl;
+    CNP_LOG_REQUEST("Client:  NA MsgLen:%llu", Context.m_cbMsgLen);
 
 // 1. Verify the Validation Key
     if (pReqMsg->get_ClientValidationKey() == cnp::g_dwValidationKey)
@@ -131,25 +251,29 @@ cnp::WORD ProcessConnectRequest(const void* pMsg, size_t cbMsgLen, CNP_Socket* p
         if ((pReqMsg->get_ClientMajorVersion() <= g_wServerMajorVersion) && 
             (pReqMsg->get_ClientMinorVersion() <= g_wServerMinorVersion))
         {
-// 3. Generate a unique ClientID for the session
-            auto itS = g_SessionInfo.rbegin();
-            if (itS != g_SessionInfo.rend())
+// 3. A connection holds a single session, any earlier one is closed
+            SESSION_CONTEXT& Session = *Context.m_pSession;
+            if (Session.IsOpen())
             {
-                wNewClientID = itS->first + 1;
+                ProcessDisconnect(Session.m_Info.get_ClientID());
+                Session.Reset();
+            }
+
+// 4. Generate a unique ClientID for the session
+            wNewClientID = g_ClientIdAllocator.Allocate();
+
+// 5. Update the session state table, the ID's slot being free until it is
+//    released, & bind the session to the connection
+            if (wNewClientID != cnp::INVALID_CLIENT_ID && g_SessionTable.Open(wNewClientID, Context.m_pConn))
+            {
+                Session.m_Info = SESSION_INFO(wNewClientID, SS_CONNECTED, Context.m_pConn);
+                cerRR = cnp::CER_SUCCESS;
             }
             else
             {
-                wNewClientID = 1;
+                g_ClientIdAllocator.Release(wNewClientID);
+                wNewClientID = cnp::INVALID_CLIENT_ID;
             }
-
-// 4. Update the session state table
-            // lock g_SessionInfo
-            std::lock_guard<std::mutex> SessionLock(g_SessionMutex);
-            
-            SESSION_INFO newSession(wNewClientID, SS_CONNECTED, pSocket);
-            g_SessionInfo.insert(SessionMap_t::value_type(wNewClientID, newSession));
-
-            cerRR = cnp::CER_SUCCESS;
         }
         else
         {
@@ -162,37 +286,28 @@ cnp::WORD ProcessConnectRequest(const void* pMsg, size_t cbMsgLen, CNP_Socket* p
         cerRR = cnp::CER_AUTHENICATION_FAILED;
     }
 
-// 5. Generate the Server Response Message
-    cnp::CONNECT_RESPONSE respMsg(cerRR,
-                                  wNewClientID,
-                                  g_wServerMajorVersion,
-                                  g_wServerMinorVersion,
-                                  pReqMsg->get_Sequence(),
-                                  pReqMsg->get_Context());
+// 6. Build the Server Response Message in place, for dispatching
+    Context.m_pConn->EmplaceResponse<cnp::CONNECT_RESPONSE>(cerRR,
+                                                            wNewClientID,
+                                                            g_wServerMajorVersion,
+                                                            g_wServerMinorVersion,
+                                                            pReqMsg->get_Sequence(),
+                                                            pReqMsg->get_Context());
 
-// 6. Que the response for dispatching
-//    g_queSvrRespMsg.Push(respMsg);
-
-    pSocket->Send(&respMsg, respMsg.get_Size());
-    return wNewClientID;
+    return cerRR;
 };
 
-bool ProcessCreateAccountRequest(const void* pMsg, size_t cbMsgLen)
+cnp::CER_TYPE ProcessCreateAccountRequest(const REQUEST_CONTEXT& Context)
 {
-    const cnp::CREATE_ACCOUNT_REQUEST* pReqMsg = static_cast<const cnp::CREATE_ACCOUNT_REQUEST*>( pMsg );   
+    const cnp::CREATE_ACCOUNT_REQUEST* pReqMsg = static_cast<const cnp::CREATE_ACCOUNT_REQUEST*>( Context.m_pMsg );   
 
-    cnp::CER_TYPE cerRR = cnp::CER_ERROR;
+    cnp::CER_TYPE cerRR = Context.m_cerAdmit;
     cnp::WORD wClientID = pReqMsg->get_ClientID();
-    CNP_Socket* pSocket = nullptr;
     
-    std::cout << "[" << std::setw(5) << GetThreadID() 
-              << "] Client:" << std::setw(4) << wClientID << " " << __FUNCTION__ 
-              << " MsgLen:" << cbMsgLen << std::endl;
-// 1. Validate the connection
-    auto itS = g_SessionInfo.find(wClientID);
-    if (itS != g_SessionInfo.end())
+    CNP_LOG_REQUEST("Client:%4llu MsgLen:%llu", wClientID, Context.m_cbMsgLen);
+// 1. The connection has been validated by the dispatcher
+    if (cnp::Succeeded(cerRR))
     {
-        pSocket = itS->second.m_pSocket;
 // 2. Validate the Name & PIN
         const char* szName = pReqMsg->get_FirstName();
         cnp::WORD   wPIN   = pReqMsg->get_PIN();
@@ -201,26 +316,24 @@ bool ProcessCreateAccountRequest(const void* pMsg, size_t cbMsgLen)
 // 3. Make sure the Name+PIN combo doesn't already exist
             cnp::QWORD qwCustomerID = GenerateCustomerID(szName, strlen(szName), wPIN);
             
-// NOTE - (neither the const nor the non-const versions of 'find' modify the container).
-// No mapped values are accessed: concurrently accessing or modifying elements is safe.
-// @TODO - reader-writer lock would be more appropriate for this            
-            auto itA = g_AccountInfo.find(qwCustomerID);
-            if (itA != g_AccountInfo.end())
-            {
-                cerRR = cnp::CER_ACCOUNT_EXISTS;
-            }
-            else
+// 4. Create & add the ACCOUNT_INFO, which fails if it already exists, only
+//    once it is logged, so a failed log leaves no account behind
+            ACCOUNT_INFO newAccount(pReqMsg->m_Request, qwCustomerID, 0);
+
+            cerRR = g_AccountInfo.Insert(newAccount, [&]()
             {
-// 4. Create & add the ACCOUNT_INFO
-                // lock g_AccountInfo
-                std::lock_guard<std::mutex> AccountLock(g_AccountMutex);
+                if (g_ServerLog.WaitDurable(g_ServerLog.Append(SLR_ACCOUNT, &newAccount, sizeof(newAccount))) == false)
+                    return cnp::CER_ERROR;
 
-                ACCOUNT_INFO newAccount(pReqMsg->m_Request, qwCustomerID, 0);
+                return cnp::CER_SUCCESS;
+            });
 
-                g_AccountInfo.insert(AccountMap_t::value_type(qwCustomerID, newAccount) );
-// 5. Update the session state table
-                itS->second.set_State(SS_ACCOUNT_CREATED);
-                cerRR = cnp::CER_SUCCESS;
+            if (cnp::Succeeded(cerRR))
+            {
+// 5. Update the session state, a client already logged on staying so
+                SESSION_INFO& Info = Context.m_pSession->m_Info;
+                if (Info.get_State() != SS_LOGGED_ON)
+                    Info.set_State(SS_ACCOUNT_CREATED);
             }
         }
         else
@@ -228,61 +341,44 @@ bool ProcessCreateAccountRequest(const void* pMsg, size_t cbMsgLen)
             cerRR = cnp::CER_INVALID_NAME_PIN;
         }
     }
-    else
-    {
-        cerRR = cnp::CER_INVALID_CLIENT_ID;
-    }
-// 6. Generate the Server Response Message
-    cnp::CREATE_ACCOUNT_RESPONSE respMsg(cerRR,
-                                         pReqMsg->get_ClientID(),
-                                         pReqMsg->get_Sequence(),
-                                         pReqMsg->get_Context());
-
-// 7. Que the Server Response for Dispatching
-//    g_queSvrRespMsg.Push(respMsg);
-
-    if (pSocket)
-    {
-        pSocket->Send(&respMsg, respMsg.get_Size());
-    }
+// 6. Build the Server Response Message in place, for dispatching
+    Context.m_pConn->EmplaceResponse<cnp::CREATE_ACCOUNT_RESPONSE>(cerRR,
+                                                                   pReqMsg->get_ClientID(),
+                                                                   pReqMsg->get_Sequence(),
+                                                                   pReqMsg->get_Context());
 
-    return cnp::Succeeded(cerRR);
+    return cerRR;
 };
 
-bool ProcessLogonRequest(const void* pMsg, size_t cbMsgLen)
+cnp::CER_TYPE ProcessLogonRequest(const REQUEST_CONTEXT& Context)
 {
-    const cnp::LOGON_REQUEST* pReqMsg = static_cast<const cnp::LOGON_REQUEST*>( pMsg );    
+    const cnp::LOGON_REQUEST* pReqMsg = static_cast<const cnp::LOGON_REQUEST*>( Context.m_pMsg );    
     
-    cnp::CER_TYPE cerRR = cnp::CER_ERROR;
+    cnp::CER_TYPE cerRR = Context.m_cerAdmit;
     cnp::WORD wClientID = pReqMsg->get_ClientID();
-    CNP_Socket* pSocket = nullptr;
-
-    std::cout << "[" << std::setw(5) << GetThreadID() 
-              << "] Client:" << std::setw(4) << wClientID << " " << __FUNCTION__ 
-              << " MsgLen:" << cbMsgLen << std::endl;
-// 1. Validate the connection
-    auto itS = g_SessionInfo.find(wClientID);
-    if (itS != g_SessionInfo.end())
+
+    CNP_LOG_REQUEST("Client:%4llu MsgLen:%llu", wClientID, Context.m_cbMsgLen);
+// 1. The connection has been validated by the dispatcher
+    if (cnp::Succeeded(cerRR))
     {
-        pSocket = itS->second.m_pSocket;
 // 2. Validate the Name & PIN
         const char* szName = pReqMsg->get_FirstName();
         cnp::WORD   wPIN   = pReqMsg->get_PIN();
         if (IsValidName(szName) && IsValidPIN(wPIN))
         {
-            cnp::QWORD qwCustomerID = GenerateCustomerID(szName, strlen(szName), wPIN);
+            cnp::QWORD     qwCustomerID = GenerateCustomerID(szName, strlen(szName), wPIN);
+            ACCOUNT_HANDLE hAccount;
 
 // 3. Make sure an account with the Name+PIN combo exists
             
-// NOTE - (neither the const nor the non-const versions of 'find' modify the container).
-// No mapped values are accessed: concurrently accessing or modifying elements is safe.
-// @TODO - reader-writer lock would be more appropriate for this 
-            auto itA = g_AccountInfo.find(qwCustomerID);
-            if (itA != g_AccountInfo.end())
+            if (g_AccountInfo.Find(qwCustomerID, hAccount))
             {
-// 4. Update the SESSION_INFO to record the client as logged on
-                itS->second.set_CustomerID(qwCustomerID);
-                itS->second.set_State(SS_LOGGED_ON);
+// 4. Update the session to record the client as logged on, & the
+//    account its later requests act on
+                SESSION_CONTEXT& Session = *Context.m_pSession;
+                Session.m_Info.set_CustomerID(qwCustomerID);
+                Session.m_Info.set_State(SS_LOGGED_ON);
+                Session.m_hAccount = hAccount;
                 cerRR = cnp::CER_SUCCESS;
             }
             else
@@ -296,489 +392,274 @@ bool ProcessLogonRequest(const void* pMsg, size_t cbMsgLen)
             cerRR = cnp::CER_INVALID_NAME_PIN;
         }
     }
-    else
-    {
-        cerRR = cnp::CER_INVALID_CLIENT_ID;
-    }
-// 6. Generate the Server Response Message
-    cnp::LOGON_RESPONSE respMsg(cerRR,
-                                pReqMsg->get_ClientID(),
-                                pReqMsg->get_Sequence(),
-                                pReqMsg->get_Context());
-
-// 7. Que the server response for dispatching
-//    g_queSvrRespMsg.Push(respMsg);
-    if (pSocket)
-        pSocket->Send(&respMsg, respMsg.get_Size());
-
-    return cnp::Succeeded(cerRR);
+// 6. Build the Server Response Message in place, for dispatching
+    Context.m_pConn->EmplaceResponse<cnp::LOGON_RESPONSE>(cerRR,
+                                                          pReqMsg->get_ClientID(),
+                                                          pReqMsg->get_Sequence(),
+                                                          pReqMsg->get_Context());
+
+    return cerRR;
 };
 
-bool ProcessLogoffRequest(const void* pMsg, size_t cbMsgLen)
+cnp::CER_TYPE ProcessLogoffRequest(const REQUEST_CONTEXT& Context)
 {
-    const cnp::LOGOFF_REQUEST* pReqMsg = static_cast<const cnp::LOGOFF_REQUEST*>( pMsg );    
+    const cnp::LOGOFF_REQUEST* pReqMsg = static_cast<const cnp::LOGOFF_REQUEST*>( Context.m_pMsg );    
     
-    cnp::CER_TYPE cerRR = cnp::CER_ERROR;
+    cnp::CER_TYPE cerRR = Context.m_cerAdmit;
     cnp::WORD wClientID = pReqMsg->get_ClientID();
-    CNP_Socket* pSocket = nullptr;
-
-    std::cout << "[" << std::setw(5) << GetThreadID() 
-              << "] Client:" << std::setw(4) << wClientID << " " << __FUNCTION__ 
-              << " MsgLen:" << cbMsgLen << std::endl;
-// 1. Validate the connection
-    auto itS = g_SessionInfo.find(wClientID);
-    if (itS != g_SessionInfo.end())
+
+    CNP_LOG_REQUEST("Client:%4llu MsgLen:%llu", wClientID, Context.m_cbMsgLen);
+// 1. The connection has been validated by the dispatcher
+    if (cnp::Succeeded(cerRR))
     {
-        pSocket = itS->second.m_pSocket;
 // 2. Validate they are logged on
-        cnp::QWORD qwCustomerID = itS->second.get_CustomerID();
-        if (IsValidCustomerID(qwCustomerID))
-        {
-// 3. Update the SESSION_INFO table & clear their customer ID, 
-//    but leave them in the session table for now
-            itS->second.set_CustomerID(INVALID_CUSTOMER_ID);
-
-            cerRR = cnp::CER_SUCCESS;
-        }
-        else
+        SESSION_CONTEXT& Session = *Context.m_pSession;
+        if (Session.m_Info.get_State() != SS_LOGGED_ON)
         {
             cerRR = cnp::CER_CLIENT_NOT_LOGGEDON;
         }
-// 4. Update the session state
-        itS->second.set_State(SS_LOGGED_OFF);
-    }
-    else
-    {
-        cerRR = cnp::CER_INVALID_CLIENT_ID;
+// 3. Update the session, clearing their customer ID, account & state,
+//    but leave them in the session table for now
+        Session.m_Info.set_CustomerID(INVALID_CUSTOMER_ID);
+        Session.m_Info.set_State(SS_LOGGED_OFF);
+        Session.m_hAccount = ACCOUNT_HANDLE();
     }
 
-// Generate the Server Response Message
-    cnp::LOGOFF_RESPONSE respMsg(cerRR,
-                                 pReqMsg->get_ClientID(),
-                                 pReqMsg->get_Sequence(),
-                                 pReqMsg->get_Context());
+// Build the Server Response Message in place, for dispatching
+    Context.m_pConn->EmplaceResponse<cnp::LOGOFF_RESPONSE>(cerRR,
+                                                           pReqMsg->get_ClientID(),
+                                                           pReqMsg->get_Sequence(),
+                                                           pReqMsg->get_Context());
 
-// Que the server response for dispatching
-//    g_queSvrRespMsg.Push(respMsg);
-    if (pSocket)
-        pSocket->Send(&respMsg, respMsg.get_Size());
-
-    return cnp::Succeeded(cerRR);
+    return cerRR;
 };
 
-bool ProcessDepositRequest(const void* pMsg, size_t cbMsgLen)
+cnp::CER_TYPE ProcessDepositRequest(const REQUEST_CONTEXT& Context)
 {
-    const cnp::DEPOSIT_REQUEST* pReqMsg = static_cast<const cnp::DEPOSIT_REQUEST*>( pMsg );
+    const cnp::DEPOSIT_REQUEST* pReqMsg = static_cast<const cnp::DEPOSIT_REQUEST*>( Context.m_pMsg );
     
-    cnp::CER_TYPE cerRR = cnp::CER_ERROR;
-    cnp::WORD wClientID = pReqMsg->get_ClientID();
-    CNP_Socket* pSocket = nullptr;
+    cnp::CER_TYPE cerRR = Context.m_cerAdmit;
 
-    std::cout << "[" << std::setw(5) << GetThreadID() 
-              << "] Client:" << std::setw(4) << wClientID << " " << __FUNCTION__ 
-              << " MsgLen:" << cbMsgLen << std::endl;
+    CNP_LOG_REQUEST("Client:%4llu MsgLen:%llu", pReqMsg->get_ClientID(), Context.m_cbMsgLen);
 
-// 1. Validate the connection
-    auto itS = g_SessionInfo.find(wClientID);
-    if (itS != g_SessionInfo.end())
+// 1. The dispatcher has validated the connection & that they are logged on
+    if (cnp::Succeeded(cerRR))
     {
-        pSocket = itS->second.m_pSocket;
-// 2. Validate they have an account and are logged on
-        cnp::QWORD qwCustomerID = itS->second.get_CustomerID();
-        if (IsValidCustomerID(qwCustomerID))
-        {
-// NOTE - (neither the const nor the non-const versions of 'find' modify the container).
-// No mapped values are accessed: concurrently accessing or modifying elements is safe.
-// @TODO - reader-writer lock would be more appropriate for this 
-            auto itA = g_AccountInfo.find(qwCustomerID);
-            if (itA != g_AccountInfo.end())
-            {
-// 3. Update the account balance
-                itA->second.incr_Balance(pReqMsg->get_Amount());
-
-// 4. Record the transaction
-                // lock g_TransactionInfo
-                std::lock_guard<std::mutex> TransLock(g_TransactionMutex);
-
-                cnp::DWORD dwNewID = g_TransactionInfo.size() + 1;
-
-                cnp::QWORD qwNow = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-                TRANSACTION_INFO newTrans(dwNewID,
-                                          qwNow,
-                                          pReqMsg->get_Amount(),
-                                          cnp::TT_DEPOSIT,
-                                          qwCustomerID);
-
-                g_TransactionInfo.insert( TransactionMap_t::value_type(dwNewID, newTrans) );
-
-                cerRR = cnp::CER_SUCCESS;
-            }
-            else
-            {
-                cerRR = cnp::CER_ACCOUNT_NOT_FOUND;
-            }
-        }
-        else
+        const SESSION_CONTEXT& Session = *Context.m_pSession;
+// 2. Record the transaction & update the account balance, under the account's lock
+        cerRR = g_AccountInfo.Deposit(Session.m_hAccount, pReqMsg->get_Amount(), [&]()
         {
-            cerRR = cnp::CER_INVALID_NAME_PIN;
-        }
-    }
-    else
-    {
-        cerRR = cnp::CER_INVALID_CLIENT_ID;
+// 3. Generate and record the transaction, the balance only being updated once it is
+            return RecordTransaction(Session.m_Info.get_CustomerID(), pReqMsg->get_Amount(), cnp::TT_DEPOSIT);
+        });
     }
-// Generate the Server Response Message
-    cnp::DEPOSIT_RESPONSE respMsg(cerRR,
-                                  pReqMsg->get_ClientID(),
-                                  pReqMsg->get_Sequence(),
-                                  pReqMsg->get_Context());
-
-// Que the server response for dispatching
-//    g_queSvrRespMsg.Push(respMsg);
-    if (pSocket)
-        pSocket->Send(&respMsg, respMsg.get_Size());
-
-    return cnp::Succeeded(cerRR);
+// Build the Server Response Message in place, for dispatching
+    Context.m_pConn->EmplaceResponse<cnp::DEPOSIT_RESPONSE>(cerRR,
+                                                            pReqMsg->get_ClientID(),
+                                                            pReqMsg->get_Sequence(),
+                                                            pReqMsg->get_Context());
+
+    return cerRR;
 };
 
-bool ProcessWithdrawalRequest(const void* pMsg, size_t cbMsgLen)
+cnp::CER_TYPE ProcessWithdrawalRequest(const REQUEST_CONTEXT& Context)
 {
-    const cnp::WITHDRAWAL_REQUEST* pReqMsg = static_cast<const cnp::WITHDRAWAL_REQUEST*>( pMsg );
+    const cnp::WITHDRAWAL_REQUEST* pReqMsg = static_cast<const cnp::WITHDRAWAL_REQUEST*>( Context.m_pMsg );
     
-    cnp::CER_TYPE cerRR = cnp::CER_ERROR;
-    cnp::WORD wClientID = pReqMsg->get_ClientID();
-    CNP_Socket* pSocket = nullptr;
-
-    std::cout << "[" << std::setw(5) << GetThreadID() 
-              << "] Client:" << std::setw(4) << wClientID << " " << __FUNCTION__ 
-              << " MsgLen:" << cbMsgLen << std::endl;
-// 1. Validate the connection
-    auto itS = g_SessionInfo.find(wClientID);
-    if (itS != g_SessionInfo.end())
+    cnp::CER_TYPE cerRR = Context.m_cerAdmit;
+
+    CNP_LOG_REQUEST("Client:%4llu MsgLen:%llu", pReqMsg->get_ClientID(), Context.m_cbMsgLen);
+// 1. The dispatcher has validated the connection & that they are logged on
+    if (cnp::Succeeded(cerRR))
     {
-        pSocket = itS->second.m_pSocket;
-// 2. Validate they have an account and are logged on
-        cnp::QWORD qwCustomerID = itS->second.get_CustomerID();
-        if (IsValidCustomerID(qwCustomerID))
-        {
-// NOTE - (neither the const nor the non-const versions of 'find' modify the container).
-// No mapped values are accessed: concurrently accessing or modifying elements is safe.
-// @TODO - reader-writer lock would be more appropriate for this 
-            auto itA = g_AccountInfo.find(qwCustomerID);
-            if (itA != g_AccountInfo.end())
-            {
-// 3. Check available balance
-                cnp::DWORD dwCurBalance = itA->second.get_Balance();
-                cnp::DWORD dwWithdrawal = pReqMsg->get_Amount();
-                if (dwWithdrawal <= dwCurBalance)
-                {
-// 4. Decrement account balance
-                    itA->second.decr_Balance(dwWithdrawal);
-                    
-// 5. Generate and record the transaction
-                    // lock g_TransactionInfo
-                    std::lock_guard<std::mutex> TransLock(g_TransactionMutex);
-
-                    cnp::DWORD dwNewID = g_TransactionInfo.size() + 1;
-
-                    cnp::QWORD qwNow = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-                    TRANSACTION_INFO newTrans(dwNewID,
-                                              qwNow,
-                                              pReqMsg->get_Amount(),
-                                              cnp::TT_WITHDRAWAL,
-                                              qwCustomerID);
-
-                    g_TransactionInfo.insert( TransactionMap_t::value_type(dwNewID, newTrans) );
-
-                    cerRR = cnp::CER_SUCCESS;
-                }
-                else
-                {
-                    cerRR = cnp::CER_INSUFFICIENT_FUNDS;
-                }
-            }
-            else
-            {
-                cerRR = cnp::CER_ACCOUNT_NOT_FOUND;
-            }
-        }
-        else
+        const SESSION_CONTEXT& Session = *Context.m_pSession;
+// 2. Check the available balance & decrement it, under the account's lock
+        cerRR = g_AccountInfo.Withdraw(Session.m_hAccount, pReqMsg->get_Amount(), [&]()
         {
-            cerRR = cnp::CER_INVALID_NAME_PIN;
-        }
+// 3. Generate and record the transaction, the balance only being decremented once it is
+            return RecordTransaction(Session.m_Info.get_CustomerID(), pReqMsg->get_Amount(), cnp::TT_WITHDRAWAL);
+        });
     }
-    else
-    {
-        cerRR = cnp::CER_INVALID_CLIENT_ID;
-    }
-
-// 6. Generate the Server Response Message
-    cnp::WITHDRAWAL_RESPONSE respMsg(cerRR,
-                                     pReqMsg->get_ClientID(),
-                                     pReqMsg->get_Sequence(),
-                                     pReqMsg->get_Context());
 
-//  7. Que the server response for dispatching
-//    g_queSvrRespMsg.Push(respMsg);
-    if (pSocket)
-       pSocket->Send(&respMsg, respMsg.get_Size());
+// 4. Build the Server Response Message in place, for dispatching
+    Context.m_pConn->EmplaceResponse<cnp::WITHDRAWAL_RESPONSE>(cerRR,
+                                                               pReqMsg->get_ClientID(),
+                                                               pReqMsg->get_Sequence(),
+                                                               pReqMsg->get_Context());
 
-    return cnp::Succeeded(cerRR);
+    return cerRR;
 };
 
-bool ProcessBalanceQueryRequest(const void* pMsg, size_t cbMsgLen)
+cnp::CER_TYPE ProcessBalanceQueryRequest(const REQUEST_CONTEXT& Context)
 {
-    const cnp::BALANCE_QUERY_REQUEST* pReqMsg = static_cast<const cnp::BALANCE_QUERY_REQUEST*>( pMsg );
+    const cnp::BALANCE_QUERY_REQUEST* pReqMsg = static_cast<const cnp::BALANCE_QUERY_REQUEST*>( Context.m_pMsg );
     
-    cnp::CER_TYPE cerRR  = cnp::CER_ERROR;
+    cnp::CER_TYPE cerRR  = Context.m_cerAdmit;
     cnp::DWORD dwBalance = INVALID_BALANCE;
-    cnp::WORD  wClientID = pReqMsg->get_ClientID();
-    CNP_Socket* pSocket  = nullptr;
-
-    std::cout << "[" << std::setw(5) << GetThreadID() 
-              << "] Client:" << std::setw(4) << wClientID << " " << __FUNCTION__ 
-              << " MsgLen:" << cbMsgLen << std::endl;
-// 1. Validate the connection
-    auto itS = g_SessionInfo.find(wClientID);
-    if (itS != g_SessionInfo.end())
-    {
-        pSocket = itS->second.m_pSocket;
-// 2. Validate they have an account and are logged on
-        cnp::QWORD qwCustomerID = itS->second.get_CustomerID();
-        if (IsValidCustomerID(qwCustomerID))
-        {
-            auto itA = g_AccountInfo.find(qwCustomerID);
-            if (itA != g_AccountInfo.end())
-            {
-// 3. Retrieve their current balance.
-                dwBalance = itA->second.get_Balance();
 
-                cerRR = cnp::CER_SUCCESS;
-            }
-            else
-            {
-                cerRR = cnp::CER_ACCOUNT_NOT_FOUND;
-            }
-        }
-        else
+    CNP_LOG_REQUEST("Client:%4llu MsgLen:%llu", pReqMsg->get_ClientID(), Context.m_cbMsgLen);
+// 1. The dispatcher has validated the connection & that they are logged on
+    if (cnp::Succeeded(cerRR))
+    {
+// 2. Retrieve their current balance.
+        if (g_AccountInfo.GetBalance(Context.m_pSession->m_hAccount, dwBalance) == false)
         {
-            cerRR = cnp::CER_CLIENT_NOT_LOGGEDON;
+            cerRR = cnp::CER_ACCOUNT_NOT_FOUND;
         }
     }
-    else
-    {
-        cerRR = cnp::CER_INVALID_CLIENT_ID;
-    }
 
-// Generate the Server Response Message
-    cnp::BALANCE_QUERY_RESPONSE respMsg(cerRR,
-                                        pReqMsg->get_ClientID(),
-                                        dwBalance,
-                                        pReqMsg->get_Context(),
-                                        pReqMsg->get_Sequence());
+// Build the Server Response Message in place, for dispatching
+    Context.m_pConn->EmplaceResponse<cnp::BALANCE_QUERY_RESPONSE>(cerRR,
+                                                                  pReqMsg->get_ClientID(),
+                                                                  dwBalance,
+                                                                  pReqMsg->get_Context(),
+                                                                  pReqMsg->get_Sequence());
+
+    return cerRR;
+};
+
+static_assert(sizeof(cnp::TRANSACTION_QUERY_RESPONSE) + cnp::MAX_TRANSACTIONS_PER_RESPONSE * sizeof(cnp::TRANSACTION)
+                  <= CNP_OutputBatch::CHUNK_SIZE,
+              "a full TRANSACTION_QUERY_RESPONSE frame must be built in a single output chunk");
+
+/**
+    Builds one frame of a transaction query's response stream in place, with
+    an in-place new to instantiate the structure on top of the room reserved
+    in the connection's output
+
+    @retval true  on success
+    @retval false if the connection's output has failed
+ */
+static bool BuildQueryFrame(CNP_Connection* pConn, const QUERY_CURSOR& Cursor, cnp::CER_TYPE cerRR,
+                            const std::vector<cnp::TRANSACTION>& vecTransactions)
+{
+    cnp::WORD wTransCount = static_cast<cnp::WORD>(vecTransactions.size());
 
-// Que the server response for dispatching
-//    g_queSvrRespMsg.Push(respMsg);
-   if (pSocket)
-       pSocket->Send(&respMsg, respMsg.get_Size());
+    return pConn->BuildResponse(sizeof(cnp::TRANSACTION_QUERY_RESPONSE) + wTransCount * sizeof(cnp::TRANSACTION),
+                                [&](void* pBuffer) -> size_t
+    {
+        cnp::TRANSACTION_QUERY_RESPONSE* pRspMsg = new (pBuffer) 
+                    cnp::TRANSACTION_QUERY_RESPONSE( cerRR,
+                                                     Cursor.m_wClientID,
+                                                     wTransCount,
+                                                     Cursor.m_dwSequence,
+                                                     Cursor.m_dwContext );
+
+        int i = 0;
+        for (auto it : vecTransactions)
+        {
+            pRspMsg->m_Response.m_rgTransactions[i++] = it;
+        }
 
-    return cnp::Succeeded(cerRR);
+        return pRspMsg->get_Size();
+    });
 };
 
-bool ProcessTransactionQueryRequest(const void* pMsg, size_t cbMsgLen)
+bool ContinueTransactionQuery(CNP_Connection* pConn)
 {
-    const cnp::TRANSACTION_QUERY_REQUEST* pReqMsg = static_cast<const cnp::TRANSACTION_QUERY_REQUEST*>( pMsg );
-    
-    cnp::CER_TYPE cerRR   = cnp::CER_ERROR;
-    cnp::WORD wClientID   = pReqMsg->get_ClientID();
-    cnp::WORD wTransCount = 0;
+    SESSION_CONTEXT& Session = pConn->get_Session();
+    QUERY_CURSOR&    Cursor  = Session.m_Query;
     std::vector<cnp::TRANSACTION> vecTransactions;
-    CNP_Socket* pSocket = nullptr;
-
-    std::cout << "[" << std::setw(5) << GetThreadID() 
-              << "] Client:" << std::setw(4) << wClientID << " " << __FUNCTION__ 
-              << " MsgLen:" << cbMsgLen << std::endl;
-// 1. Validate the connection
-    auto itS = g_SessionInfo.find(wClientID);
-    if (itS != g_SessionInfo.end())
+
+    while (Cursor.IsPending())
     {
-        pSocket = itS->second.m_pSocket;
-// 2. Validate they have an account and are logged on
-        cnp::QWORD qwCustomerID = itS->second.get_CustomerID();
-        if (IsValidCustomerID(qwCustomerID))
+        // the rest of the stream waits for the output to drain
+        if (pConn->IsOutputFull())
+            return false;
+
+// Look up the next frame's worth of the customer's own transactions,
+// starting at m_dwStartID, the older ones being read from the sealed
+// ledger segments; having logged on, their account exists
+        vecTransactions.clear();
+        QueryCustomerTransactions(Session.m_Info.get_CustomerID(), Cursor.m_dwStartID,
+                                  std::min<size_t>(Cursor.m_nRemaining, cnp::MAX_TRANSACTIONS_PER_RESPONSE),
+                                  vecTransactions);
+
+        if (BuildQueryFrame(pConn, Cursor, cnp::CER_SUCCESS, vecTransactions) == false)
         {
-// NOTE - (neither the const nor the non-const versions of 'find' modify the container).
-// No mapped values are accessed: concurrently accessing or modifying elements is safe.
-// @TODO - reader-writer lock would be more appropriate for this 
-            auto itA = g_AccountInfo.find(qwCustomerID);
-            if (itA != g_AccountInfo.end())
-            {
-                cnp::DWORD dwStart = pReqMsg->get_StartID();
-                cnp::WORD  wCount  = pReqMsg->get_TransactionCount();
-                auto itT = g_TransactionInfo.lower_bound(dwStart);
-
-                if (itT != g_TransactionInfo.end())
-                {
-                    vecTransactions.reserve(wCount);
-
-                    cnp::WORD i = 0;
-                    for (i = 0; itT != g_TransactionInfo.end() && i < wCount; ++itT)
-                    {
-                        if (itT->second.get_CustomerID() == qwCustomerID)
-                        {
-                            vecTransactions.push_back(itT->second);
-                            i++;
-                        }
-                    }
-
-                    wTransCount = i;
-                }
-
-                cerRR = cnp::CER_SUCCESS;
-            }
-            else
-            {
-                cerRR = cnp::CER_ACCOUNT_NOT_FOUND;
-            }
+            Cursor.m_nRemaining = 0;
+            break;
         }
+
+// A short frame ends the stream, as does sending the requested count
+        Cursor.m_nRemaining -= vecTransactions.size();
+
+        if (vecTransactions.size() < cnp::MAX_TRANSACTIONS_PER_RESPONSE)
+            Cursor.m_nRemaining = 0;
         else
-        {
-            cerRR = cnp::CER_CLIENT_NOT_LOGGEDON;
-        }
-    }
-    else
-    {
-        cerRR = cnp::CER_INVALID_CLIENT_ID;
+            Cursor.m_dwStartID = vecTransactions.back().get_ID() + 1;
     }
 
-    // declare a buffer on the stack
-    char rgBuffer[512];
+    return true;
+};
+
+cnp::CER_TYPE ProcessTransactionQueryRequest(const REQUEST_CONTEXT& Context)
+{
+    const cnp::TRANSACTION_QUERY_REQUEST* pReqMsg = static_cast<const cnp::TRANSACTION_QUERY_REQUEST*>( Context.m_pMsg );
+    
+    cnp::CER_TYPE cerRR  = Context.m_cerAdmit;
+    QUERY_CURSOR& Cursor = Context.m_pSession->m_Query;
 
-// do an in-place new to instantiate the following structure
-// using the constructor, but on top of the buffer without allocating additional
-// memory on the heap.
+    CNP_LOG_REQUEST("Client:%4llu MsgLen:%llu", pReqMsg->get_ClientID(), Context.m_cbMsgLen);
 
-    cnp::TRANSACTION_QUERY_RESPONSE* pRspMsg = new (rgBuffer) 
-                cnp::TRANSACTION_QUERY_RESPONSE( cerRR,
-                                                 wClientID,
-                                                 wTransCount,
-                                                 pReqMsg->get_Sequence(),
-                                                 pReqMsg->get_Context() );
+    Cursor.m_wClientID  = pReqMsg->get_ClientID();
+    Cursor.m_dwSequence = pReqMsg->get_Sequence();
+    Cursor.m_dwContext  = pReqMsg->get_Context();
+    Cursor.m_dwStartID  = pReqMsg->get_StartID();
+    Cursor.m_nRemaining = 0;
 
-    int i = 0;
-    for (auto it : vecTransactions)
+// 1. The dispatcher has validated the connection & that they are logged on;
+//    if not, or no records are requested, the stream is a single empty frame
+    if (cnp::Succeeded(cerRR) == false || pReqMsg->get_TransactionCount() == 0)
     {
-        pRspMsg->m_Response.m_rgTransactions[i++] = it;
+        BuildQueryFrame(Context.m_pConn, Cursor, cerRR, std::vector<cnp::TRANSACTION>());
+        return cerRR;
     }
 
-    // Que the server response for dispatching
-//    g_queSvrRespMsg.Push(*pRspMsg);
-    if (pSocket)
-        pSocket->Send(pRspMsg, pRspMsg->get_Size());
+// 2. Send the stream a frame at a time, stopping at the connection's output
+//    limit, after which the cursor is continued ahead of the connection's
+//    next request once the output has drained
+    Cursor.m_nRemaining = pReqMsg->get_TransactionCount();
+    ContinueTransactionQuery(Context.m_pConn);
 
-    return cnp::Succeeded(cerRR);
+    return cerRR;
 };
 
-bool ProcessStampPurchaseRequest(const void* pMsg, size_t cbMsgLen)
+cnp::CER_TYPE ProcessStampPurchaseRequest(const REQUEST_CONTEXT& Context)
 {
-    const cnp::STAMP_PURCHASE_REQUEST* pReqMsg = static_cast<const cnp::STAMP_PURCHASE_REQUEST*>( pMsg );
-    cnp::CER_TYPE cerRR = cnp::CER_ERROR;
-    cnp::WORD wClientID = pReqMsg->get_ClientID();
-    CNP_Socket* pSocket = nullptr;
-
-    std::cout << "[" << std::setw(5) << GetThreadID() 
-              << "] Client:" << std::setw(4) << wClientID << " " << __FUNCTION__ 
-              << " MsgLen:" << cbMsgLen << std::endl;
-// 1. Validate the connection
-    auto itS = g_SessionInfo.find(wClientID);
-    if (itS != g_SessionInfo.end())
+    const cnp::STAMP_PURCHASE_REQUEST* pReqMsg = static_cast<const cnp::STAMP_PURCHASE_REQUEST*>( Context.m_pMsg );
+    cnp::CER_TYPE cerRR = Context.m_cerAdmit;
+
+    CNP_LOG_REQUEST("Client:%4llu MsgLen:%llu", pReqMsg->get_ClientID(), Context.m_cbMsgLen);
+// 1. The dispatcher has validated the connection & that they are logged on
+    if (cnp::Succeeded(cerRR))
     {
-        pSocket = itS->second.m_pSocket;
-// 2. Validate they have an account and are logged on
-        cnp::QWORD qwCustomerID = itS->second.get_CustomerID();
-        if (IsValidCustomerID(qwCustomerID))
+        const SESSION_CONTEXT& Session = *Context.m_pSession;
+// 2. Check the available balance & decrement it, under the account's lock
+        cerRR = g_AccountInfo.Withdraw(Session.m_hAccount, pReqMsg->get_Amount(), [&]()
         {
-// NOTE - (neither the const nor the non-const versions of 'find' modify the container).
-// No mapped values are accessed: concurrently accessing or modifying elements is safe.
-// @TODO - reader-writer lock would be more appropriate for this 
-            auto itA = g_AccountInfo.find(qwCustomerID);
-            if (itA != g_AccountInfo.end())
-            {
-// 3. Check available balance
-                cnp::DWORD dwCurBalance = itA->second.get_Balance();
-                cnp::DWORD dwWithdrawal = pReqMsg->get_Amount();
-                if (dwWithdrawal <= dwCurBalance)
-                {
-// 4. Decrement the account balance
-                    itA->second.decr_Balance(dwWithdrawal);
-
-// 5. Generate and record the transaction
-
-                    // lock g_TransactionInfo
-                    std::lock_guard<std::mutex> TransLock(g_TransactionMutex);
-
-                    cnp::DWORD dwNewID = g_TransactionInfo.size() + 1;
-                    cnp::QWORD qwNow   = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-                    TRANSACTION_INFO newTrans(dwNewID,
-                                              qwNow,
-                                              pReqMsg->get_Amount(),
-                                              cnp::TT_STAMP_PURCHASE,
-                                              qwCustomerID);
-
-                    g_TransactionInfo.insert( TransactionMap_t::value_type(dwNewID, newTrans) );
-
-                    cerRR = cnp::CER_SUCCESS;
-                }
-                else
-                {
-                    cerRR = cnp::CER_INSUFFICIENT_FUNDS;
-                }
-            }
-            else
-            {
-                cerRR = cnp::CER_ACCOUNT_NOT_FOUND;
-            }
-        }
-        else
-        {
-        cerRR = cnp::CER_CLIENT_NOT_LOGGEDON;
-        }
+// 3. Generate and record the transaction, the balance only being decremented once it is
+            return RecordTransaction(Session.m_Info.get_CustomerID(), pReqMsg->get_Amount(), cnp::TT_STAMP_PURCHASE);
+        });
     }
-    else
-    {
-        cerRR = cnp::CER_INVALID_CLIENT_ID;
-    }
-
-// 6. Generate Server Response Message
-    cnp::STAMP_PURCHASE_RESPONSE respMsg(cerRR,
-                                         pReqMsg->get_ClientID(),
-                                         pReqMsg->get_Sequence(),
-                                         pReqMsg->get_Context());
 
-// 7. Que the server response for dispatching
-//    g_queSvrRespMsg.Push(respMsg);
-    if (pSocket)
-        pSocket->Send(&respMsg, respMsg.get_Size());
+// 4. Build the Server Response Message in place, for dispatching
+    Context.m_pConn->EmplaceResponse<cnp::STAMP_PURCHASE_RESPONSE>(cerRR,
+                                                                   pReqMsg->get_ClientID(),
+                                                                   pReqMsg->get_Sequence(),
+                                                                   pReqMsg->get_Context());
 
-    return cnp::Succeeded(cerRR);
+    return cerRR;
 };
 
 bool ProcessDisconnect(cnp::WORD wClientID)
 {
-    std::cout << "[" << std::setw(5) << GetThreadID() 
-              << "] Client:" << std::setw(4) << wClientID << " " << __FUNCTION__ 
-              << std::endl;
-    bool bResult = false;
-
-    // lock g_SessionInfo
-    std::lock_guard<std::mutex> SessionLock(g_SessionMutex);
+    CNP_LOG_INFO("Client:%4llu", wClientID);
 
-    auto itS = g_SessionInfo.find(wClientID);
-    if (itS != g_SessionInfo.end())
-    {
-        g_SessionInfo.erase(itS);
-        bResult = true;
-    }
+    // handlers still holding a copy of the session can no longer change it
+    if (g_SessionTable.Close(wClientID) == false)
+        return false;
 
-    return bResult;
+    // the ID is only reissued once its session has gone
+    return g_ClientIdAllocator.Release(wClientID);
 };
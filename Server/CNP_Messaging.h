@@ -10,20 +10,85 @@
 #if !defined(__CNP_MESSAGING_H__)
 #define __CNP_MESSAGING_H__
 
+#ifndef __CNP_SESSION_H__
+    #include "CNP_Session.h"
+#endif
+
 // forward declaration
-class CNP_Socket;
+class CNP_Connection;
+
+/**
+    REQUEST_CONTEXT is what DispatchRequest() hands a request handler:
+    the request, already checked to be the size of its type, the
+    connection it arrived on & the session bound to the connection.
+ */
+struct REQUEST_CONTEXT
+{
+    const void*      m_pMsg;
+    size_t           m_cbMsgLen;
+    CNP_Connection*  m_pConn;      ///< connection the response is queued to
+    SESSION_CONTEXT* m_pSession;   ///< m_pConn's own session
+    cnp::CER_TYPE    m_cerAdmit;   ///< cnp::CER_SUCCESS if the session may send the request
+};
+
+/// uniform request handler, returning the result it answered with
+typedef cnp::CER_TYPE (*REQUEST_HANDLER)(const REQUEST_CONTEXT& Context);
+
+/// @retval unsigned containing the bit of eState in a REQUEST_ENTRY's m_uStates
+constexpr unsigned SessionStateBit(SESSION_STATE eState) noexcept
+{
+    return 1U << eState;
+};
+
+/**
+    REQUEST_ENTRY is the registry entry of a request type, g_rgRequestHandlers
+    being indexed by CNP_MSG_TYPE less cnp::CMT_CONNECT.
+ */
+struct REQUEST_ENTRY
+{
+    cnp::DWORD       m_dwMsgType;    ///< cnp::MSG_TYPE of the request
+    size_t           m_cbRequest;    ///< size of the request, header included
+    unsigned         m_uStates;      ///< SessionStateBit() of each state allowed to send it, 0 if sent sessionless
+    REQUEST_HANDLER  m_pfnHandler;
+};
 
-cnp::WORD ProcessConnectRequest         (const void* pMsg, size_t cbLen, CNP_Socket* pSocket);
+/**
+    @brief Validates a request's type, size & Client ID, against the
+           session bound to the connection, then passes it to the
+           handler registered for its type
+
+    @param [in] pMsg        the request, a whole frame
+    @param [in] cbMsgLen    length of the frame in bytes
+    @param [in] pConn       connection the request arrived on
+
+    @retval cnp::CER_TYPE containing the result the request was answered
+            with, cnp::CER_ERROR if it was dropped as being of no known
+            type & cnp::CER_INVALID_ARGUMENTS if as being mis-sized
+ */
+cnp::CER_TYPE DispatchRequest               (const void* pMsg, size_t cbMsgLen, CNP_Connection* pConn);
+
+cnp::CER_TYPE ProcessConnectRequest         (const REQUEST_CONTEXT& Context);
+cnp::CER_TYPE ProcessBalanceQueryRequest    (const REQUEST_CONTEXT& Context);
+cnp::CER_TYPE ProcessCreateAccountRequest   (const REQUEST_CONTEXT& Context);
+cnp::CER_TYPE ProcessDepositRequest         (const REQUEST_CONTEXT& Context);
+cnp::CER_TYPE ProcessLogoffRequest          (const REQUEST_CONTEXT& Context);
+cnp::CER_TYPE ProcessLogonRequest           (const REQUEST_CONTEXT& Context);
+cnp::CER_TYPE ProcessStampPurchaseRequest   (const REQUEST_CONTEXT& Context);
+cnp::CER_TYPE ProcessTransactionQueryRequest(const REQUEST_CONTEXT& Context);
+cnp::CER_TYPE ProcessWithdrawalRequest      (const REQUEST_CONTEXT& Context);
 
-bool      ProcessBalanceQueryRequest    (const void* pMsg, size_t cbLen);
-bool      ProcessCreateAccountRequest   (const void* pMsg, size_t cbLen);
-bool      ProcessDepositRequest         (const void* pMsg, size_t cbLen);
-bool      ProcessLogoffRequest          (const void* pMsg, size_t cbLen);
-bool      ProcessLogonRequest           (const void* pMsg, size_t cbLen);
-bool      ProcessStampPurchaseRequest   (const void* pMsg, size_t cbLen);
-bool      ProcessTransactionQueryRequest(const void* pMsg, size_t cbLen);
-bool      ProcessWithdrawalRequest      (const void* pMsg, size_t cbLen);
+bool          ProcessDisconnect             (cnp::WORD wClientID);
 
-bool      ProcessDisconnect             (cnp::WORD wClientID);
+/**
+    @brief Sends the frames of the connection's transaction query response
+           stream that are still pending, until it ends or the connection's
+           output reaches its limit
+
+    @param [in] pConn   connection whose session's QUERY_CURSOR is continued
+
+    @retval true  if no frame remains pending
+    @retval false if the stream stopped at the output limit
+ */
+bool          ContinueTransactionQuery      (CNP_Connection* pConn);
 
-#endif
\ No newline at end of file
+#endif
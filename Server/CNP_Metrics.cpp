@@ -0,0 +1,330 @@
+/**
+ * @file   CNP_Metrics.cpp
+ * @brief  CNP_Metrics class implementation
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+#include <new>
+
+#include "CNP_Metrics.h"
+
+/// Global CNP_Metrics instance
+CNP_Metrics                                 g_Metrics;
+
+/**
+    SHARD_HOLDER holds the shard a thread records into, handing it back
+    for reuse once the thread ends.
+ */
+struct SHARD_HOLDER
+{
+    CNP_Metrics*         m_pOwner;
+    CNP_Metrics::SHARD*  m_pShard;
+
+    ~SHARD_HOLDER()
+    {
+        if (m_pShard)
+            m_pShard->m_bInUse.store(false, std::memory_order_release);
+    };
+};
+
+static thread_local SHARD_HOLDER t_ShardHolder = { nullptr, nullptr };
+
+/// names of the message types, in get_TypeIndex() order
+static const char* const g_rgTypeNames[CNP_Metrics::MSG_TYPE_COUNT] =
+{
+    "CONNECT", "CREATE_ACCOUNT", "LOGON", "LOGOFF", "DEPOSIT",
+    "WITHDRAWAL", "BALANCE_QUERY", "TRANSACTION_QUERY", "PURCHASE_STAMPS", "OTHER"
+};
+
+/// the results, & their names, in get_ResultIndex() order
+static const cnp::CER_TYPE g_rgResults[CNP_Metrics::RESULT_COUNT - 1] =
+{
+    cnp::CER_SUCCESS,             cnp::CER_AUTHENICATION_FAILED, cnp::CER_UNSUPPORTED_PROTOCOL,
+    cnp::CER_INVALID_CLIENT_ID,   cnp::CER_INVALID_NAME_PIN,     cnp::CER_INVALID_ARGUMENTS,
+    cnp::CER_CLIENT_NOT_LOGGEDON, cnp::CER_DRAWER_BLOCKED,       cnp::CER_INSUFFICIENT_FUNDS,
+    cnp::CER_ACCOUNT_NOT_FOUND,   cnp::CER_ACCOUNT_EXISTS,       cnp::CER_ERROR
+};
+
+static const char* const g_rgResultNames[CNP_Metrics::RESULT_COUNT] =
+{
+    "SUCCESS",             "AUTHENICATION_FAILED", "UNSUPPORTED_PROTOCOL",
+    "INVALID_CLIENT_ID",   "INVALID_NAME_PIN",     "INVALID_ARGUMENTS",
+    "CLIENT_NOT_LOGGEDON", "DRAWER_BLOCKED",       "INSUFFICIENT_FUNDS",
+    "ACCOUNT_NOT_FOUND",   "ACCOUNT_EXISTS",       "ERROR",
+    "OTHER"
+};
+
+/// @retval index of the highest set bit of a non-zero value
+static inline unsigned HighestBit(cnp::QWORD qwValue) noexcept
+{
+#ifdef __linux__
+    return 63 - static_cast<unsigned>(__builtin_clzll(qwValue));
+#elif _MSC_VER
+    unsigned long ulIndex = 0;
+    _BitScanReverse64(&ulIndex, qwValue);
+    return static_cast<unsigned>(ulIndex);
+#endif
+};
+
+
+size_t LATENCY_HISTOGRAM::get_Bucket(cnp::QWORD qwValue) noexcept
+{
+    if (qwValue < SUB_COUNT)
+        return static_cast<size_t>(qwValue);
+
+    unsigned uBits = HighestBit(qwValue);
+    if (uBits >= MAX_BITS)
+        return BUCKET_COUNT - 1;
+
+    // the SUB_BITS bits below the highest pick the bucket within its power of 2
+    size_t nSub = static_cast<size_t>(qwValue >> (uBits - SUB_BITS)) & (SUB_COUNT - 1);
+    return (uBits - SUB_BITS + 1) * SUB_COUNT + nSub;
+};
+
+cnp::QWORD LATENCY_HISTOGRAM::get_BucketValue(size_t nBucket) noexcept
+{
+    if (nBucket < SUB_COUNT)
+        return nBucket;
+
+    unsigned uShift = static_cast<unsigned>(nBucket / SUB_COUNT) - 1;
+    cnp::QWORD qwLow = static_cast<cnp::QWORD>(SUB_COUNT + nBucket % SUB_COUNT) << uShift;
+
+    return qwLow + (cnp::QWORD(1) << uShift) - 1;
+};
+
+cnp::QWORD LATENCY_HISTOGRAM::get_Percentile(double dQuantile) const noexcept
+{
+    if (m_qwCount == 0)
+        return 0;
+
+    cnp::QWORD qwRank = static_cast<cnp::QWORD>(dQuantile * static_cast<double>(m_qwCount));
+    if (qwRank >= m_qwCount)
+        qwRank = m_qwCount - 1;
+
+    cnp::QWORD qwSeen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; i++)
+    {
+        qwSeen += m_rgBuckets[i];
+        if (qwSeen > qwRank)
+        {
+            cnp::QWORD qwValue = get_BucketValue(i);
+            return (qwValue < m_qwMax) ? qwValue : m_qwMax;
+        }
+    }
+
+    return m_qwMax;
+};
+
+
+void CNP_Metrics::SHARD_HISTOGRAM::Record(cnp::QWORD qwNanoSecs) noexcept
+{
+    // only the owning thread writes, so a load & store need no read-modify-write
+    std::atomic<cnp::QWORD>& qwBucket = m_rgBuckets[LATENCY_HISTOGRAM::get_Bucket(qwNanoSecs)];
+
+    qwBucket.store(qwBucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    m_qwSum.store(m_qwSum.load(std::memory_order_relaxed) + qwNanoSecs, std::memory_order_relaxed);
+
+    if (qwNanoSecs > m_qwMax.load(std::memory_order_relaxed))
+        m_qwMax.store(qwNanoSecs, std::memory_order_relaxed);
+};
+
+void CNP_Metrics::SHARD_HISTOGRAM::MergeInto(LATENCY_HISTOGRAM& Histogram) const noexcept
+{
+    for (size_t i = 0; i < LATENCY_HISTOGRAM::BUCKET_COUNT; i++)
+        Histogram.m_rgBuckets[i] += m_rgBuckets[i].load(std::memory_order_relaxed);
+
+    Histogram.m_qwSum += m_qwSum.load(std::memory_order_relaxed);
+
+    cnp::QWORD qwMax = m_qwMax.load(std::memory_order_relaxed);
+    if (qwMax > Histogram.m_qwMax)
+        Histogram.m_qwMax = qwMax;
+};
+
+
+CNP_Metrics::CNP_Metrics(void) noexcept
+    : m_Mutex(),
+      m_vecShards(),
+      m_tmStart(std::chrono::steady_clock::now())
+{ };
+
+size_t CNP_Metrics::get_TypeIndex(cnp::DWORD dwMsgType) noexcept
+{
+    // only requests are dispatched, the subtype is that of a request
+    cnp::DWORD dwType = dwMsgType & 0xFFFF;
+
+    if (dwType >= cnp::CMT_CONNECT && dwType <= cnp::CMT_PURCHASE_STAMPS && (dwMsgType >> 16) == cnp::CMS_REQUEST)
+        return dwType - cnp::CMT_CONNECT;
+
+    return MSG_TYPE_COUNT - 1;
+};
+
+size_t CNP_Metrics::get_ResultIndex(cnp::CER_TYPE eResult) noexcept
+{
+    for (size_t i = 0; i < COUNTOF(g_rgResults); i++)
+    {
+        if (g_rgResults[i] == eResult)
+            return i;
+    }
+
+    return RESULT_COUNT - 1;
+};
+
+void CNP_Metrics::Record(cnp::DWORD dwMsgType, cnp::CER_TYPE eResult,
+                         size_t cbMsgLen, cnp::QWORD qwNanoSecs) noexcept
+{
+    SHARD_HOLDER& Holder = t_ShardHolder;
+
+    if (Holder.m_pOwner != this)
+    {
+        if (Holder.m_pShard)
+            Holder.m_pShard->m_bInUse.store(false, std::memory_order_release);
+
+        Holder.m_pShard = Attach();
+        Holder.m_pOwner = this;
+    }
+
+    SHARD* pShard = Holder.m_pShard;
+    if (pShard == nullptr)
+        return;
+
+    size_t nType = get_TypeIndex(dwMsgType);
+
+    pShard->m_rgBytes[nType].store(pShard->m_rgBytes[nType].load(std::memory_order_relaxed) + cbMsgLen,
+                                   std::memory_order_relaxed);
+    pShard->m_rgByType[nType].Record(qwNanoSecs);
+    pShard->m_rgByResult[get_ResultIndex(eResult)].Record(qwNanoSecs);
+};
+
+CNP_Metrics::SHARD* CNP_Metrics::Attach(void) noexcept
+{
+    std::lock_guard<std::mutex> MetricsLock(m_Mutex);
+
+    for (auto& pFree : m_vecShards)
+    {
+        bool bInUse = false;
+        if (pFree->m_bInUse.compare_exchange_strong(bInUse, true, std::memory_order_acquire))
+            return pFree.get();
+    }
+
+    SHARD* pShard = new (std::nothrow) SHARD();
+    if (pShard == nullptr)
+        return nullptr;
+
+    try
+    {
+        m_vecShards.emplace_back(pShard);
+    }
+    catch (...)
+    {
+        delete pShard;
+        return nullptr;
+    }
+
+    pShard->m_bInUse.store(true, std::memory_order_relaxed);
+    return pShard;
+};
+
+/**
+    Appends a report line of a merged histogram, latencies in microseconds
+
+    @param [in] pBytes   bytes received, nullptr for none
+ */
+static void AppendLine(std::string& strReport, const char* szName, const LATENCY_HISTOGRAM& Histogram,
+                       double dSeconds, const cnp::QWORD* pBytes)
+{
+    char rgLine[256];
+
+    int cbLine = snprintf(rgLine, sizeof(rgLine),
+                          "%-22s %10llu %10.1f %10.1f %9.1f %9.1f %9.1f %9.1f %9.1f",
+                          szName,
+                          static_cast<unsigned long long>(Histogram.m_qwCount),
+                          (dSeconds > 0) ? static_cast<double>(Histogram.m_qwCount) / dSeconds : 0.0,
+                          static_cast<double>(Histogram.m_qwSum)
+                              / static_cast<double>(Histogram.m_qwCount) / 1000.0,
+                          static_cast<double>(Histogram.get_Percentile(0.50))  / 1000.0,
+                          static_cast<double>(Histogram.get_Percentile(0.90))  / 1000.0,
+                          static_cast<double>(Histogram.get_Percentile(0.99))  / 1000.0,
+                          static_cast<double>(Histogram.get_Percentile(0.999)) / 1000.0,
+                          static_cast<double>(Histogram.m_qwMax) / 1000.0);
+
+    if (pBytes && cbLine > 0 && static_cast<size_t>(cbLine) < sizeof(rgLine))
+        snprintf(rgLine + cbLine, sizeof(rgLine) - cbLine, " %12llu", static_cast<unsigned long long>(*pBytes));
+
+    strReport += rgLine;
+    strReport += '\n';
+};
+
+void CNP_Metrics::Report(std::string& strReport) const
+{
+    std::unique_ptr<LATENCY_HISTOGRAM[]> rgByType  (new LATENCY_HISTOGRAM[MSG_TYPE_COUNT]());
+    std::unique_ptr<LATENCY_HISTOGRAM[]> rgByResult(new LATENCY_HISTOGRAM[RESULT_COUNT]());
+    cnp::QWORD                           rgBytes[MSG_TYPE_COUNT] = { 0 };
+
+    {
+        std::lock_guard<std::mutex> MetricsLock(m_Mutex);
+
+        for (const auto& pShard : m_vecShards)
+        {
+            for (size_t i = 0; i < MSG_TYPE_COUNT; i++)
+            {
+                rgBytes[i] += pShard->m_rgBytes[i].load(std::memory_order_relaxed);
+                pShard->m_rgByType[i].MergeInto(rgByType[i]);
+            }
+
+            for (size_t i = 0; i < RESULT_COUNT; i++)
+                pShard->m_rgByResult[i].MergeInto(rgByResult[i]);
+        }
+    }
+
+    // the count is taken from the buckets, keeping the percentiles consistent
+    // with a shard recording while it is merged
+    for (size_t i = 0; i < MSG_TYPE_COUNT + RESULT_COUNT; i++)
+    {
+        LATENCY_HISTOGRAM& Histogram = (i < MSG_TYPE_COUNT) ? rgByType[i] : rgByResult[i - MSG_TYPE_COUNT];
+
+        for (size_t j = 0; j < LATENCY_HISTOGRAM::BUCKET_COUNT; j++)
+            Histogram.m_qwCount += Histogram.m_rgBuckets[j];
+    }
+
+    double dSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_tmStart).count();
+    char   rgLine[256];
+
+    snprintf(rgLine, sizeof(rgLine), "CNP server metrics, uptime %.1f s, latencies in microseconds\n", dSeconds);
+    strReport += rgLine;
+
+    snprintf(rgLine, sizeof(rgLine), "%-22s %10s %10s %10s %9s %9s %9s %9s %9s %12s\n",
+             "message", "count", "rate/s", "mean", "p50", "p90", "p99", "p99.9", "max", "bytes");
+    strReport += rgLine;
+
+    for (size_t i = 0; i < MSG_TYPE_COUNT; i++)
+    {
+        if (rgByType[i].m_qwCount > 0)
+            AppendLine(strReport, g_rgTypeNames[i], rgByType[i], dSeconds, &rgBytes[i]);
+    }
+
+    snprintf(rgLine, sizeof(rgLine), "%-22s %10s %10s %10s %9s %9s %9s %9s %9s\n",
+             "result", "count", "rate/s", "mean", "p50", "p90", "p99", "p99.9", "max");
+    strReport += rgLine;
+
+    for (size_t i = 0; i < RESULT_COUNT; i++)
+    {
+        if (rgByResult[i].m_qwCount > 0)
+            AppendLine(strReport, g_rgResultNames[i], rgByResult[i], dSeconds, nullptr);
+    }
+};
+
+void CNP_Metrics::Dump(FILE* pStream) const
+{
+    std::string strReport;
+    Report(strReport);
+
+    fputs(strReport.c_str(), pStream);
+    fflush(pStream);
+};
@@ -0,0 +1,170 @@
+/**
+ * @file   CNP_Metrics.h
+ * @brief  CNP_Metrics class interface
+ *
+ * CNP_Metrics counts the requests the server processes & records their
+ * service times, the time from dispatching a request to its handler
+ * returning, in a latency histogram per cnp::MSG_TYPE & another per
+ * cnp::CER_TYPE result.
+ *
+ * Each thread records into a shard of its own, with plain stores &
+ * no lock; Report() merges every shard on demand.  The histograms are
+ * HDR style: exact below SUB_COUNT nanoseconds, then SUB_COUNT buckets
+ * per power of 2, so that any percentile is reported to within about
+ * 6% of its value.
+ *
+ * A report is written to stdout on SIGUSR2, & to every client of the
+ * CNP_AdminEndpoint.
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#if !defined(__CNP_METRICS_H__)
+#define __CNP_METRICS_H__
+
+#ifndef __CNP_COMMON_H__
+    #include "CNP_Common.h"
+#endif
+
+#include <stdio.h>
+
+#ifndef _ATOMIC_
+    #include <atomic>
+#endif
+
+#ifndef _CHRONO_
+    #include <chrono>
+#endif
+
+#ifndef _MEMORY_
+    #include <memory>
+#endif
+
+#ifndef _MUTEX_
+    #include <mutex>
+#endif
+
+#ifndef _STRING_
+    #include <string>
+#endif
+
+#ifndef _VECTOR_
+    #include <vector>
+#endif
+
+/**
+    LATENCY_HISTOGRAM holds the merged nanosecond latencies of a
+    message type or result.
+ */
+struct LATENCY_HISTOGRAM
+{
+    static const unsigned SUB_BITS     = 4;
+    static const size_t   SUB_COUNT    = size_t(1) << SUB_BITS;
+    /// longer latencies, some 18 minutes, are counted in the last bucket
+    static const unsigned MAX_BITS     = 40;
+    static const size_t   BUCKET_COUNT = (MAX_BITS - SUB_BITS + 1) * SUB_COUNT;
+
+    cnp::QWORD  m_rgBuckets[BUCKET_COUNT];
+    cnp::QWORD  m_qwCount;
+    cnp::QWORD  m_qwSum;       ///< nanoseconds
+    cnp::QWORD  m_qwMax;       ///< nanoseconds
+
+    /// @retval size_t containing the bucket counting qwValue
+    static size_t     get_Bucket(cnp::QWORD qwValue) noexcept;
+
+    /// @retval cnp::QWORD containing the highest value counted by a bucket
+    static cnp::QWORD get_BucketValue(size_t nBucket) noexcept;
+
+/**
+    @param [in] dQuantile   quantile in the range [0, 1]
+
+    @retval cnp::QWORD containing the value in nanoseconds below which the
+            quantile of the latencies lie, 0 if none were recorded
+ */
+    cnp::QWORD        get_Percentile(double dQuantile) const noexcept;
+};
+
+class CNP_Metrics
+{
+public:
+    /// one per CNP message type, 0x50 to 0x58, plus one for any other
+    static const size_t MSG_TYPE_COUNT = 10;
+    /// one per cnp::CER_TYPE, plus one for any other
+    static const size_t RESULT_COUNT   = 13;
+
+private:
+    /// a histogram written by a single thread, & read while it is
+    struct SHARD_HISTOGRAM
+    {
+        std::atomic<cnp::QWORD>  m_rgBuckets[LATENCY_HISTOGRAM::BUCKET_COUNT];
+        std::atomic<cnp::QWORD>  m_qwSum;
+        std::atomic<cnp::QWORD>  m_qwMax;
+
+        void Record(cnp::QWORD qwNanoSecs) noexcept;
+        void MergeInto(LATENCY_HISTOGRAM& Histogram) const noexcept;
+    };
+
+    /// the counters & histograms of a recording thread
+    struct SHARD
+    {
+        std::atomic<bool>        m_bInUse;     ///< owned by a live thread
+        std::atomic<cnp::QWORD>  m_rgBytes[MSG_TYPE_COUNT];
+        SHARD_HISTOGRAM          m_rgByType[MSG_TYPE_COUNT];
+        SHARD_HISTOGRAM          m_rgByResult[RESULT_COUNT];
+    };
+
+    mutable std::mutex                     m_Mutex;       ///< guards m_vecShards
+    std::vector<std::unique_ptr<SHARD>>    m_vecShards;   ///< only ever grows
+    std::chrono::steady_clock::time_point  m_tmStart;
+
+public:
+    /// Default Constructor
+    CNP_Metrics(void) noexcept;
+
+/**
+    @brief Records a processed request in the calling thread's shard
+
+    @param [in] dwMsgType    cnp::MSG_TYPE of the request
+    @param [in] eResult      result the request was answered with
+    @param [in] cbMsgLen     length of the request in bytes
+    @param [in] qwNanoSecs   service time of the request
+ */
+    void        Record(cnp::DWORD dwMsgType, cnp::CER_TYPE eResult,
+                       size_t cbMsgLen, cnp::QWORD qwNanoSecs) noexcept;
+
+/**
+    @brief Formats a report of every shard's counters & histograms merged
+
+    @param [out] strReport   receives the report
+ */
+    void        Report(std::string& strReport) const;
+
+/**
+    @brief Writes a report to a stream
+ */
+    void        Dump  (FILE* pStream) const;
+
+private:
+    friend struct SHARD_HOLDER;
+
+/**
+    @brief Gives the calling thread a shard, reusing one left by an exited
+           thread, whose counts it adds to
+
+    @retval SHARD* address of the shard, or nullptr if out of memory
+ */
+    SHARD*      Attach(void) noexcept;
+
+    static size_t  get_TypeIndex  (cnp::DWORD dwMsgType) noexcept;
+    static size_t  get_ResultIndex(cnp::CER_TYPE eResult) noexcept;
+
+    CNP_Metrics(const CNP_Metrics&);
+    CNP_Metrics& operator=(const CNP_Metrics&);
+};
+
+/// Global CNP_Metrics instance
+extern CNP_Metrics  g_Metrics;
+
+#endif
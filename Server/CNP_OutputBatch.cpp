@@ -0,0 +1,354 @@
+/**
+ * @file   CNP_OutputBatch.cpp
+ * @brief  CNP_OutputBatch class implementation
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#include <string.h>
+
+#ifdef __linux__
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <linux/errqueue.h>
+#endif
+
+#include <algorithm>
+
+#include "CNP_OutputBatch.h"
+
+/// number of emptied chunks a batch holds on to between cycles
+static const size_t MAX_SPARE_CHUNKS = 2;
+
+
+CNP_OutputBatch::CNP_OutputBatch(void) noexcept
+    : m_vecChunks(),
+      m_vecSpare(),
+      m_vecPinned(),
+      m_cbSent(0),
+      m_cbSize(0),
+      m_tpFirst(),
+      m_cbZeroCopyMin(0),
+      m_uZeroCopyNext(0),
+      m_uZeroCopyDone(0),
+      m_vecZeroCopyDone()
+{ };
+
+CNP_OutputBatch::~CNP_OutputBatch()
+{
+    Clear();
+
+    for (auto& it : m_vecSpare)
+        delete it;
+};
+
+void CNP_OutputBatch::Append(const void* pMsg, size_t cbLen)
+{
+    const char* pData = static_cast<const char*>(pMsg);
+
+    if (m_cbSize == 0)
+        m_tpFirst = clock_type::now();
+
+    m_cbSize += cbLen;
+
+    while (cbLen > 0)
+    {
+        if (m_vecChunks.empty() || m_vecChunks.back()->m_cbUsed == CHUNK_SIZE)
+            AddChunk();
+
+        CHUNK* pChunk = m_vecChunks.back();
+        size_t cbCopy = CHUNK_SIZE - pChunk->m_cbUsed;
+        if (cbCopy > cbLen)
+            cbCopy = cbLen;
+
+        memcpy(pChunk->m_rgData + pChunk->m_cbUsed, pData, cbCopy);
+        pChunk->m_cbUsed += cbCopy;
+
+        pData += cbCopy;
+        cbLen -= cbCopy;
+    }
+};
+
+void* CNP_OutputBatch::Reserve(size_t cbMaxLen)
+{
+    if (cbMaxLen > CHUNK_SIZE)
+        return nullptr;
+
+    // a message never straddles chunks, the last one's remainder is left unused
+    if (m_vecChunks.empty() || CHUNK_SIZE - m_vecChunks.back()->m_cbUsed < cbMaxLen)
+        AddChunk();
+
+    CHUNK* pChunk = m_vecChunks.back();
+    return pChunk->m_rgData + pChunk->m_cbUsed;
+};
+
+void CNP_OutputBatch::Commit(size_t cbLen) noexcept
+{
+    if (cbLen == 0)
+        return;
+
+    if (m_cbSize == 0)
+        m_tpFirst = clock_type::now();
+
+    m_cbSize += cbLen;
+    m_vecChunks.back()->m_cbUsed += cbLen;
+};
+
+bool CNP_OutputBatch::EnableZeroCopy(CNP_Socket& Socket, size_t cbMin) noexcept
+{
+    m_cbZeroCopyMin = 0;
+
+#ifdef __linux__
+    int iEnable = 1;
+    if (cbMin > 0 && Socket.SetSocketOption(SOL_SOCKET, SO_ZEROCOPY, &iEnable, sizeof(iEnable)) != SOCKET_ERROR)
+        m_cbZeroCopyMin = cbMin;
+#else
+    UNREFERENCED_PARAMETER(Socket);
+    UNREFERENCED_PARAMETER(cbMin);
+#endif
+
+    return m_cbZeroCopyMin > 0;
+};
+
+bool CNP_OutputBatch::Flush(CNP_Socket& Socket, bool bZeroCopy /* = true */)
+{
+    IO_BUFFER rgBuffers[MAX_IOBUFFERS];
+
+    while (m_cbSize > 0)
+    {
+        size_t nCount   = get_IOBuffers(rgBuffers, MAX_IOBUFFERS);
+        int    iFlags   = 0;
+
+#ifdef __linux__
+        if (bZeroCopy && m_cbZeroCopyMin > 0)
+        {
+            size_t cbWrite = 0;
+            for (size_t i = 0; i < nCount; i++)
+                cbWrite += rgBuffers[i].iov_len;
+
+            if (cbWrite >= m_cbZeroCopyMin)
+                iFlags = MSG_ZEROCOPY;
+        }
+#else
+        UNREFERENCED_PARAMETER(bZeroCopy);
+#endif
+
+        int    cbResult = Socket.SendV(rgBuffers, nCount, iFlags);
+
+        if (cbResult == SOCKET_ERROR)
+        {
+            if (Socket.Interrupted())
+                continue;
+
+            return Socket.WouldBlock();
+        }
+
+        if (iFlags != 0)
+        {
+            // the kernel numbers each successful zero-copy write, the chunks
+            // it read from are pinned until that write's notice is reaped
+            unsigned uID     = ++m_uZeroCopyNext;
+            size_t   cbPinned = static_cast<size_t>(cbResult) + m_cbSent;
+
+            for (auto& pChunk : m_vecChunks)
+            {
+                if (cbPinned == 0)
+                    break;
+
+                pChunk->m_uZeroCopyID = uID;
+                cbPinned -= std::min(cbPinned, pChunk->m_cbUsed);
+            }
+        }
+
+        Consume(static_cast<size_t>(cbResult));
+    }
+
+    return true;
+};
+
+bool CNP_OutputBatch::Reap(CNP_Socket& Socket) noexcept
+{
+#ifdef __linux__
+    while (m_uZeroCopyDone != m_uZeroCopyNext)
+    {
+        char   rgControl[128];
+        msghdr msg = { 0 };
+        msg.msg_control    = rgControl;
+        msg.msg_controllen = sizeof(rgControl);
+
+        if (::recvmsg(Socket.get_Handle(), &msg, MSG_ERRQUEUE | MSG_DONTWAIT) == -1)
+            break;
+
+        for (cmsghdr* pCmsg = CMSG_FIRSTHDR(&msg); pCmsg; pCmsg = CMSG_NXTHDR(&msg, pCmsg))
+        {
+            if (!(pCmsg->cmsg_level == SOL_IP   && pCmsg->cmsg_type == IP_RECVERR) &&
+                !(pCmsg->cmsg_level == SOL_IPV6 && pCmsg->cmsg_type == IPV6_RECVERR))
+                continue;
+
+            const sock_extended_err* pErr = reinterpret_cast<const sock_extended_err*>(CMSG_DATA(pCmsg));
+            if (pErr->ee_errno != 0 || pErr->ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+                continue;
+
+            // the notice's range is of the kernel's 0 based IDs
+            CompleteZeroCopy(pErr->ee_info + 1, pErr->ee_data + 1);
+
+            // the kernel copied the data after all, as it does over loopback,
+            // zero-copy writes only cost more from then on
+            if (pErr->ee_code & SO_EE_CODE_ZEROCOPY_COPIED)
+                m_cbZeroCopyMin = 0;
+        }
+    }
+
+    auto itDone = std::partition(m_vecPinned.begin(), m_vecPinned.end(),
+                                 [this](const CHUNK* pChunk) { return pChunk->m_uZeroCopyID > m_uZeroCopyDone; });
+
+    for (auto it = itDone; it != m_vecPinned.end(); ++it)
+        Recycle(*it);
+
+    m_vecPinned.erase(itDone, m_vecPinned.end());
+#else
+    UNREFERENCED_PARAMETER(Socket);
+#endif
+
+    return m_uZeroCopyDone != m_uZeroCopyNext;
+};
+
+void CNP_OutputBatch::Linger(CNP_Socket& Socket, unsigned long ulMilliSecs) noexcept
+{
+#ifdef __linux__
+    auto tpEnd = clock_type::now() + std::chrono::milliseconds(ulMilliSecs);
+
+    while (Reap(Socket))
+    {
+        auto msLeft = std::chrono::duration_cast<std::chrono::milliseconds>(tpEnd - clock_type::now()).count();
+        if (msLeft <= 0)
+            break;
+
+        // a pending notice is reported as an error condition
+        pollfd pfd = { Socket.get_Handle(), 0, 0 };
+        ::poll(&pfd, 1, static_cast<int>(msLeft));
+    }
+#else
+    UNREFERENCED_PARAMETER(Socket);
+    UNREFERENCED_PARAMETER(ulMilliSecs);
+#endif
+};
+
+size_t CNP_OutputBatch::get_IOBuffers(IO_BUFFER* rgBuffers, size_t nMax) const noexcept
+{
+    size_t nCount = 0;
+
+    for (auto& pChunk : m_vecChunks)
+    {
+        if (nCount == nMax)
+            break;
+
+        size_t cbOffset = (nCount == 0) ? m_cbSent : 0;
+        SetIOBuffer(rgBuffers[nCount++], pChunk->m_rgData + cbOffset, pChunk->m_cbUsed - cbOffset);
+    }
+
+    return nCount;
+};
+
+void CNP_OutputBatch::Consume(size_t cbLen) noexcept
+{
+    m_cbSize -= cbLen;
+
+    // release every chunk that has been completely sent
+    while (cbLen > 0)
+    {
+        size_t cbRemaining = m_vecChunks.front()->m_cbUsed - m_cbSent;
+
+        if (cbLen < cbRemaining)
+        {
+            m_cbSent += cbLen;
+            break;
+        }
+
+        cbLen -= cbRemaining;
+        ReleaseFront();
+    }
+};
+
+void CNP_OutputBatch::Clear(void) noexcept
+{
+    while (!m_vecChunks.empty())
+        ReleaseFront();
+
+    // the socket is being closed or has failed, no notice is left to wait
+    // for; the pinned chunks are freed rather than reused
+    for (auto& pChunk : m_vecPinned)
+        delete pChunk;
+
+    m_vecPinned.clear();
+    m_vecZeroCopyDone.clear();
+
+    m_cbSize        = 0;
+    m_cbZeroCopyMin = 0;
+    m_uZeroCopyNext = 0;
+    m_uZeroCopyDone = 0;
+};
+
+CNP_OutputBatch::CHUNK* CNP_OutputBatch::AddChunk(void)
+{
+    CHUNK* pChunk = nullptr;
+    if (!m_vecSpare.empty())
+    {
+        pChunk = m_vecSpare.back();
+        m_vecSpare.pop_back();
+    }
+    else
+    {
+        pChunk = new CHUNK;
+    }
+
+    pChunk->m_cbUsed      = 0;
+    pChunk->m_uZeroCopyID = 0;
+    m_vecChunks.push_back(pChunk);
+    return pChunk;
+};
+
+void CNP_OutputBatch::ReleaseFront(void) noexcept
+{
+    CHUNK* pChunk = m_vecChunks.front();
+    m_vecChunks.erase(m_vecChunks.begin());
+    m_cbSent = 0;
+
+    if (pChunk->m_uZeroCopyID > m_uZeroCopyDone)
+        m_vecPinned.push_back(pChunk);
+    else
+        Recycle(pChunk);
+};
+
+void CNP_OutputBatch::Recycle(CHUNK* pChunk) noexcept
+{
+    if (m_vecSpare.size() < MAX_SPARE_CHUNKS)
+        m_vecSpare.push_back(pChunk);
+    else
+        delete pChunk;
+};
+
+void CNP_OutputBatch::CompleteZeroCopy(unsigned uFirst, unsigned uLast) noexcept
+{
+    // notices normally arrive in order, the odd one that does not is held
+    // until the writes ahead of it complete
+    m_vecZeroCopyDone.emplace_back(uFirst, uLast);
+
+    bool bAdvanced = true;
+    while (bAdvanced)
+    {
+        bAdvanced = false;
+        for (auto it = m_vecZeroCopyDone.begin(); it != m_vecZeroCopyDone.end(); ++it)
+        {
+            if (it->first <= m_uZeroCopyDone + 1)
+            {
+                m_uZeroCopyDone = std::max(m_uZeroCopyDone, it->second);
+                m_vecZeroCopyDone.erase(it);
+                bAdvanced = true;
+                break;
+            }
+        }
+    }
+};
@@ -0,0 +1,189 @@
+/**
+ * @file   CNP_OutputBatch.h
+ * @brief  CNP_OutputBatch class interface
+ *
+ * CNP_OutputBatch accumulates the response messages generated for a
+ * connection during a read/dispatch cycle, so that they can be sent
+ * with a single gathering write instead of one send() per message.
+ * Messages are held in a list of fixed-size chunks, each chunk becoming
+ * one element of the write.  A message is either copied in, or built in
+ * place, in room reserved at the end of the last chunk.
+ *
+ * On Linux, writes of at least a given size may be made with
+ * MSG_ZEROCOPY, the kernel then sending straight from the chunks.  A
+ * chunk so sent is only reused once the kernel's completion notice for
+ * it has been read off the socket's error queue, by Reap().
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#if !defined(__CNP_OUTPUT_BATCH_H__)
+#define __CNP_OUTPUT_BATCH_H__
+
+#ifndef __CNP_SOCKET_H__
+    #include "CNP_Socket.h"
+#endif
+
+#ifndef _CHRONO_
+    #include <chrono>
+#endif
+
+#ifndef _VECTOR_
+    #include <vector>
+#endif
+
+class CNP_OutputBatch
+{
+public:
+    typedef std::chrono::steady_clock  clock_type;
+
+    static const size_t CHUNK_SIZE   = 4096;  ///< capacity of each chunk in bytes
+    static const size_t MAX_IOBUFFERS = 64;   ///< most chunks handed to a single SendV()
+
+private:
+    struct CHUNK
+    {
+        size_t    m_cbUsed;
+        unsigned  m_uZeroCopyID;   ///< 1 + ID of the last zero-copy write of its data, 0 if none
+        char      m_rgData[CHUNK_SIZE];
+    };
+
+    std::vector<CHUNK*>     m_vecChunks;   ///< chunks holding unsent data, in order
+    std::vector<CHUNK*>     m_vecSpare;    ///< emptied chunks kept for reuse
+    std::vector<CHUNK*>     m_vecPinned;   ///< sent chunks the kernel may still be reading
+    size_t                  m_cbSent;      ///< bytes of the first chunk already sent
+    size_t                  m_cbSize;      ///< total unsent bytes
+    clock_type::time_point  m_tpFirst;     ///< when the oldest unsent message was appended
+    size_t                  m_cbZeroCopyMin; ///< smallest write made with MSG_ZEROCOPY, 0 if none are
+    unsigned                m_uZeroCopyNext; ///< ID the kernel gives the next zero-copy write
+    unsigned                m_uZeroCopyDone; ///< zero-copy writes below this ID have all completed
+    std::vector<std::pair<unsigned, unsigned>> m_vecZeroCopyDone; ///< completed ID ranges above m_uZeroCopyDone
+
+public:
+    /// Default Constructor
+    CNP_OutputBatch(void) noexcept;
+
+    ~CNP_OutputBatch();
+
+/**
+    @retval size_t containing the number of bytes waiting to be sent
+ */
+    inline size_t get_Size(void) const noexcept
+    { return m_cbSize; };
+
+    inline bool   IsEmpty(void) const noexcept
+    { return m_cbSize == 0; };
+
+/**
+    @retval time_point at which the oldest unsent message was appended,
+            only meaningful if the batch is not empty
+ */
+    inline const clock_type::time_point& get_FirstTime(void) const noexcept
+    { return m_tpFirst; };
+
+/**
+    @brief Appends a complete message to the batch
+
+    @param [in] pMsg    message to be copied
+    @param [in] cbLen   length of the message in bytes
+ */
+    void   Append(const void* pMsg, size_t cbLen);
+
+/**
+    @brief Reserves room for a message to be built in place, contiguous
+           & at the end of the batch
+
+    The room is only added to the batch by Commit(), & must be committed
+    before anything else is appended.
+
+    @param [in] cbMaxLen   most bytes the message may take
+
+    @retval void* address to build the message at, or nullptr if cbMaxLen
+            exceeds CHUNK_SIZE
+ */
+    void*  Reserve(size_t cbMaxLen);
+
+/**
+    @brief Appends the message built in the room returned by Reserve()
+
+    @param [in] cbLen   length of the message, at most the room reserved
+ */
+    void   Commit(size_t cbLen) noexcept;
+
+/**
+    @brief Has writes of at least cbMin bytes made with MSG_ZEROCOPY
+
+    Only supported on Linux, where it enables SO_ZEROCOPY on the socket.
+
+    @param [in] Socket   connected socket the batch is written to
+    @param [in] cbMin    smallest write to make without copying, 0 to copy all
+
+    @retval true  if zero-copy writes are enabled
+ */
+    bool   EnableZeroCopy(CNP_Socket& Socket, size_t cbMin) noexcept;
+
+/**
+    @brief Writes as much of the batch as the socket accepts
+
+    Sent data is removed from the batch, a partial write leaves the
+    remainder in place for the next Flush().
+
+    @param [in] Socket      connected socket to write to
+    @param [in] bZeroCopy   false to copy every write, as when the socket
+                            is about to be closed
+
+    @retval true  if the batch has been fully sent, or the socket would block
+    @retval false if the socket has failed
+ */
+    bool   Flush (CNP_Socket& Socket, bool bZeroCopy = true);
+
+/**
+    @brief Reads the socket's zero-copy completion notices, making the
+           chunks the kernel has finished with reusable
+
+    @retval true  if zero-copy writes remain outstanding
+ */
+    bool   Reap  (CNP_Socket& Socket) noexcept;
+
+/**
+    @brief Waits up to ulMilliSecs for the outstanding zero-copy writes
+           to complete, ahead of the socket being closed & the batch cleared
+ */
+    void   Linger(CNP_Socket& Socket, unsigned long ulMilliSecs) noexcept;
+
+/**
+    @brief Describes the unsent data as a list of buffers, in order
+
+    The buffers remain valid until the data they describe is consumed,
+    even if further messages are appended in the meantime.
+
+    @param [out] rgBuffers   receives the buffers
+    @param [in]  nMax        capacity of rgBuffers
+
+    @retval size_t containing the number of buffers filled in
+ */
+    size_t get_IOBuffers(IO_BUFFER* rgBuffers, size_t nMax) const noexcept;
+
+/**
+    @brief Removes cbLen bytes of sent data from the front of the batch
+ */
+    void   Consume(size_t cbLen) noexcept;
+
+/**
+    @brief Discards any unsent data
+ */
+    void   Clear (void) noexcept;
+
+private:
+    CHUNK* AddChunk    (void);
+    void   ReleaseFront(void) noexcept;
+    void   Recycle     (CHUNK* pChunk) noexcept;
+    void   CompleteZeroCopy(unsigned uFirst, unsigned uLast) noexcept;
+
+    CNP_OutputBatch(const CNP_OutputBatch&);
+    CNP_OutputBatch& operator=(const CNP_OutputBatch&);
+};
+
+#endif
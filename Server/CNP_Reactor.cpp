@@ -0,0 +1,415 @@
+/**
+ * @file   CNP_Reactor.cpp
+ * @brief  CNP_Reactor class implementation
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#ifdef __linux__
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
+
+#include <mutex>
+#include <set>
+#include <thread>
+#include <iostream>
+
+#include "CNP_Connection.h"
+#include "CNP_Server.h"
+#include "CNP_Reactor.h"
+
+/// upper bound on the number of closed connection contexts kept for reuse
+static const size_t MAX_FREE_CONNECTIONS = 1024;
+
+#ifdef __linux__
+/// one-shot, so that a connection is only ever serviced by a single worker at a time
+static const uint32_t CONNECTION_EVENTS  = EPOLLIN | EPOLLRDHUP | EPOLLET | EPOLLONESHOT;
+#endif
+
+/**
+    A single event loop thread along with the connections it services.
+
+    The mutex guards the connection set against concurrent insertion by
+    the accepting thread & removal by the worker threads.
+ */
+struct CNP_Reactor::EVENT_LOOP
+{
+#ifdef __linux__
+    int                        m_hEpoll;   ///< epoll instance
+    int                        m_hWakeup;  ///< eventfd used to interrupt epoll_wait
+#endif
+    std::thread*               m_pThread;
+    std::mutex                 m_Mutex;
+    std::set<CNP_Connection*>  m_setConnections;
+
+    EVENT_LOOP(void) noexcept
+        :
+#ifdef __linux__
+          m_hEpoll (-1),
+          m_hWakeup(-1),
+#endif
+          m_pThread(nullptr)
+    { };
+};
+
+
+CNP_Reactor::CNP_Reactor(size_t nEventLoops /* = 0 */, size_t nWorkers /* = 0 */,
+                         size_t nWriters /* = 1 */)
+    : m_vecLoops(),
+      m_nNextLoop(0),
+      m_bTerminate(false),
+      m_nWorkers(nWorkers),
+      m_WorkerPool([this](CNP_Connection* pConn) { Service(pConn); }),
+      m_nWriters(nWriters),
+      m_Dispatcher([this](CNP_Connection* pConn) { Resume(pConn); }),
+      m_FreeMutex(),
+      m_vecFreeList()
+{
+    if (nEventLoops == 0)
+        nEventLoops = std::thread::hardware_concurrency();
+    if (nEventLoops == 0)
+        nEventLoops = 1;
+
+    for (size_t i = 0; i < nEventLoops; i++)
+        m_vecLoops.push_back(new EVENT_LOOP());
+};
+
+CNP_Reactor::~CNP_Reactor()
+{
+    Stop();
+
+    for (auto& it : m_vecLoops)
+        delete it;
+
+    for (auto& it : m_vecFreeList)
+        delete it;
+};
+
+bool CNP_Reactor::Start(void)
+{
+#ifdef __linux__
+    m_WorkerPool.Start(m_nWorkers);
+#endif
+
+    if (m_Dispatcher.Start(m_nWriters) == false)
+        return false;
+
+    for (auto& pLoop : m_vecLoops)
+    {
+#ifdef __linux__
+        pLoop->m_hEpoll  = ::epoll_create1(EPOLL_CLOEXEC);
+        pLoop->m_hWakeup = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+        if (pLoop->m_hEpoll == -1 || pLoop->m_hWakeup == -1)
+        {
+            std::cerr << "failed to create event loop, Error:" << errno << std::endl;
+            return false;
+        }
+
+        // a null data pointer identifies the wakeup descriptor
+        epoll_event ev = { 0 };
+        ev.events   = EPOLLIN;
+        ev.data.ptr = nullptr;
+        ::epoll_ctl(pLoop->m_hEpoll, EPOLL_CTL_ADD, pLoop->m_hWakeup, &ev);
+#endif
+        pLoop->m_pThread = new std::thread(&CNP_Reactor::Run, this, pLoop);
+    }
+
+    return true;
+};
+
+void CNP_Reactor::Stop(void) noexcept
+{
+    m_bTerminate = true;
+
+    for (auto& pLoop : m_vecLoops)
+    {
+        if (pLoop->m_pThread)
+        {
+#ifdef __linux__
+            uint64_t qwSignal = 1;
+            if (::write(pLoop->m_hWakeup, &qwSignal, sizeof(qwSignal)) < 0)
+                std::cerr << "failed to signal event loop, Error:" << errno << std::endl;
+#endif
+            pLoop->m_pThread->join();
+            delete pLoop->m_pThread;
+            pLoop->m_pThread = nullptr;
+        }
+    }
+
+    // lets any in-flight requests complete, nothing is queued after the loops exit
+    m_WorkerPool.Stop();
+    m_Dispatcher.Stop();
+
+    for (auto& pLoop : m_vecLoops)
+    {
+        for (auto& pConn : pLoop->m_setConnections)
+        {
+#ifdef __linux__
+            pConn->get_Socket().Shutdown(SHUT_RDWR);
+#elif _MSC_VER
+            pConn->get_Socket().Shutdown(SD_BOTH);
+#endif
+            delete pConn;
+        }
+        pLoop->m_setConnections.clear();
+
+#ifdef __linux__
+        if (pLoop->m_hWakeup != -1)
+            ::close(pLoop->m_hWakeup);
+        if (pLoop->m_hEpoll != -1)
+            ::close(pLoop->m_hEpoll);
+
+        pLoop->m_hWakeup = -1;
+        pLoop->m_hEpoll  = -1;
+#endif
+    }
+};
+
+bool CNP_Reactor::Attach(SOCKET hSocket, const sockaddr_in& remoteAddr)
+{
+    size_t          nLoop = m_nNextLoop++ % m_vecLoops.size();
+    EVENT_LOOP*     pLoop = m_vecLoops[nLoop];
+    CNP_Connection* pConn = AllocConnection();
+
+    pConn->Open(hSocket, remoteAddr, nLoop, &m_Dispatcher);
+
+    {
+        std::lock_guard<std::mutex> LoopLock(pLoop->m_Mutex);
+        pLoop->m_setConnections.insert(pConn);
+    }
+
+#ifdef __linux__
+    epoll_event ev = { 0 };
+    ev.events   = CONNECTION_EVENTS;
+    ev.data.ptr = pConn;
+
+    if (::epoll_ctl(pLoop->m_hEpoll, EPOLL_CTL_ADD, hSocket, &ev) == -1)
+    {
+        std::cerr << "failed to register connection, Error:" << errno << std::endl;
+
+        {
+            std::lock_guard<std::mutex> LoopLock(pLoop->m_Mutex);
+            pLoop->m_setConnections.erase(pConn);
+        }
+        pConn->get_Socket().Close();
+        ReleaseConnection(pConn);
+        return false;
+    }
+#endif
+
+    return true;
+};
+
+void CNP_Reactor::Detach(EVENT_LOOP* pLoop, CNP_Connection* pConn) noexcept
+{
+#ifdef __linux__
+    ::epoll_ctl(pLoop->m_hEpoll, EPOLL_CTL_DEL, pConn->get_Socket().get_Handle(), nullptr);
+#endif
+
+    {
+        std::lock_guard<std::mutex> LoopLock(pLoop->m_Mutex);
+        pLoop->m_setConnections.erase(pConn);
+    }
+
+    m_Dispatcher.Cancel(pConn);
+    pConn->OnClose();
+    ReleaseConnection(pConn);
+};
+
+void CNP_Reactor::Service(CNP_Connection* pConn)
+{
+    EVENT_LOOP* pLoop = m_vecLoops[pConn->get_EventLoop()];
+
+    do
+    {
+        // hang-ups & errors are reported by the subsequent receive
+        if (pConn->OnReadable() == false)
+        {
+            Detach(pLoop, pConn);
+            return;
+        }
+
+        // backed up output, the dispatcher calls Resume() once it has drained
+        if (pConn->PauseReading())
+            return;
+
+        // the output drained before reading could pause, the messages left
+        // buffered at its limit would otherwise wait on more data to arrive
+    } while (pConn->HasPendingRequests());
+
+    if (Arm(pLoop, pConn) == false)
+        Detach(pLoop, pConn);
+};
+
+void CNP_Reactor::Resume(CNP_Connection* pConn)
+{
+#ifdef __linux__
+    // the paused connection is unarmed, so no other worker can have it.
+    // Servicing it reads whatever was left in the socket & re-arms it.
+    m_WorkerPool.Submit(pConn);
+#else
+    // the event loop polls the connection again once it is no longer paused
+    UNREFERENCED_PARAMETER(pConn);
+#endif
+};
+
+bool CNP_Reactor::Arm(EVENT_LOOP* pLoop, CNP_Connection* pConn) noexcept
+{
+#ifdef __linux__
+    // re-arming must be the last access, another worker may pick the
+    // connection up as soon as it is
+    epoll_event ev = { 0 };
+    ev.events   = CONNECTION_EVENTS;
+    ev.data.ptr = pConn;
+
+    if (::epoll_ctl(pLoop->m_hEpoll, EPOLL_CTL_MOD, pConn->get_Socket().get_Handle(), &ev) == -1)
+    {
+        std::cerr << "failed to re-arm connection, Error:" << errno << std::endl;
+        return false;
+    }
+#else
+    UNREFERENCED_PARAMETER(pLoop);
+    UNREFERENCED_PARAMETER(pConn);
+#endif
+    return true;
+};
+
+CNP_Connection* CNP_Reactor::AllocConnection(void)
+{
+    {
+        std::lock_guard<std::mutex> FreeLock(m_FreeMutex);
+        if (!m_vecFreeList.empty())
+        {
+            CNP_Connection* pConn = m_vecFreeList.back();
+            m_vecFreeList.pop_back();
+            return pConn;
+        }
+    }
+
+    return new CNP_Connection();
+};
+
+void CNP_Reactor::ReleaseConnection(CNP_Connection* pConn) noexcept
+{
+    {
+        std::lock_guard<std::mutex> FreeLock(m_FreeMutex);
+        if (m_vecFreeList.size() < MAX_FREE_CONNECTIONS)
+        {
+            m_vecFreeList.push_back(pConn);
+            return;
+        }
+    }
+
+    delete pConn;
+};
+
+#ifdef __linux__
+
+void CNP_Reactor::Run(EVENT_LOOP* pLoop)
+{
+    std::cout << "Event loop ThreadID:" << GetThreadID() << std::endl;
+
+    epoll_event rgEvents[64];
+
+    while (m_bTerminate == false)
+    {
+        int nEvents = ::epoll_wait(pLoop->m_hEpoll, rgEvents, COUNTOF(rgEvents), -1);
+
+        if (nEvents == -1)
+        {
+            if (errno == EINTR)
+                continue;
+
+            std::cerr << "epoll_wait failed, Error:" << errno << std::endl;
+            break;
+        }
+
+        for (int i = 0; i < nEvents; i++)
+        {
+            CNP_Connection* pConn = static_cast<CNP_Connection*>(rgEvents[i].data.ptr);
+
+            if (pConn == nullptr)
+            {
+                // woken up by Stop(), drain the eventfd & recheck the terminate flag
+                uint64_t qwSignal;
+                while (::read(pLoop->m_hWakeup, &qwSignal, sizeof(qwSignal)) > 0)
+                    ;
+                continue;
+            }
+
+            m_WorkerPool.Submit(pConn);
+        }
+    }
+
+    std::cout << "Exiting ThreadID:" << GetThreadID() << std::endl;
+};
+
+#elif _MSC_VER
+
+void CNP_Reactor::Run(EVENT_LOOP* pLoop)
+{
+    std::cout << "Event loop ThreadID:" << GetThreadID() << std::endl;
+
+    std::vector<WSAPOLLFD>       vecPoll;
+    std::vector<CNP_Connection*> vecConns;
+    std::vector<CNP_Connection*> vecPending;
+
+    while (m_bTerminate == false)
+    {
+        vecPoll.clear();
+        vecConns.clear();
+        vecPending.clear();
+        {
+            std::lock_guard<std::mutex> LoopLock(pLoop->m_Mutex);
+            for (auto& pConn : pLoop->m_setConnections)
+            {
+                // the dispatcher has yet to drain a paused connection
+                if (pConn->IsReadPaused())
+                    continue;
+
+                // messages left buffered at the output limit need no more data
+                if (pConn->HasPendingRequests())
+                {
+                    vecPending.push_back(pConn);
+                    continue;
+                }
+
+                WSAPOLLFD pfd = { pConn->get_Socket().get_Handle(), POLLRDNORM, 0 };
+                vecPoll.push_back(pfd);
+                vecConns.push_back(pConn);
+            }
+        }
+
+        for (auto& pConn : vecPending)
+            Service(pConn);
+
+        if (vecPoll.empty())
+        {
+            if (vecPending.empty())
+                ::Sleep(50);
+            continue;
+        }
+
+        // level-triggered, time out periodically to pick up new connections
+        if (::WSAPoll(vecPoll.data(), static_cast<ULONG>(vecPoll.size()), 50) <= 0)
+            continue;
+
+        // WSAPoll is level-triggered only, so there is no one-shot hand-off
+        // to the worker pool, connections are serviced on the loop itself
+        for (size_t i = 0; i < vecPoll.size(); i++)
+        {
+            if (vecPoll[i].revents)
+                Service(vecConns[i]);
+        }
+    }
+
+    std::cout << "Exiting ThreadID:" << GetThreadID() << std::endl;
+};
+
+#endif
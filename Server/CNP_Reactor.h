@@ -0,0 +1,127 @@
+/**
+ * @file   CNP_Reactor.h
+ * @brief  CNP_Reactor class interface
+ *
+ * CNP_Reactor multiplexes all client connections over a small, fixed
+ * number of event loop threads (by default, one per core) instead of
+ * dedicating a thread to each connection.  On Linux each event loop
+ * waits on its own edge-triggered, one-shot epoll instance & hands
+ * ready connections to a bounded CNP_WorkerPool, the worker re-arming
+ * the connection once it has been drained.  Responses are written by a
+ * separate CNP_ResponseDispatcher stage, a connection whose output has
+ * backed up is left unarmed until the dispatcher has drained it.
+ * Closed connection contexts are recycled through a bounded free list.
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#if !defined(__CNP_REACTOR_H__)
+#define __CNP_REACTOR_H__
+
+#ifndef __CNP_SOCKET_H__
+    #include "CNP_Socket.h"
+#endif
+
+#ifndef __CNP_WORKER_POOL_H__
+    #include "CNP_WorkerPool.h"
+#endif
+
+#ifndef __CNP_RESPONSE_DISPATCHER_H__
+    #include "CNP_ResponseDispatcher.h"
+#endif
+
+#ifndef _ATOMIC_
+    #include <atomic>
+#endif
+
+#ifndef _MUTEX_
+    #include <mutex>
+#endif
+
+#ifndef _VECTOR_
+    #include <vector>
+#endif
+
+class CNP_Connection;
+
+class CNP_Reactor
+{
+    struct EVENT_LOOP;  ///< defined in the implementation
+
+    std::vector<EVENT_LOOP*>      m_vecLoops;
+    std::atomic<size_t>           m_nNextLoop;
+    std::atomic<bool>             m_bTerminate;
+    size_t                        m_nWorkers;
+    CNP_WorkerPool                m_WorkerPool;
+    size_t                        m_nWriters;
+    CNP_ResponseDispatcher        m_Dispatcher;
+    std::mutex                    m_FreeMutex;
+    std::vector<CNP_Connection*>  m_vecFreeList;  ///< closed contexts, guarded by m_FreeMutex
+
+public:
+/**
+    @brief Initialization Constructor
+
+    @param [in] nEventLoops   number of event loop threads to run, if 0
+                              then one per available hardware thread
+    @param [in] nWorkers      number of request worker threads to run, if 0
+                              then one per available hardware thread
+    @param [in] nWriters      number of response writer threads to run
+*/
+    explicit CNP_Reactor(size_t nEventLoops = 0, size_t nWorkers = 0, size_t nWriters = 1);
+
+    ~CNP_Reactor();
+
+/**
+    @brief Creates the event loops and starts their threads
+
+    @retval true  on success
+    @retval false on failure
+ */
+    bool   Start (void);
+
+/**
+    @brief Stops all event loop, worker & writer threads & closes every remaining connection
+ */
+    void   Stop  (void) noexcept;
+
+/**
+    @brief Hands an accepted socket over to the reactor
+
+    The reactor takes ownership of the socket handle, which is then
+    serviced by one of the event loops.
+
+    @param [in] hSocket      accepted socket handle
+    @param [in] remoteAddr   address of the connected peer
+
+    @retval true  on success
+    @retval false on failure, in which case the socket has been closed
+ */
+    bool   Attach(SOCKET hSocket, const sockaddr_in& remoteAddr);
+
+    inline size_t get_EventLoopCount(void) const noexcept
+    { return m_vecLoops.size(); };
+
+    inline size_t get_WorkerCount(void) const noexcept
+    { return m_WorkerPool.get_WorkerCount(); };
+
+    inline size_t get_WriterCount(void) const noexcept
+    { return m_Dispatcher.get_WriterCount(); };
+
+private:
+    void   Run    (EVENT_LOOP* pLoop);
+    void   Service(CNP_Connection* pConn);
+    void   Resume (CNP_Connection* pConn);
+    bool   Arm    (EVENT_LOOP* pLoop, CNP_Connection* pConn) noexcept;
+    void   Detach (EVENT_LOOP* pLoop, CNP_Connection* pConn) noexcept;
+
+    CNP_Connection* AllocConnection  (void);
+    void            ReleaseConnection(CNP_Connection* pConn) noexcept;
+
+    CNP_Reactor(const CNP_Reactor&);
+    CNP_Reactor& operator=(const CNP_Reactor&);
+};
+
+#endif
@@ -0,0 +1,379 @@
+/**
+ * @file   CNP_ResponseDispatcher.cpp
+ * @brief  CNP_ResponseDispatcher class implementation
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#ifdef __linux__
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+    #include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <iostream>
+
+#include "CNP_Connection.h"
+#include "CNP_Server.h"
+#include "CNP_ResponseDispatcher.h"
+
+#ifdef __linux__
+/// one-shot, a parked connection is moved back to the ready queue by the event
+static const uint32_t WRITABLE_EVENTS = EPOLLOUT | EPOLLONESHOT;
+#endif
+
+/**
+    A single writer thread, the connections scheduled on it & those
+    parked waiting for their socket to become writable.
+ */
+struct CNP_ResponseDispatcher::WRITER
+{
+#ifdef __linux__
+    int                          m_hEpoll;    ///< epoll instance the parked connections wait on
+    int                          m_hWakeup;   ///< eventfd used to interrupt epoll_wait
+#endif
+    std::thread*                 m_pThread;
+    std::mutex                   m_Mutex;
+    std::condition_variable      m_cvIdle;    ///< signaled whenever a write completes
+#ifdef _MSC_VER
+    std::condition_variable      m_cvReady;   ///< signaled whenever a connection is scheduled
+#endif
+    std::deque<CNP_Connection*>  m_queReady;  ///< connections to be written
+    std::set<CNP_Connection*>    m_setParked; ///< connections waiting to become writable
+    CNP_Connection*              m_pCurrent;  ///< connection being written
+    bool                         m_bSleeping; ///< the writer is waiting for events
+
+    WRITER(void) noexcept
+        :
+#ifdef __linux__
+          m_hEpoll (-1),
+          m_hWakeup(-1),
+#endif
+          m_pThread(nullptr),
+          m_pCurrent(nullptr),
+          m_bSleeping(false)
+    { };
+};
+
+
+CNP_ResponseDispatcher::CNP_ResponseDispatcher(const handler_type& fnResume)
+    : m_fnResume(fnResume),
+      m_vecWriters(),
+      m_bTerminate(false)
+{ };
+
+CNP_ResponseDispatcher::~CNP_ResponseDispatcher()
+{
+    Stop();
+
+    for (auto& it : m_vecWriters)
+        delete it;
+};
+
+bool CNP_ResponseDispatcher::Start(size_t nWriters)
+{
+    if (nWriters == 0)
+        nWriters = 1;
+
+    m_bTerminate = false;
+
+    for (size_t i = 0; i < nWriters; i++)
+    {
+        WRITER* pWriter = new WRITER();
+        m_vecWriters.push_back(pWriter);
+
+#ifdef __linux__
+        pWriter->m_hEpoll  = ::epoll_create1(EPOLL_CLOEXEC);
+        pWriter->m_hWakeup = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+        if (pWriter->m_hEpoll == -1 || pWriter->m_hWakeup == -1)
+        {
+            std::cerr << "failed to create response writer, Error:" << errno << std::endl;
+            return false;
+        }
+
+        // a null data pointer identifies the wakeup descriptor
+        epoll_event ev = { 0 };
+        ev.events   = EPOLLIN;
+        ev.data.ptr = nullptr;
+        ::epoll_ctl(pWriter->m_hEpoll, EPOLL_CTL_ADD, pWriter->m_hWakeup, &ev);
+#endif
+        pWriter->m_pThread = new std::thread(&CNP_ResponseDispatcher::Run, this, pWriter);
+    }
+
+    return true;
+};
+
+void CNP_ResponseDispatcher::Stop(void) noexcept
+{
+    m_bTerminate = true;
+
+    for (auto& pWriter : m_vecWriters)
+    {
+        if (pWriter->m_pThread)
+        {
+#ifdef __linux__
+            uint64_t qwSignal = 1;
+            if (::write(pWriter->m_hWakeup, &qwSignal, sizeof(qwSignal)) < 0)
+                std::cerr << "failed to signal response writer, Error:" << errno << std::endl;
+#elif _MSC_VER
+            {
+                std::lock_guard<std::mutex> WriterLock(pWriter->m_Mutex);
+                pWriter->m_cvReady.notify_all();
+            }
+#endif
+            pWriter->m_pThread->join();
+            delete pWriter->m_pThread;
+            pWriter->m_pThread = nullptr;
+        }
+
+        pWriter->m_queReady.clear();
+        pWriter->m_setParked.clear();
+
+#ifdef __linux__
+        if (pWriter->m_hWakeup != -1)
+            ::close(pWriter->m_hWakeup);
+        if (pWriter->m_hEpoll != -1)
+            ::close(pWriter->m_hEpoll);
+
+        pWriter->m_hWakeup = -1;
+        pWriter->m_hEpoll  = -1;
+#endif
+    }
+};
+
+CNP_ResponseDispatcher::WRITER* CNP_ResponseDispatcher::get_Writer(const CNP_Connection* pConn) const noexcept
+{
+    return m_vecWriters[pConn->get_EventLoop() % m_vecWriters.size()];
+};
+
+void CNP_ResponseDispatcher::Schedule(CNP_Connection* pConn)
+{
+    WRITER* pWriter = get_Writer(pConn);
+    bool    bWakeup = false;
+
+    {
+        std::lock_guard<std::mutex> WriterLock(pWriter->m_Mutex);
+        pWriter->m_queReady.push_back(pConn);
+
+        bWakeup = pWriter->m_bSleeping;
+        pWriter->m_bSleeping = false;
+    }
+
+    if (bWakeup)
+    {
+#ifdef __linux__
+        uint64_t qwSignal = 1;
+        if (::write(pWriter->m_hWakeup, &qwSignal, sizeof(qwSignal)) < 0)
+            std::cerr << "failed to signal response writer, Error:" << errno << std::endl;
+#elif _MSC_VER
+        pWriter->m_cvReady.notify_one();
+#endif
+    }
+};
+
+void CNP_ResponseDispatcher::Cancel(CNP_Connection* pConn) noexcept
+{
+    WRITER* pWriter = get_Writer(pConn);
+
+    std::unique_lock<std::mutex> WriterLock(pWriter->m_Mutex);
+
+    // a write in progress may park the connection again, so it is waited
+    // for before the connection is removed, under the same lock
+    pWriter->m_cvIdle.wait(WriterLock, [pWriter, pConn]() { return pWriter->m_pCurrent != pConn; });
+
+    auto itR = std::find(pWriter->m_queReady.begin(), pWriter->m_queReady.end(), pConn);
+    if (itR != pWriter->m_queReady.end())
+        pWriter->m_queReady.erase(itR);
+
+    if (pWriter->m_setParked.erase(pConn) > 0)
+    {
+#ifdef __linux__
+        ::epoll_ctl(pWriter->m_hEpoll, EPOLL_CTL_DEL, pConn->get_Socket().get_Handle(), nullptr);
+#endif
+    }
+};
+
+void CNP_ResponseDispatcher::Write(WRITER* pWriter, CNP_Connection* pConn)
+{
+    bool bResume = false;
+
+    if (pConn->WriteOutput(bResume) == CNP_Connection::WR_BLOCKED)
+    {
+        // parked before arming, the event may fire immediately
+        {
+            std::lock_guard<std::mutex> WriterLock(pWriter->m_Mutex);
+            pWriter->m_setParked.insert(pConn);
+        }
+
+#ifdef __linux__
+        epoll_event ev = { 0 };
+        ev.events   = WRITABLE_EVENTS;
+        ev.data.ptr = pConn;
+
+        SOCKET hSocket = pConn->get_Socket().get_Handle();
+
+        if (::epoll_ctl(pWriter->m_hEpoll, EPOLL_CTL_MOD, hSocket, &ev) == -1 &&
+            ::epoll_ctl(pWriter->m_hEpoll, EPOLL_CTL_ADD, hSocket, &ev) == -1)
+        {
+            std::cerr << "failed to wait for writability, Error:" << errno << std::endl;
+        }
+#endif
+    }
+
+    // the connection may be closed as soon as reading resumes, so this
+    // must happen while it is still marked as being written
+    if (bResume)
+        m_fnResume(pConn);
+};
+
+#ifdef __linux__
+
+void CNP_ResponseDispatcher::Run(WRITER* pWriter)
+{
+    std::cout << "Writer ThreadID:" << GetThreadID() << std::endl;
+
+    epoll_event rgEvents[64];
+
+    while (m_bTerminate == false)
+    {
+        // write out every scheduled connection before waiting
+        for (;;)
+        {
+            CNP_Connection* pConn = nullptr;
+            {
+                std::lock_guard<std::mutex> WriterLock(pWriter->m_Mutex);
+                if (pWriter->m_queReady.empty())
+                {
+                    pWriter->m_bSleeping = true;
+                    break;
+                }
+
+                pConn = pWriter->m_queReady.front();
+                pWriter->m_queReady.pop_front();
+                pWriter->m_pCurrent = pConn;
+            }
+
+            Write(pWriter, pConn);
+
+            {
+                std::lock_guard<std::mutex> WriterLock(pWriter->m_Mutex);
+                pWriter->m_pCurrent = nullptr;
+            }
+            pWriter->m_cvIdle.notify_all();
+        }
+
+        int nEvents = ::epoll_wait(pWriter->m_hEpoll, rgEvents, COUNTOF(rgEvents), -1);
+
+        if (nEvents == -1)
+        {
+            if (errno == EINTR)
+                continue;
+
+            std::cerr << "epoll_wait failed, Error:" << errno << std::endl;
+            break;
+        }
+
+        std::lock_guard<std::mutex> WriterLock(pWriter->m_Mutex);
+        pWriter->m_bSleeping = false;
+
+        for (int i = 0; i < nEvents; i++)
+        {
+            CNP_Connection* pConn = static_cast<CNP_Connection*>(rgEvents[i].data.ptr);
+
+            if (pConn == nullptr)
+            {
+                uint64_t qwSignal;
+                while (::read(pWriter->m_hWakeup, &qwSignal, sizeof(qwSignal)) > 0)
+                    ;
+                continue;
+            }
+
+            // a connection cancelled after the event was reported is no longer parked
+            if (pWriter->m_setParked.erase(pConn) > 0)
+                pWriter->m_queReady.push_back(pConn);
+        }
+    }
+
+    std::cout << "Exiting ThreadID:" << GetThreadID() << std::endl;
+};
+
+#elif _MSC_VER
+
+void CNP_ResponseDispatcher::Run(WRITER* pWriter)
+{
+    std::cout << "Writer ThreadID:" << GetThreadID() << std::endl;
+
+    std::vector<WSAPOLLFD>       vecPoll;
+    std::vector<CNP_Connection*> vecConns;
+
+    while (m_bTerminate == false)
+    {
+        for (;;)
+        {
+            CNP_Connection* pConn = nullptr;
+            {
+                std::lock_guard<std::mutex> WriterLock(pWriter->m_Mutex);
+                if (pWriter->m_queReady.empty())
+                    break;
+
+                pConn = pWriter->m_queReady.front();
+                pWriter->m_queReady.pop_front();
+                pWriter->m_pCurrent = pConn;
+            }
+
+            Write(pWriter, pConn);
+
+            {
+                std::lock_guard<std::mutex> WriterLock(pWriter->m_Mutex);
+                pWriter->m_pCurrent = nullptr;
+            }
+            pWriter->m_cvIdle.notify_all();
+        }
+
+        vecPoll.clear();
+        vecConns.clear();
+        {
+            std::unique_lock<std::mutex> WriterLock(pWriter->m_Mutex);
+            if (pWriter->m_setParked.empty())
+            {
+                // nothing parked, sleep until a connection is scheduled
+                pWriter->m_bSleeping = true;
+                pWriter->m_cvReady.wait_for(WriterLock, std::chrono::milliseconds(50),
+                    [this, pWriter]() { return m_bTerminate || !pWriter->m_queReady.empty(); });
+                pWriter->m_bSleeping = false;
+                continue;
+            }
+
+            for (auto& pConn : pWriter->m_setParked)
+            {
+                WSAPOLLFD pfd = { pConn->get_Socket().get_Handle(), POLLWRNORM, 0 };
+                vecPoll.push_back(pfd);
+                vecConns.push_back(pConn);
+            }
+        }
+
+        // WSAPoll cannot be interrupted, so poll briefly for newly scheduled connections
+        if (::WSAPoll(vecPoll.data(), static_cast<ULONG>(vecPoll.size()), 10) <= 0)
+            continue;
+
+        std::lock_guard<std::mutex> WriterLock(pWriter->m_Mutex);
+        for (size_t i = 0; i < vecPoll.size(); i++)
+        {
+            if (vecPoll[i].revents && pWriter->m_setParked.erase(vecConns[i]) > 0)
+                pWriter->m_queReady.push_back(vecConns[i]);
+        }
+    }
+
+    std::cout << "Exiting ThreadID:" << GetThreadID() << std::endl;
+};
+
+#endif
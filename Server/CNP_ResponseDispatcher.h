@@ -0,0 +1,102 @@
+/**
+ * @file   CNP_ResponseDispatcher.h
+ * @brief  CNP_ResponseDispatcher class interface
+ *
+ * CNP_ResponseDispatcher is the reactor's outbound stage.  The workers
+ * only queue responses on their connection & schedule it here, one or
+ * more writer threads then write the queued output to the non-blocking
+ * sockets.  A connection whose socket would block is parked until it
+ * becomes writable again, so a slow client only ever delays itself.
+ * When a connection's queued output has drained below its low watermark
+ * the reactor is asked to resume reading from it.
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#if !defined(__CNP_RESPONSE_DISPATCHER_H__)
+#define __CNP_RESPONSE_DISPATCHER_H__
+
+#ifndef _ATOMIC_
+    #include <atomic>
+#endif
+
+#ifndef _FUNCTIONAL_
+    #include <functional>
+#endif
+
+#ifndef _VECTOR_
+    #include <vector>
+#endif
+
+class CNP_Connection;
+
+class CNP_ResponseDispatcher
+{
+public:
+    typedef std::function<void (CNP_Connection*)>  handler_type;
+
+private:
+    struct WRITER;  ///< defined in the implementation
+
+    handler_type            m_fnResume;
+    std::vector<WRITER*>    m_vecWriters;
+    std::atomic<bool>       m_bTerminate;
+
+public:
+/**
+    @brief Initialization Constructor
+
+    @param [in] fnResume   invoked on a writer thread when a connection
+                           whose reading was paused may be read again
+*/
+    explicit CNP_ResponseDispatcher(const handler_type& fnResume);
+
+    ~CNP_ResponseDispatcher();
+
+/**
+    @brief Starts the writer threads
+
+    @param [in] nWriters   number of writer threads, at least 1
+
+    @retval true  on success
+    @retval false on failure
+ */
+    bool   Start   (size_t nWriters);
+
+/**
+    @brief Stops the writer threads, any unwritten output is left queued
+ */
+    void   Stop    (void) noexcept;
+
+/**
+    @brief Queues a connection with pending output for writing
+
+    A connection must not be scheduled again until its writer has found
+    its output empty, CNP_Connection tracks this itself.
+ */
+    void   Schedule(CNP_Connection* pConn);
+
+/**
+    @brief Removes every reference to a connection that is being closed
+
+    Waits for a write to the connection that is already in progress to
+    complete, after which the connection may be released.
+ */
+    void   Cancel  (CNP_Connection* pConn) noexcept;
+
+    inline size_t get_WriterCount(void) const noexcept
+    { return m_vecWriters.size(); };
+
+private:
+    void   Run     (WRITER* pWriter);
+    void   Write   (WRITER* pWriter, CNP_Connection* pConn);
+
+    WRITER* get_Writer(const CNP_Connection* pConn) const noexcept;
+
+    CNP_ResponseDispatcher(const CNP_ResponseDispatcher&);
+    CNP_ResponseDispatcher& operator=(const CNP_ResponseDispatcher&);
+};
+
+#endif
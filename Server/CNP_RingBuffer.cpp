@@ -0,0 +1,122 @@
+/**
+ * @file   CNP_RingBuffer.cpp
+ * @brief  CNP_RingBuffer class implementation
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#include <string.h>
+
+#include "CNP_RingBuffer.h"
+
+/// rounds cbValue up to the next power of 2
+static size_t RoundUpPow2(size_t cbValue) noexcept
+{
+    size_t cbResult = 1;
+    while (cbResult < cbValue)
+        cbResult <<= 1;
+
+    return cbResult;
+}
+
+CNP_RingBuffer::CNP_RingBuffer(size_t cbCapacity /* = 2048 */)
+    : m_vecData(RoundUpPow2(cbCapacity)),
+      m_nHead(0),
+      m_nTail(0)
+{ };
+
+void CNP_RingBuffer::Reserve(size_t cbCapacity)
+{
+    if (cbCapacity <= get_Capacity())
+        return;
+
+    std::vector<char> vecData(RoundUpPow2(cbCapacity));
+    size_t            cbSize = get_Size();
+
+    Peek(vecData.data(), cbSize);
+
+    m_vecData.swap(vecData);
+    m_nHead = 0;
+    m_nTail = cbSize;
+};
+
+size_t CNP_RingBuffer::get_WriteSpan(char*& pData) noexcept
+{
+    size_t nMask   = get_Capacity() - 1;
+    size_t nOffset = m_nTail & nMask;
+
+    pData = m_vecData.data() + nOffset;
+
+    // up to the end of the storage or the unread data, whichever is first
+    size_t cbToEnd = get_Capacity() - nOffset;
+    size_t cbFree  = get_Free();
+
+    return (cbFree < cbToEnd) ? cbFree : cbToEnd;
+};
+
+void CNP_RingBuffer::Commit(size_t cbLen) noexcept
+{
+    m_nTail += cbLen;
+};
+
+void CNP_RingBuffer::Write(const void* pData, size_t cbLen)
+{
+    if (cbLen > get_Free())
+        Reserve(get_Size() + cbLen);
+
+    const char* pSrc = static_cast<const char*>(pData);
+
+    // at most two spans, the second one wrapping to the start of the storage
+    while (cbLen > 0)
+    {
+        char*  pDest  = nullptr;
+        size_t cbSpan = get_WriteSpan(pDest);
+        if (cbSpan > cbLen)
+            cbSpan = cbLen;
+
+        memcpy(pDest, pSrc, cbSpan);
+        Commit(cbSpan);
+
+        pSrc  += cbSpan;
+        cbLen -= cbSpan;
+    }
+};
+
+size_t CNP_RingBuffer::get_ReadSpan(const char*& pData) const noexcept
+{
+    size_t nMask   = get_Capacity() - 1;
+    size_t nOffset = m_nHead & nMask;
+
+    pData = m_vecData.data() + nOffset;
+
+    size_t cbToEnd = get_Capacity() - nOffset;
+    size_t cbSize  = get_Size();
+
+    return (cbSize < cbToEnd) ? cbSize : cbToEnd;
+};
+
+void CNP_RingBuffer::Peek(void* pDest, size_t cbLen) const noexcept
+{
+    const char* pData   = nullptr;
+    size_t      cbFirst = get_ReadSpan(pData);
+
+    if (cbFirst > cbLen)
+        cbFirst = cbLen;
+
+    memcpy(pDest, pData, cbFirst);
+
+    // remainder wraps around to the start of the storage
+    if (cbLen > cbFirst)
+        memcpy(static_cast<char*>(pDest) + cbFirst, m_vecData.data(), cbLen - cbFirst);
+};
+
+void CNP_RingBuffer::Consume(size_t cbLen) noexcept
+{
+    m_nHead += cbLen;
+
+    // restart at the beginning of the storage, keeping spans as large as possible
+    if (m_nHead == m_nTail)
+        m_nHead = m_nTail = 0;
+};
@@ -0,0 +1,106 @@
+/**
+ * @file   CNP_RingBuffer.h
+ * @brief  CNP_RingBuffer class interface
+ *
+ * CNP_RingBuffer is a growable byte ring buffer used to accumulate a
+ * connection's received stream until complete messages can be framed
+ * out of it.  The capacity is always a power of 2, so wrapping is a
+ * simple mask of the monotonically increasing read & write counts.
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#if !defined(__CNP_RING_BUFFER_H__)
+#define __CNP_RING_BUFFER_H__
+
+#include <stddef.h>
+
+#ifndef _VECTOR_
+    #include <vector>
+#endif
+
+class CNP_RingBuffer
+{
+    std::vector<char>  m_vecData;
+    size_t             m_nHead;   ///< total bytes consumed
+    size_t             m_nTail;   ///< total bytes committed
+
+public:
+/**
+    @brief Initialization Constructor
+
+    @param [in] cbCapacity   initial capacity, rounded up to a power of 2
+*/
+    explicit CNP_RingBuffer(size_t cbCapacity = 2048);
+
+/**
+    @retval size_t containing the number of bytes available to be read
+ */
+    inline size_t get_Size(void) const noexcept
+    { return m_nTail - m_nHead; };
+
+    inline size_t get_Capacity(void) const noexcept
+    { return m_vecData.size(); };
+
+    inline size_t get_Free(void) const noexcept
+    { return get_Capacity() - get_Size(); };
+
+    inline bool   IsEmpty(void) const noexcept
+    { return m_nTail == m_nHead; };
+
+/**
+    @brief Discards any buffered data
+ */
+    inline void   Clear(void) noexcept
+    { m_nHead = m_nTail = 0; };
+
+/**
+    @brief Grows the buffer to hold at least cbCapacity bytes, preserving
+           its contents.  Never shrinks the buffer.
+ */
+    void   Reserve     (size_t cbCapacity);
+
+/**
+    @brief Retrieves the largest contiguous free region following the
+           buffered data, suitable for receiving directly into
+
+    @param [out] pData   receives the address of the free region
+
+    @retval size_t containing the length of the region, 0 if full
+ */
+    size_t get_WriteSpan(char*& pData) noexcept;
+
+/**
+    @brief Appends cbLen bytes previously written into the write span
+ */
+    void   Commit      (size_t cbLen) noexcept;
+
+/**
+    @brief Appends a copy of cbLen bytes, growing the buffer as needed
+ */
+    void   Write       (const void* pData, size_t cbLen);
+
+/**
+    @brief Retrieves the contiguous region at the front of the buffered data
+
+    @param [out] pData   receives the address of the region
+
+    @retval size_t containing the length of the region, 0 if empty
+ */
+    size_t get_ReadSpan(const char*& pData) const noexcept;
+
+/**
+    @brief Copies cbLen bytes from the front of the buffered data, without
+           consuming them.  cbLen must not exceed get_Size().
+ */
+    void   Peek        (void* pDest, size_t cbLen) const noexcept;
+
+/**
+    @brief Discards cbLen bytes from the front of the buffered data
+ */
+    void   Consume     (size_t cbLen) noexcept;
+};
+
+#endif
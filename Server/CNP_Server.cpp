@@ -15,14 +15,18 @@
 #include <errno.h>
 
 #include <atomic>
-#include <thread>
-#include <list>
 #include <iostream>
 
 #include "CNP_ServerDB.h"
+#include "CNP_Config.h"
+#include "CNP_Logger.h"
+#include "CNP_Metrics.h"
+#include "CNP_AdminEndpoint.h"
 #include "CNP_Socket.h"
-#include "CNP_Messaging.h"
-#include "CNP_Session.h"
+#include "CNP_Connection.h"
+#include "CNP_Reactor.h"
+#include "CNP_Acceptor.h"
+#include "CNP_UringReactor.h"
 #include "CNP_Server.h"
 
 #ifdef __linux__
@@ -50,128 +54,84 @@ DWORD GetThreadID( void ) noexcept
 
 #endif
 
+void TerminateHandler(int /*iSignal*/) noexcept
+{
+    g_bTerminate = true;
+}
+
+#ifdef __linux__
+/// termination signals & SIGUSR2, blocked in every thread & waited for by the main thread
+static sigset_t g_sigTerminate;
+#endif
+
 /**
-   A basic data-structure passed to the thread function
+    Blocks the main thread until a termination signal is received,
+    dumping the metrics on each SIGUSR2 meanwhile
  */
-struct THREAD_INFO
+static void WaitForTermination(void)
 {
-    std::atomic<bool>    m_bTerminate;
-    CNP_Socket*          m_pSocket;
-    std::thread*         m_pThread;
-
-    THREAD_INFO(void) noexcept
-        : m_bTerminate(false),
-          m_pSocket(nullptr),
-          m_pThread(nullptr)
-    { };
-
-    ~THREAD_INFO(void)
-    { 
-      if (m_pSocket)
-         delete m_pSocket; 
-      if (m_pThread)
-          delete m_pThread;
-    };
-
-private:
-// Cannot afford for these guys to accidentally
-// get invoked or allow shallow copies since
-// the destructor is deleting associated member
-// pointer memory
-    THREAD_INFO(const THREAD_INFO&);
-    THREAD_INFO& operator=(const THREAD_INFO&);
-};
+#ifdef __linux__
+    int iSignal = 0;
+    while (g_bTerminate == false)
+    {
+        if (sigwait(&g_sigTerminate, &iSignal) != 0)
+            continue;
 
+        if (iSignal == SIGUSR2)
+            g_Metrics.Dump(stdout);
+        else
+            TerminateHandler(iSignal);
+    }
+#elif _MSC_VER
+    while (g_bTerminate == false)
+        ::Sleep(500);
+#endif
+    std::cout << std::endl << "Caught signal, attempting graceful shutdown" << std::endl;
+}
 
-void ClientThreadHandler(void* pData)
+/**
+    Services client connections with the epoll based CNP_Acceptor & CNP_Reactor
+    until terminated
+ */
+static void RunServer(const SERVER_CONFIG& Config, unsigned short wPort)
 {
-    THREAD_INFO*  pInfo    = static_cast<THREAD_INFO*>(pData);
-    std::cout << __FUNCTION__ << " ThreadID:" << GetThreadID() << std::endl;
-    bool bResult           = false;
-    cnp::WORD wClientID    = cnp::INVALID_CLIENT_ID;
+    // client connections are multiplexed by the reactor's event loops,
+    // their requests processed by its worker pool & the responses
+    // written by its response dispatcher
+    CNP_Reactor Reactor(Config.m_nEventLoops, Config.m_nWorkers, Config.m_nWriters);
 
-    CNP_Socket*   pSocket  = pInfo->m_pSocket;
+    if (Reactor.Start())
+        std::cout << "Servicing connections on " << Reactor.get_EventLoopCount() 
+                  << " event loop(s), " << Reactor.get_WorkerCount() << " worker(s), "
+                  << Reactor.get_WriterCount() << " writer(s)" << std::endl;
 
-    char rgBuffer[2048] = { 0 };
+    CNP_Acceptor Acceptor(Reactor);
 
-    while (pInfo->m_bTerminate == false)
-    {
-        int cbMsgLen = pSocket->Receive(rgBuffer, sizeof(rgBuffer) - 1);
-
-        if ( cbMsgLen == SOCKET_ERROR )
-        {
-            if ( pSocket->WouldBlock() || pSocket->Interrupted() )
-            {
-            // these are safe to ignore and try again
-            }
-        }
-        else if (( cbMsgLen == 0 ) || (cbMsgLen == SOCKET_ERROR))
-        {
-            // Client has disconnected or terminated
-            ProcessDisconnect(wClientID);
-            pSocket->Close();
-            pInfo->m_bTerminate = true;
-        }
-        else if (( cbMsgLen > 0 ) && ( cbMsgLen != SOCKET_ERROR ))
-        {
-            // typecast the buffer to STD_HDR to give easy access to helper methods
-            cnp::STD_HDR* pHdr = reinterpret_cast<cnp::STD_HDR*>( rgBuffer );
-
-            switch (pHdr->get_MsgType())
-            {
-                case  cnp::MT_CONNECT_REQUEST:
-                    wClientID = ProcessConnectRequest(rgBuffer, cbMsgLen, pSocket);
-                    break;
-
-                case cnp::MT_CREATE_ACCOUNT_REQUEST:
-                    bResult = ProcessCreateAccountRequest(rgBuffer, cbMsgLen);
-                    break;
-
-                case cnp::MT_LOGON_REQUEST:
-                    bResult = ProcessLogonRequest(rgBuffer, cbMsgLen);
-                    break;
-
-                case cnp::MT_LOGOFF_REQUEST:
-                    bResult = ProcessLogoffRequest(rgBuffer, cbMsgLen);
-                    break;
-
-                case cnp::MT_DEPOSIT_REQUEST:
-                    bResult = ProcessDepositRequest(rgBuffer, cbMsgLen);
-                    break;
-
-                case cnp::MT_WITHDRAWAL_REQUEST:
-                    bResult = ProcessWithdrawalRequest(rgBuffer, cbMsgLen);
-                    break;
-
-                case cnp::MT_BALANCE_QUERY_REQUEST:
-                    bResult = ProcessBalanceQueryRequest(rgBuffer, cbMsgLen);
-                    break;
-
-                case cnp::MT_TRANSACTION_QUERY_REQUEST:
-                    bResult = ProcessTransactionQueryRequest(rgBuffer, cbMsgLen);
-                    break;
-
-                case cnp::MT_PURCHASE_STAMPS_REQUEST:
-                    bResult = ProcessStampPurchaseRequest(rgBuffer, cbMsgLen);
-                    break;
-
-                default:
-                    // invalid message
-                    break;
-            }
-        }
-#ifdef _MSC_VER
-        ::Sleep(250);
-#endif
-    }
+    if (Acceptor.Start(wPort, Config.m_iBackLog, Config.m_nListeners, Config.m_bReusePort))
+        WaitForTermination();
+    else
+        std::cerr << "failed to start listening on Port:" << wPort << std::endl;
 
-    std::cout << "Exiting ThreadID:" << GetThreadID() << std::endl;
-};
+    Acceptor.Stop();
+    Reactor.Stop();
+}
 
-void TerminateHandler(int /*iSignal*/) noexcept
+#ifdef __linux__
+/**
+    Services client connections with the io_uring transport until terminated
+ */
+static void RunUringServer(const SERVER_CONFIG& Config, unsigned short wPort)
 {
-    g_bTerminate = true;
+    CNP_UringReactor Reactor(Config.m_nEventLoops);
+
+    if (Reactor.Start(wPort, Config.m_iBackLog, Config.m_bReusePort))
+        WaitForTermination();
+    else
+        std::cerr << "failed to start listening on Port:" << wPort << std::endl;
+
+    Reactor.Stop();
 }
+#endif
 
 #ifdef _MSC_VER
 BOOL CtrlHandler( DWORD fdwCtrlType ) noexcept
@@ -210,15 +170,23 @@ BOOL CtrlHandler( DWORD fdwCtrlType ) noexcept
 
 int main(int argc, char *argv[])
 {
+    SERVER_CONFIG Config;
 
+    if (ParseServerConfig(argc, argv, Config) == false)
+        return 1;
 
 #ifdef __linux__
-    if (signal(SIGUSR1, TerminateHandler) == SIG_ERR)
-        printf("\ncan't catch SIGUSR1\n");
-    if (signal(SIGTERM, TerminateHandler) == SIG_ERR)
-        printf("\ncan't catch SIGSTOP\n");
-    if (signal(SIGINT, TerminateHandler) == SIG_ERR)
-        printf("\ncan't catch SIGSTOP\n");
+    // block the termination signals in every thread, the main thread
+    // then waits for them synchronously with sigwait(), so this must
+    // precede starting any thread, which inherits the mask
+    sigemptyset(&g_sigTerminate);
+    sigaddset(&g_sigTerminate, SIGUSR1);
+    sigaddset(&g_sigTerminate, SIGTERM);
+    sigaddset(&g_sigTerminate, SIGINT);
+    sigaddset(&g_sigTerminate, SIGUSR2);
+
+    if (pthread_sigmask(SIG_BLOCK, &g_sigTerminate, nullptr) != 0)
+        printf("\ncan't block termination signals\n");
 
 #elif _MSC_VER
 
@@ -246,76 +214,60 @@ int main(int argc, char *argv[])
 
 #endif
 
-// attempt to load persistent server data.
+    g_Logger.Start(stdout, Config.m_iTraceLevel, Config.m_ulTraceSample);
+
+// attempt to load persistent server data, then log every change made to it
+    ConfigureLedger(Config.m_nLedgerHot, Config.m_cbLedgerCache);
     LoadServerDB();
 
-    std::list<THREAD_INFO*> lstClientThreadInfo;
+    if (OpenServerLog(static_cast<CNP_WriteAheadLog::SYNC_MODE>(Config.m_iLogMode), Config.m_ulLogDelay) == false)
+        return 1;
 
-    unsigned short wPort;
-   
-    std::cout << "Enter Server [Listening] Port:";
-    std::cin  >> wPort;
+    StartCheckpointThread(Config.m_ulCheckpoint);
 
-    CNP_Socket SvrSocket;
-    
-    if (SvrSocket.Create(wPort))
-        std::cout << "Server Listening Socket created on Port:" << wPort << std::endl;
+    unsigned short wPort = Config.m_wPort;
 
-    if (SvrSocket.Listen(10))
-        std::cout << "Listening for connections" << std::endl;
+    if (wPort == 0)
+    {
+        std::cout << "Enter Server [Listening] Port:";
+        std::cin  >> wPort;
+    }
 
-    SvrSocket.SetBlocking(false);
+    CNP_AdminEndpoint AdminEndpoint;
 
-    SOCKET      hNewSocket = INVALID_SOCKET;
-    sockaddr_in remoteAddr;
+    if (Config.m_wAdminPort != 0)
+        AdminEndpoint.Start(Config.m_wAdminPort);
 
-    while (g_bTerminate == false)
-    {
-        if (SvrSocket.Accept(hNewSocket, remoteAddr))
-        {
-            std::cout << "Accepting a new connection" << std::endl;
-            std::cout << "--------------------------" << std::endl;
+    // responses generated in a read cycle are coalesced up to these limits
+    CNP_Connection::SetBatchLimits(Config.m_cbMaxBatch, Config.m_ulMaxBatchDelay);
+    CNP_Connection::SetOutputLimit(Config.m_cbMaxOutput);
+    CNP_Connection::SetZeroCopyLimit(Config.m_cbZeroCopyMin);
 
-            THREAD_INFO* pInfo        = new THREAD_INFO();
+    bool bIoUring = false;
 
-            pInfo->m_pSocket          = new CNP_Socket(hNewSocket, remoteAddr);
 #ifdef __linux__
-            pInfo->m_pSocket->SetSocketRecvTimeout(0, 500);
-#elif _MSC_VER
-            pInfo->m_pSocket->SetSocketRecvTimeout(500);
-#endif
-            pInfo->m_pThread          = new std::thread(ClientThreadHandler, pInfo);
-
-            lstClientThreadInfo.push_front(pInfo);
-        }
-        else if (!SvrSocket.WouldBlock())
-        {
-            std::cerr << "failed to accept new connection" << std::endl;
-        }
-        else
-        {
-#ifdef _MSC_VER
-            ::Sleep(500);
-#endif
-        }
-    }
-    
-    std::cout << std::endl << "Caught signal, attempting graceful shutdown" << std::endl;
-    for (auto& it : lstClientThreadInfo)
+    if (Config.m_bIoUring)
     {
-        it->m_bTerminate = true;
-        it->m_pThread->join();
-#ifdef __linux__
-        it->m_pSocket->Shutdown(SHUT_RDWR);
-#elif _MSC_VER
-        it->m_pSocket->Shutdown(SD_BOTH);
-#endif
-        delete it;
+        bIoUring = CNP_UringReactor::IsSupported();
+        if (bIoUring == false)
+            std::cerr << "io_uring is not supported by this kernel, falling back to epoll" << std::endl;
     }
 
-    SvrSocket.Close();
+    if (bIoUring)
+        RunUringServer(Config, wPort);
+#endif
+
+    if (bIoUring == false)
+        RunServer(Config, wPort);
+
+    AdminEndpoint.Stop();
+
+    StopCheckpointThread();
+    CloseServerLog();
     SaveServerDB();
 
+    g_Logger.Stop();
+
 #ifdef _MSC_VER
     WSACleanup();
 #endif
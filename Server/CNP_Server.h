@@ -9,4 +9,17 @@
     #include "CNP_Common.h"
 #endif
 
+#ifdef __linux__
+    #include <sys/types.h>
+
+/// @retval pid_t  containing the kernel thread ID of the calling thread
+pid_t GetThreadID( void );
+
+#elif _MSC_VER
+
+/// @retval DWORD  containing the thread ID of the calling thread
+DWORD GetThreadID( void ) noexcept;
+
+#endif
+
 #endif
\ No newline at end of file
@@ -8,20 +8,79 @@
  * 
  */
 
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __linux__
+    #include <sys/syscall.h>
+    #include <sys/wait.h>
+    #include <unistd.h>
+#elif _MSC_VER
+    #include <io.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
 #include <fstream>
+#include <functional>
 #include <istream>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "FNV1A_Hash.h"
 #include "CNP_ServerDB.h"
+#include "CNP_AccountStore.h"
+#include "CNP_MappedFile.h"
+#include "CNP_LedgerSegment.h"
+#include "CNP_TransactionLedger.h"
 
 /// File name of server ACCOUNT_INFO table store
 const char g_szAccountDBFileName[]    = "..//Data//AccountDB.Dat";
 /// File name of server TRANSACTION_INFO table store
 const char g_szTransactDBFileName[]   = "..//Data//TransactDB.Dat";
+/// File name of server write-ahead log
+const char g_szServerLogFileName[]    = "..//Data//ServerDB.Wal";
+/// Directory of the sealed ledger segments, named Ledger-<first ID>.Seg
+const char g_szLedgerDirectory[]      = "..//Data";
+
+CNP_AccountStore             g_AccountInfo;
+CNP_TransactionLedger        g_TransactionLedger;
+CustomerTransactionIndex_t   g_CustomerTransactions;
+CNP_WriteAheadLog            g_ServerLog;
+
+extern std::mutex            g_TransactionMutex;
 
-AccountMap_t                 g_AccountInfo;
-TransactionMap_t             g_TransactionInfo;
+/// declared ahead of the segments, which evict their blocks from it when destroyed
+static CNP_BlockCache                                   g_LedgerCache;
+/// guards the segment list, taken ahead of g_TransactionMutex
+static std::shared_mutex                                g_LedgerMutex;
+static std::vector<std::unique_ptr<CNP_LedgerSegment> > g_vecLedgerSegments;
+static cnp::DWORD                                       g_dwLastSealedID    = 0;   ///< guarded by g_LedgerMutex
+static size_t                                           g_nHotTransactions  = 0;
+/// highest transaction ID once the database was loaded, an ID up to it
+/// that is not held was lost with its transaction & never will be
+static cnp::DWORD                                       g_dwRecoveredID     = 0;
+
+static std::thread*            g_pCheckpointThread = nullptr;
+static std::mutex              g_CheckpointMutex;
+static std::condition_variable g_cvCheckpoint;
+static bool                    g_bCheckpointStop   = false;   ///< guarded by g_CheckpointMutex
+
+/// a table is only split into ranges, each loaded or saved by its own thread, above this
+static const size_t MIN_RECORDS_PER_RANGE = 256 * 1024;
+/// size of the buffer each range's records are collected in before being written
+static const size_t SAVE_BUFFER_SIZE      = 4 * 1024 * 1024;
+/// record count of a save range whose length is not known in advance
+static const size_t UNKNOWN_COUNT         = static_cast<size_t>(~0);
 
 
 cnp::QWORD GenerateCustomerID(const char* szFirstName, size_t cbLen, cnp::WORD wPIN) noexcept
@@ -39,55 +98,377 @@ cnp::QWORD GenerateCustomerID(const char* szFirstName, size_t cbLen, cnp::WORD w
 };
 
 /**
-  @brief Generic template function for loading STL maps
+  @brief Maps a saved table file into memory & locates its records
 
-  LoadServerDB provides a generic function to use for different
-  map type containers.
+  A file without a SERVER_DB_FILE_HDR is taken to be a plain array of
+  records, as saved before the header was introduced.
 
-  @pre _MapType is a std::map<_KeyType, _MappedType> collection
-  @pre _MappedType implements the get_PrimaryKey() method
+  @param [in]  File         mapping to hold the file
+  @param [in]  szFileName   address of the NULL terminated string that 
+                            contains the name of the file to map
+  @param [out] pRecords     receives the address of the first record
+  @param [out] nRecords     receives the number of records
+  @param [out] dwFlags      receives the file's SERVER_DB_FLAGS
+
+  @retval true  if the file holds records of type _Record, or is empty
+  @retval false if it is missing or of another layout
+ */
+template <class _Record>
+static bool MapTableFile(CNP_MappedFile& File, const char* szFileName,
+                         const _Record*& pRecords, size_t& nRecords, cnp::DWORD& dwFlags)
+{
+    pRecords = nullptr;
+    nRecords = 0;
+    dwFlags  = 0;
+
+    if (File.Open(szFileName) == false)
+        return false;
+
+    const char* pData  = File.get_Data();
+    size_t      cbData = File.get_Size();
+
+    SERVER_DB_FILE_HDR Hdr = { };
+    if (cbData >= sizeof(Hdr))
+        memcpy(&Hdr, pData, sizeof(Hdr));
+
+    if (Hdr.m_dwMagic == SERVER_DB_MAGIC)
+    {
+        if (Hdr.m_dwVersion != SERVER_DB_VERSION || Hdr.m_cbRecord != sizeof(_Record))
+        {
+            std::cerr << szFileName << " has an unsupported layout, Version:" << Hdr.m_dwVersion
+                      << " RecordSize:" << Hdr.m_cbRecord << std::endl;
+            return false;
+        }
+
+        pData   += sizeof(Hdr);
+        cbData  -= sizeof(Hdr);
+        dwFlags  = Hdr.m_dwFlags;
+
+        if (Hdr.m_qwRecords != cbData / sizeof(_Record))
+            std::cerr << szFileName << " holds " << cbData / sizeof(_Record) << " of its "
+                      << Hdr.m_qwRecords << " records" << std::endl;
+    }
+
+    // the file is saved from an array of records of this very type
+    pRecords = reinterpret_cast<const _Record*>(pData);
+    nRecords = cbData / sizeof(_Record);
+
+    if (Hdr.m_dwMagic == SERVER_DB_MAGIC && Hdr.m_qwRecords < nRecords)
+        nRecords = static_cast<size_t>(Hdr.m_qwRecords);
+
+    return true;
+};
+
+/**
+  @retval size_t containing the number of ranges to split a table of
+          nRecords records into, one per core at most
+ */
+static size_t GetRangeCount(size_t nRecords) noexcept
+{
+    size_t nRanges = std::thread::hardware_concurrency();
+
+    if (nRanges > nRecords / MIN_RECORDS_PER_RANGE)
+        nRanges = nRecords / MIN_RECORDS_PER_RANGE;
+
+    return (nRanges == 0) ? 1 : nRanges;
+};
+
+/**
+  @brief Runs fnTask(i) for i in [0, nTasks), each on its own thread but
+         the first, which runs on the calling thread
+ */
+template <class _Fn>
+static void RunTasks(size_t nTasks, _Fn fnTask)
+{
+    std::vector<std::thread> vecThreads;
+
+    for (size_t i = 1; i < nTasks; i++)
+        vecThreads.emplace_back(fnTask, i);
+
+    if (nTasks > 0)
+        fnTask(0);
+
+    for (auto& it : vecThreads)
+        it.join();
+};
+
+/**
+  @brief Prints the throughput of a table load or save
+ */
+static void ReportThroughput(const char* szAction, const char* szFileName, size_t nRecords,
+                             size_t cbBytes, size_t nRanges,
+                             const std::chrono::steady_clock::time_point& tpStart)
+{
+    std::chrono::duration<double> dElapsed = std::chrono::steady_clock::now() - tpStart;
+
+    double dMBytes  = static_cast<double>(cbBytes) / (1024.0 * 1024.0);
+    double dSeconds = (dElapsed.count() > 0.0) ? dElapsed.count() : 1e-9;
+
+    std::cout << szAction << " " << szFileName << ": " << nRecords << " record(s), "
+              << dMBytes << " MB in " << dSeconds * 1000.0 << " ms, "
+              << dMBytes / dSeconds << " MB/s, " << nRanges << " range(s)" << std::endl;
+};
+
+/**
+  @brief Flushes a closed file's contents to disk
+
+  @retval true  on success
+  @retval false on failure
+ */
+static bool SyncFile(const char* szFileName)
+{
+#ifdef __linux__
+    int hFile = ::open(szFileName, O_RDONLY | O_CLOEXEC);
+    if (hFile == -1)
+        return false;
+
+    bool bResult = (::fsync(hFile) == 0);
+    ::close(hFile);
+#elif _MSC_VER
+    int hFile = ::_open(szFileName, _O_RDWR | _O_BINARY);
+    if (hFile == -1)
+        return false;
+
+    bool bResult = (::_commit(hFile) == 0);
+    ::_close(hFile);
+#endif
+    return bResult;
+};
+
+/**
+  @brief Flushes the directory entry of a renamed file to disk, Windows
+         has no equivalent
+ */
+static void SyncDirectory(const char* szFileName)
+{
+#ifdef __linux__
+    std::string strDir = std::filesystem::path(szFileName).parent_path().string();
+
+    int hDir = ::open(strDir.empty() ? "." : strDir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (hDir != -1)
+    {
+        ::fsync(hDir);
+        ::close(hDir);
+    }
+#else
+    (void)szFileName;
+#endif
+};
+
+/**
+    TABLE_WRITER collects records in a large buffer & writes them to a
+    table file from a given offset onwards, each save range having its
+    own writer, & file descriptor, so they can write concurrently.
+ */
+struct TABLE_WRITER
+{
+    int                m_hFile;
+    std::vector<char>  m_vecBuffer;
+    size_t             m_cbUsed;
+    size_t             m_nRecords;    ///< records appended
+    bool               m_bFailed;
+
+    /// Default Constructor
+    TABLE_WRITER(void)
+        : m_hFile(-1),
+          m_vecBuffer(),
+          m_cbUsed(0),
+          m_nRecords(0),
+          m_bFailed(false)
+    { };
+
+    ~TABLE_WRITER()
+    {
+        Close();
+    };
+
+/**
+    @brief Opens an existing file for writing at a given offset
+
+    @retval true  on success
+    @retval false on failure
+ */
+    bool Open(const std::string& strFileName, cnp::QWORD qwOffset)
+    {
+#ifdef __linux__
+        m_hFile = ::open(strFileName.c_str(), O_WRONLY | O_CLOEXEC);
+        m_bFailed = (m_hFile == -1) || (::lseek(m_hFile, static_cast<off_t>(qwOffset), SEEK_SET) == -1);
+#elif _MSC_VER
+        m_hFile = ::_open(strFileName.c_str(), _O_WRONLY | _O_BINARY);
+        m_bFailed = (m_hFile == -1) || (::_lseeki64(m_hFile, static_cast<__int64>(qwOffset), SEEK_SET) == -1);
+#endif
+        m_vecBuffer.resize(SAVE_BUFFER_SIZE);
+        return m_bFailed == false;
+    };
+
+    template <class _Record>
+    inline void Append(const _Record& Record)
+    {
+        if (m_cbUsed + sizeof(Record) > m_vecBuffer.size())
+            Flush();
+
+        memcpy(m_vecBuffer.data() + m_cbUsed, &Record, sizeof(Record));
+        m_cbUsed += sizeof(Record);
+        m_nRecords++;
+    };
+
+    void Flush(void)
+    {
+        const char* pData  = m_vecBuffer.data();
+        size_t      cbLeft = m_cbUsed;
+
+        while (cbLeft > 0 && m_bFailed == false)
+        {
+#ifdef __linux__
+            ssize_t cbWritten = ::write(m_hFile, pData, cbLeft);
+#elif _MSC_VER
+            int     cbWritten = ::_write(m_hFile, pData, static_cast<unsigned>(cbLeft));
+#endif
+            if (cbWritten < 0)
+            {
+                if (errno != EINTR)
+                    m_bFailed = true;
+                continue;
+            }
+
+            pData  += cbWritten;
+            cbLeft -= cbWritten;
+        }
+
+        m_cbUsed = 0;
+    };
+
+/**
+    @retval true  if every record has been written
+    @retval false on failure
+ */
+    bool Close(void)
+    {
+        if (m_hFile != -1)
+        {
+            Flush();
+#ifdef __linux__
+            m_bFailed |= (::close(m_hFile) != 0);
+#elif _MSC_VER
+            m_bFailed |= (::_close(m_hFile) != 0);
+#endif
+            m_hFile = -1;
+        }
+
+        return m_bFailed == false;
+    };
+};
+
+/**
+    A contiguous run of a table's records, saved by a thread of its own
+ */
+struct SAVE_RANGE
+{
+    size_t                               m_nFirst;   ///< index of the range's first record in the file
+    size_t                               m_nCount;   ///< number of records, UNKNOWN_COUNT if the last range
+    std::function<void (TABLE_WRITER&)>  m_fnEmit;   ///< appends the range's records to the writer
+};
+
+/**
+  @brief Generic template function for persisting a table
+
+  The ranges are written concurrently to a temporary file, which is then
+  renamed over the table's file, so that a crash part way through a save
+  leaves the previous table intact.
+
+  @pre _Record is the type of every record the ranges append
 
   @param [in] szFileName   address of the NULL terminated string that 
-                           contains the name of the file to open
-  @param [in] Container    a reference to the std::map container instance
-                           to insert loaded file records into
+                           contains the name of the file to save to
+  @param [in] dwFlags      SERVER_DB_FLAGS describing the records
+  @param [in] vecRanges    the table's records, in file order
 
-  @retval size_t containing the number of records actually loaded
+  @retval size_t containing the number of records actually saved
  */
-template <class _MapType>
-size_t LoadServerDB(const char* szFileName, _MapType& Container)
+template <class _Record>
+size_t SaveTableFile(const char* szFileName, cnp::DWORD dwFlags, const std::vector<SAVE_RANGE>& vecRanges)
 {
-    size_t nResult = 0;
-    typedef typename _MapType::value_type  value_type;
-    typedef typename _MapType::mapped_type Record_Type;
+    auto tpStart = std::chrono::steady_clock::now();
 
-    std::ifstream ifs(szFileName, std::ios_base::binary);
+    size_t      nResult = 0;
+    bool        bResult = true;
+    std::string strTemp = std::string(szFileName) + ".tmp";
+
+    SERVER_DB_FILE_HDR Hdr = { SERVER_DB_MAGIC, SERVER_DB_VERSION, sizeof(_Record), dwFlags, 0 };
 
-    while (ifs)
     {
-        Record_Type  Record;
-        ifs.read(reinterpret_cast<char*>( &Record ), sizeof(Record));
+        std::ofstream ofs(strTemp, std::ios_base::binary | std::ios_base::trunc);
+        ofs.write(reinterpret_cast<const char*>( &Hdr ), sizeof(Hdr) );
+        ofs.close();
+        bResult = !ofs.fail();
+    }
+
+    std::vector<size_t> vecSaved(vecRanges.size(), 0);
+    std::vector<char>   vecValid(vecRanges.size(), 0);
 
-        if (ifs)
+    if (bResult)
+    {
+        RunTasks(vecRanges.size(), [&](size_t nRange)
         {
-            auto pairResult = Container.insert(value_type(Record.get_PrimaryKey(), Record));
+            const SAVE_RANGE& Range = vecRanges[nRange];
+            TABLE_WRITER      Writer;
+
+            if (Writer.Open(strTemp, sizeof(Hdr) + static_cast<cnp::QWORD>(Range.m_nFirst) * sizeof(_Record)))
+                Range.m_fnEmit(Writer);
+
+            vecSaved[nRange] = Writer.m_nRecords;
+            vecValid[nRange] = Writer.Close() &&
+                               (Range.m_nCount == UNKNOWN_COUNT || Range.m_nCount == Writer.m_nRecords);
+        });
 
-            // increment our count of records successfully read in.
-            if (pairResult.second)
-                nResult++;
+        for (size_t i = 0; i < vecRanges.size(); i++)
+        {
+            nResult += vecSaved[i];
+            bResult &= (vecValid[i] != 0);
         }
     }
 
-    ifs.close();
+    // the record count is only known once they have all been written
+    if (bResult)
+    {
+        Hdr.m_qwRecords = nResult;
+
+        std::fstream fs(strTemp, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+        fs.write(reinterpret_cast<const char*>( &Hdr ), sizeof(Hdr) );
+        fs.close();
+        bResult = !fs.fail();
+    }
+
+    // a failed write or close leaves the file incomplete
+    if (bResult == false || SyncFile(strTemp.c_str()) == false)
+    {
+        std::cerr << "failed to save " << szFileName << ", Error:" << errno << std::endl;
+        ::remove(strTemp.c_str());
+        return 0;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(strTemp, szFileName, ec);
+    if (ec)
+    {
+        std::cerr << "failed to replace " << szFileName << ", Error:" << ec.value() << std::endl;
+        ::remove(strTemp.c_str());
+        return 0;
+    }
+
+    SyncDirectory(szFileName);
+
+    ReportThroughput("Saved", szFileName, nResult, sizeof(Hdr) + nResult * sizeof(_Record),
+                     vecRanges.size(), tpStart);
     return nResult;
 };
 
-
 /**
   @brief Generic template function for persisting STL maps
 
   SaveServerDB provides a generic function to use for different
-  map type containers.
+  map type containers.  A large map is split into ranges of equal
+  length, saved concurrently.
 
   @pre _MapType is a std::map<_KeyType, _MappedType> collection
 
@@ -102,38 +483,687 @@ size_t LoadServerDB(const char* szFileName, _MapType& Container)
 template <class _MapType>
 size_t SaveServerDB(const char* szFileName, const _MapType& Container)
 {
+    typedef typename _MapType::mapped_type     Record_Type;
+    typedef typename _MapType::const_iterator  Iterator_Type;
+
+    size_t                   nRecords = Container.size();
+    size_t                   nRanges  = GetRangeCount(nRecords);
+    std::vector<SAVE_RANGE>  vecRanges;
+    Iterator_Type            itFirst  = Container.begin();
+
+    for (size_t i = 0; i < nRanges; i++)
+    {
+        size_t nFirst = nRecords * i / nRanges;
+        size_t nLast  = nRecords * (i + 1) / nRanges;
+
+        Iterator_Type itLast = itFirst;
+        std::advance(itLast, nLast - nFirst);
+
+        vecRanges.push_back(SAVE_RANGE{ nFirst, nLast - nFirst, [itFirst, itLast](TABLE_WRITER& Writer)
+        {
+            for (auto it = itFirst; it != itLast; ++it)
+                Writer.Append(it->second);
+        } });
+
+        itFirst = itLast;
+    }
+
+    // the map iterates in key order
+    return SaveTableFile<Record_Type>(szFileName, SDF_SORTED, vecRanges);
+};
+
+/**
+  @brief Loads the ACCOUNT_INFO table into the sharded account store
+
+  @param [in] szFileName   address of the NULL terminated string that 
+                           contains the name of the file to open
+  @param [in] Store        account store to insert loaded records into
+
+  @retval size_t containing the number of records actually loaded
+ */
+size_t LoadServerDB(const char* szFileName, CNP_AccountStore& Store)
+{
+    auto tpStart = std::chrono::steady_clock::now();
+
+    CNP_MappedFile       File;
+    const ACCOUNT_INFO*  pRecords = nullptr;
+    size_t               nRecords = 0;
+    cnp::DWORD           dwFlags  = 0;
+
+    if (MapTableFile(File, szFileName, pRecords, nRecords, dwFlags) == false)
+        return 0;
+
+    size_t nResult = Store.BulkInsert(pRecords, nRecords);
+
+    ReportThroughput("Loaded", szFileName, nRecords, File.get_Size(), 1, tpStart);
+    return nResult;
+};
+
+/**
+  @brief Persists the sharded account store
+
+  @param [in] szFileName   address of the NULL terminated string that 
+                           contains the name of the file to open for 
+                           saving
+  @param [in] Store        account store to persist
+  @param [in] bLocked      the caller holds Store.LockAll(), or is a
+                           process forked while it was held
+
+  @retval size_t containing the number of records actually saved
+ */
+size_t SaveServerDB(const char* szFileName, const CNP_AccountStore& Store, bool bLocked = false)
+{
+    std::vector<SAVE_RANGE> vecRanges;
+
+    vecRanges.push_back(SAVE_RANGE{ 0, UNKNOWN_COUNT, [&Store, bLocked](TABLE_WRITER& Writer)
+    {
+        auto fnAppend = [&Writer](const ACCOUNT_INFO& Record) { Writer.Append(Record); };
+
+        if (bLocked)
+            Store.ForEachLocked(fnAppend);
+        else
+            Store.ForEach(fnAppend);
+    } });
+
+    return SaveTableFile<ACCOUNT_INFO>(szFileName, 0, vecRanges);
+};
+
+/**
+  @brief Loads the TRANSACTION_INFO table into the transaction ledger
+
+  Each record goes straight into the slot of its ID, so a large file is
+  split into ranges loaded concurrently, whatever order it was saved in.
+
+  @param [in] szFileName   address of the NULL terminated string that 
+                           contains the name of the file to open
+  @param [in] Ledger       ledger to publish loaded records to
+
+  @retval size_t containing the number of records actually loaded
+ */
+size_t LoadServerDB(const char* szFileName, CNP_TransactionLedger& Ledger)
+{
+    auto tpStart = std::chrono::steady_clock::now();
+
+    CNP_MappedFile           File;
+    const TRANSACTION_INFO*  pRecords = nullptr;
+    size_t                   nRecords = 0;
+    cnp::DWORD               dwFlags  = 0;
+
+    if (MapTableFile(File, szFileName, pRecords, nRecords, dwFlags) == false)
+        return 0;
+
+    size_t              nRanges = GetRangeCount(nRecords);
+    std::vector<size_t> vecLoaded(nRanges, 0);
+
+    RunTasks(nRanges, [&](size_t nRange)
+    {
+        size_t nFirst = nRecords * nRange / nRanges;
+        size_t nLast  = nRecords * (nRange + 1) / nRanges;
+
+        // duplicate & released IDs are only published once, if at all
+        for (size_t i = nFirst; i < nLast; i++)
+        {
+            if (Ledger.Publish(pRecords[i]))
+                vecLoaded[nRange]++;
+        }
+    });
+
+    ReportThroughput("Loaded", szFileName, nRecords, File.get_Size(), nRanges, tpStart);
+
     size_t nResult = 0;
-    std::ofstream ofs(szFileName, std::ios_base::binary);
+    for (auto it : vecLoaded)
+        nResult += it;
+
+    return nResult;
+};
+
+/**
+  @brief Persists the transaction ledger
+
+  A ledger no longer being written is split into ranges of IDs, each
+  counted & then saved concurrently.  One that is, is saved in a single
+  pass, which also picks up whatever is published while it runs.
+
+  @param [in] szFileName   address of the NULL terminated string that 
+                           contains the name of the file to open for 
+                           saving
+  @param [in] Ledger       ledger to persist
+  @param [in] bFrozen      no transaction is being published, the server
+                           having stopped or this being a process forked
+                           from it
+
+  @retval size_t containing the number of records actually saved
+ */
+size_t SaveServerDB(const char* szFileName, const CNP_TransactionLedger& Ledger, bool bFrozen)
+{
+    std::vector<SAVE_RANGE> vecRanges;
 
-    if (ofs)
+    cnp::DWORD dwFirstID = Ledger.get_FirstID();
+    cnp::DWORD dwLastID  = std::min(Ledger.get_LastID(), cnp::DWORD(CNP_TransactionLedger::MAX_ID));
+
+    if (bFrozen == false || dwLastID < dwFirstID)
     {
-        for (const auto& it : Container)
+        vecRanges.push_back(SAVE_RANGE{ 0, UNKNOWN_COUNT, [&Ledger](TABLE_WRITER& Writer)
         {
-            ofs.write(reinterpret_cast<const char*>( &(it.second) ), sizeof(it.second) );
-            nResult++;
+            Ledger.ForEach([&Writer](const TRANSACTION_INFO& Record) { Writer.Append(Record); });
+        } });
+    }
+    else
+    {
+        size_t     nRanges = GetRangeCount(Ledger.Size());
+        cnp::QWORD qwSpan  = static_cast<cnp::QWORD>(dwLastID - dwFirstID) + 1;
+
+        std::vector<cnp::DWORD> vecFirstIDs(nRanges + 1);
+        std::vector<size_t>     vecCounts(nRanges, 0);
+
+        for (size_t i = 0; i <= nRanges; i++)
+            vecFirstIDs[i] = static_cast<cnp::DWORD>(dwFirstID + qwSpan * i / nRanges);
+
+        // a range's place in the file depends on how many IDs before it are held
+        RunTasks(nRanges, [&](size_t nRange)
+        {
+            vecCounts[nRange] = Ledger.Count(vecFirstIDs[nRange], vecFirstIDs[nRange + 1] - 1);
+        });
+
+        size_t nFirst = 0;
+
+        for (size_t i = 0; i < nRanges; i++)
+        {
+            cnp::DWORD dwRangeFirst = vecFirstIDs[i];
+            cnp::DWORD dwRangeLast  = vecFirstIDs[i + 1] - 1;
+
+            vecRanges.push_back(SAVE_RANGE{ nFirst, vecCounts[i], [&Ledger, dwRangeFirst, dwRangeLast](TABLE_WRITER& Writer)
+            {
+                Ledger.ForEach(dwRangeFirst, dwRangeLast, [&Writer](const TRANSACTION_INFO& Record) { Writer.Append(Record); });
+            } });
+
+            nFirst += vecCounts[i];
+        }
+    }
+
+    // the ledger iterates in ID order
+    return SaveTableFile<TRANSACTION_INFO>(szFileName, SDF_SORTED, vecRanges);
+};
+
+size_t BuildCustomerTransactionIndex(const CNP_TransactionLedger& Ledger,
+                                     CustomerTransactionIndex_t& Index)
+{
+    Index.clear();
+
+    // the ledger is iterated in transaction ID order, so each list comes out sorted
+    Ledger.ForEach([&Index](const TRANSACTION_INFO& Record)
+    {
+        Index[Record.get_CustomerID()].push_back(Record.get_ID());
+    });
+
+    return Index.size();
+};
+
+/**
+  @brief Reapplies a record of the write-ahead log
+
+  Records already held by the loaded tables are skipped, which makes
+  replaying a log that outlived its save harmless.
+
+  @param [in] dwType   SERVER_LOG_RECORD type of the record
+  @param [in] pData    address of the record
+  @param [in] cbLen    length of the record in bytes
+ */
+static void ReplayServerLog(cnp::DWORD dwType, const void* pData, size_t cbLen)
+{
+    if (dwType == SLR_ACCOUNT && cbLen == sizeof(ACCOUNT_INFO))
+    {
+        const ACCOUNT_INFO& Record = *static_cast<const ACCOUNT_INFO*>(pData);
+
+        g_AccountInfo.Insert(Record);
+    }
+    else if (dwType == SLR_TRANSACTION && cbLen == sizeof(TRANSACTION_INFO))
+    {
+        const TRANSACTION_INFO& Record = *static_cast<const TRANSACTION_INFO*>(pData);
+
+        // the balances are recomputed once every record is back, & a
+        // sealed transaction, already held by its segment, is released
+        g_TransactionLedger.Publish(Record);
+    }
+    else
+    {
+        std::cerr << "skipping unknown log record, Type:" << dwType << " Len:" << cbLen << std::endl;
+    }
+};
+
+/**
+  @brief Opens every ledger segment of the data directory, in ID order
+
+  @retval size_t containing the number of sealed transactions
+ */
+static size_t OpenLedgerSegments(void)
+{
+    std::vector<std::string> vecFiles;
+    std::error_code          ec;
+
+    for (std::filesystem::directory_iterator itDir(g_szLedgerDirectory, ec), itEnd;
+         !ec && itDir != itEnd; itDir.increment(ec))
+    {
+        std::string strName = itDir->path().filename().string();
+
+        if (strName.compare(0, 7, "Ledger-") == 0 && itDir->path().extension() == ".Seg")
+            vecFiles.push_back(itDir->path().string());
+    }
+
+    // the first IDs are zero padded, so the names sort in ID order
+    std::sort(vecFiles.begin(), vecFiles.end());
+
+    size_t nResult = 0;
+
+    for (const auto& strFile : vecFiles)
+    {
+        std::unique_ptr<CNP_LedgerSegment> pSegment(new CNP_LedgerSegment());
+
+        if (pSegment->Open(strFile.c_str(), &g_LedgerCache) == false)
+            continue;
+
+        if (pSegment->get_FirstID() <= g_dwLastSealedID)
+        {
+            std::cerr << "skipping ledger segment " << strFile << ", it overlaps its predecessor" << std::endl;
+            continue;
         }
+
+        nResult          += pSegment->get_Count();
+        g_dwLastSealedID  = pSegment->get_LastID();
+        g_vecLedgerSegments.push_back(std::move(pSegment));
     }
 
-    ofs.close();
+    if (g_vecLedgerSegments.empty() == false)
+        std::cout << "Opened " << g_vecLedgerSegments.size() << " ledger segment(s) holding "
+                  << nResult << " sealed transaction(s)" << std::endl;
+
     return nResult;
 };
 
-size_t LoadServerDB(void)
+void ConfigureLedger(size_t nHotTransactions, size_t cbBlockCache)
+{
+    g_nHotTransactions = nHotTransactions;
+    g_LedgerCache.set_Capacity(cbBlockCache);
+};
+
+size_t SealTransactions(void)
+{
+    if (g_nHotTransactions == 0)
+        return 0;
+
+    size_t nHeld = g_TransactionLedger.Size();
+
+    if (nHeld < 2 * g_nHotTransactions)
+        return 0;
+
+    size_t                        nSeal = nHeld - g_nHotTransactions;
+    std::vector<TRANSACTION_INFO> vecSealed;
+    vecSealed.reserve(nSeal);
+
+// 1. Copy the oldest transactions, stopping short of any still being recorded
+    cnp::DWORD dwNextID   = g_TransactionLedger.get_FirstID();
+    bool       bInFlight  = false;
+
+    g_TransactionLedger.ForEach([&](const TRANSACTION_INFO& Record)
+    {
+        if (bInFlight || vecSealed.size() >= nSeal)
+            return;
+
+        // an ID skipped over since loading has been reserved but not yet
+        // published, & would be lost were it sealed over
+        if (Record.get_ID() > dwNextID && Record.get_ID() - 1 > g_dwRecoveredID)
+        {
+            bInFlight = true;
+            return;
+        }
+
+        vecSealed.push_back(Record);
+        dwNextID = Record.get_ID() + 1;
+    });
+
+    if (vecSealed.empty())
+        return 0;
+
+// 2. Write them to a segment, the in-memory copies stay in use meanwhile
+    char szFileName[256];
+    snprintf(szFileName, sizeof(szFileName), "%s//Ledger-%010lu.Seg", g_szLedgerDirectory,
+             static_cast<unsigned long>(vecSealed.front().get_ID()));
+
+    std::unique_ptr<CNP_LedgerSegment> pSegment(new CNP_LedgerSegment());
+
+    if (CNP_LedgerSegment::Create(szFileName, vecSealed) == false ||
+        pSegment->Open(szFileName, &g_LedgerCache) == false)
+        return 0;
+
+    cnp::DWORD dwLastID = pSegment->get_LastID();
+
+// 3. Swap the segment in for the in-memory copies, in one step for queries
+    {
+        std::unique_lock<std::shared_mutex> LedgerLock(g_LedgerMutex);
+        std::lock_guard<std::mutex>         IndexLock(g_TransactionMutex);
+
+        pSegment->ForEachCustomer([dwLastID](const LEDGER_SEGMENT_CUSTOMER& Customer)
+        {
+            auto itC = g_CustomerTransactions.find(Customer.m_qwCustomerID);
+            if (itC == g_CustomerTransactions.end())
+                return;
+
+            auto& vecIDs = itC->second;
+            vecIDs.erase(vecIDs.begin(), std::upper_bound(vecIDs.begin(), vecIDs.end(), dwLastID));
+
+            if (vecIDs.empty())
+                g_CustomerTransactions.erase(itC);
+        });
+
+        g_TransactionLedger.Release(dwLastID);
+
+        g_dwLastSealedID = dwLastID;
+        g_vecLedgerSegments.push_back(std::move(pSegment));
+    }
+
+    std::cout << "Sealed " << vecSealed.size() << " transaction(s) into " << szFileName << std::endl;
+    return vecSealed.size();
+};
+
+size_t QueryCustomerTransactions(const cnp::QWORD& qwCustomerID, cnp::DWORD dwStartID, size_t nMax,
+                                 std::vector<cnp::TRANSACTION>& vecTransactions)
 {
     size_t nResult = 0;
 
-    nResult += LoadServerDB(g_szAccountDBFileName,  g_AccountInfo);
-    nResult += LoadServerDB(g_szTransactDBFileName, g_TransactionInfo);
+    // held across both tiers, so a seal cannot move transactions between
+    // them part way through
+    std::shared_lock<std::shared_mutex> LedgerLock(g_LedgerMutex);
+
+// 1. The sealed transactions, oldest segment first, read through the block cache
+    for (auto& pSegment : g_vecLedgerSegments)
+    {
+        if (nResult >= nMax)
+            break;
+
+        nResult += pSegment->Query(qwCustomerID, dwStartID, nMax - nResult, vecTransactions);
+    }
+
+// 2. The in-memory transactions, their IDs copied out of the index first
+    std::vector<cnp::DWORD> vecIDs;
+    {
+        std::lock_guard<std::mutex> IndexLock(g_TransactionMutex);
+
+        auto itC = g_CustomerTransactions.find(qwCustomerID);
+        if (itC != g_CustomerTransactions.end())
+        {
+            auto itID = std::lower_bound(itC->second.begin(), itC->second.end(), dwStartID);
+
+            for (; itID != itC->second.end() && vecIDs.size() < nMax - nResult; ++itID)
+                vecIDs.push_back(*itID);
+        }
+    }
+
+    // an indexed transaction is always published
+    for (auto dwID : vecIDs)
+    {
+        TRANSACTION_INFO Transaction;
+        if (g_TransactionLedger.Find(dwID, Transaction))
+        {
+            vecTransactions.push_back(Transaction);
+            nResult++;
+        }
+    }
 
     return nResult;
 };
 
+size_t LoadServerDB(void)
+{
+    size_t nResult = OpenLedgerSegments();
+
+    // a snapshot saved before the last seal still holds what it sealed,
+    // whose IDs are released up front & so skipped
+    g_TransactionLedger.Release(g_dwLastSealedID);
+
+    size_t nLoaded[2] = { 0, 0 };
+
+    // the tables are independent, so they are loaded side by side
+    RunTasks(2, [&nLoaded](size_t nTable)
+    {
+        if (nTable == 0)
+            nLoaded[0] = LoadServerDB(g_szTransactDBFileName, g_TransactionLedger);
+        else
+            nLoaded[1] = LoadServerDB(g_szAccountDBFileName,  g_AccountInfo);
+    });
+
+    nResult += nLoaded[0] + nLoaded[1];
+
+    size_t nReplayed = g_ServerLog.Replay(g_szServerLogFileName, ReplayServerLog);
+    if (nReplayed > 0)
+        std::cout << "Replayed " << nReplayed << " logged record(s)" << std::endl;
+
+    // the index is built alongside the balances, both only read the transactions
+    std::thread IndexThread([]()
+    {
+        BuildCustomerTransactionIndex(g_TransactionLedger, g_CustomerTransactions);
+    });
+
+    // a checkpoint's balances may include transactions made while it was
+    // frozen but logged after it, so they are derived from the transactions
+    CustomerBalanceMap_t mapSealed;
+    for (const auto& pSegment : g_vecLedgerSegments)
+    {
+        pSegment->ForEachCustomer([&mapSealed](const LEDGER_SEGMENT_CUSTOMER& Customer)
+        {
+            mapSealed[Customer.m_qwCustomerID] += Customer.m_llNetAmount;
+        });
+    }
+
+    size_t nOrphans = g_AccountInfo.RebuildBalances(g_TransactionLedger, mapSealed);
+    if (nOrphans > 0)
+        std::cerr << nOrphans << " transaction(s) refer to a missing account" << std::endl;
+
+    IndexThread.join();
+
+    // IDs carry on from the newest transaction, sealed or not, which
+    // releasing & publishing have already moved the ledger past
+    g_dwRecoveredID = g_TransactionLedger.get_LastID();
+
+    return nResult + nReplayed;
+};
+
+/**
+  @brief Saves both tables side by side
+
+  @param [in] bLocked   the caller holds every account store lock, or is
+                        a process forked while they were held, the ledger
+                        no longer being written in either case
+
+  @retval size_t containing the number of records saved
+ */
+static size_t SaveServerTables(bool bLocked)
+{
+    size_t nSaved[2] = { 0, 0 };
+
+    RunTasks(2, [&nSaved, bLocked](size_t nTable)
+    {
+        if (nTable == 0)
+            nSaved[0] = SaveServerDB(g_szTransactDBFileName, g_TransactionLedger, true);
+        else
+            nSaved[1] = SaveServerDB(g_szAccountDBFileName,  g_AccountInfo, bLocked);
+    });
+
+    return nSaved[0] + nSaved[1];
+};
+
 size_t SaveServerDB(void)
 {
-    size_t nResult = 0;
+    size_t nResult   = 0;
+    size_t nExpected = g_AccountInfo.Size() + g_TransactionLedger.Size();
+
+    nResult += SaveServerTables(false);
 
-    nResult += SaveServerDB(g_szAccountDBFileName,  g_AccountInfo);
-    nResult += SaveServerDB(g_szTransactDBFileName, g_TransactionInfo);
+    // the log is only redundant once every record has been saved
+    if (nResult == nExpected)
+        g_ServerLog.Truncate();
+    else
+        std::cerr << "saved " << nResult << " of " << nExpected << " records, keeping the log" << std::endl;
 
     return nResult;
-};
\ No newline at end of file
+};
+
+bool OpenServerLog(CNP_WriteAheadLog::SYNC_MODE eMode, unsigned long ulGroupDelay)
+{
+    return g_ServerLog.Open(g_szServerLogFileName, eMode, ulGroupDelay);
+};
+
+void CloseServerLog(void) noexcept
+{
+    g_ServerLog.Close();
+};
+
+#ifdef __linux__
+/**
+  @brief Closes every file inherited by a checkpoint process, so that it
+         keeps no client connection or listening socket open
+ */
+static void CloseInheritedFiles(void) noexcept
+{
+#ifdef SYS_close_range
+    if (::syscall(SYS_close_range, 3U, ~0U, 0U) == 0)
+        return;
+#endif
+    long lMaxFile = ::sysconf(_SC_OPEN_MAX);
+    for (long i = 3; i < lMaxFile; i++)
+        ::close(static_cast<int>(i));
+};
+#endif
+
+bool CheckpointServerDB(void)
+{
+    // sealed transactions are left out of the snapshot
+    SealTransactions();
+
+    auto tpStart = std::chrono::steady_clock::now();
+
+    size_t nExpected = 0;
+    size_t nSaved    = 0;
+
+    // 1. freeze the accounts & cut the log at the same point, every record
+    //    logged before the cut is then held by the snapshot.  A transaction
+    //    is logged & published under its account's lock, so the ledger
+    //    needs no freezing
+    g_AccountInfo.LockAll();
+
+    g_ServerLog.Rotate();
+
+#ifdef __linux__
+    // 2. the child process gets a copy-on-write image of the frozen
+    //    tables, the server resumes as soon as it has been created
+    g_AccountInfo.ForEachLocked([&](const ACCOUNT_INFO&) { nExpected++; });
+
+    pid_t pid = ::fork();
+    if (pid == 0)
+    {
+        // no other thread of the child holds the locks, so none is taken
+        CloseInheritedFiles();
+
+        // the child's image of the ledger holds whatever was published at the fork
+        nExpected += g_TransactionLedger.Count(g_TransactionLedger.get_FirstID(), g_TransactionLedger.get_LastID());
+        nSaved    += SaveServerTables(true);
+
+        ::_exit((nSaved == nExpected) ? 0 : 1);
+    }
+
+    g_AccountInfo.UnlockAll();
+
+    if (pid == -1)
+    {
+        std::cerr << "failed to start checkpoint, Error:" << errno << std::endl;
+        return false;
+    }
+
+    // 3. wait for the snapshot to be saved
+    int iStatus = 0;
+    while (::waitpid(pid, &iStatus, 0) == -1 && errno == EINTR)
+        ;
+
+    bool bResult = WIFEXITED(iStatus) && (WEXITSTATUS(iStatus) == 0);
+    nSaved = bResult ? nExpected : 0;
+#elif _MSC_VER
+    // 2. without fork() the accounts are copied while frozen, the ledger
+    //    is saved as it stands, a published transaction never changing
+    AccountMap_t mapAccounts;
+
+    g_AccountInfo.ForEachLocked([&](const ACCOUNT_INFO& Record)
+    {
+        mapAccounts.insert(AccountMap_t::value_type(Record.get_CustomerID(), Record));
+    });
+
+    g_AccountInfo.UnlockAll();
+
+    // 3. save the copy & the ledger, which may by then hold more than at the cut
+    nExpected = mapAccounts.size() + g_TransactionLedger.Count(g_TransactionLedger.get_FirstID(),
+                                                               g_TransactionLedger.get_LastID());
+    size_t nTableSaved[2] = { 0, 0 };
+
+    RunTasks(2, [&](size_t nTable)
+    {
+        if (nTable == 0)
+            nTableSaved[0] = SaveServerDB(g_szTransactDBFileName, g_TransactionLedger, false);
+        else
+            nTableSaved[1] = SaveServerDB(g_szAccountDBFileName,  mapAccounts);
+    });
+
+    nSaved = nTableSaved[0] + nTableSaved[1];
+
+    bool bResult = (nSaved >= nExpected) && (nTableSaved[1] == mapAccounts.size());
+#endif
+
+    // 4. the rotated log records are now redundant
+    if (bResult)
+    {
+        g_ServerLog.DiscardRotated();
+
+        std::chrono::duration<double, std::milli> dElapsed = std::chrono::steady_clock::now() - tpStart;
+        std::cout << "Checkpoint saved " << nSaved << " record(s) in " << dElapsed.count() << " ms" << std::endl;
+    }
+    else
+    {
+        std::cerr << "checkpoint failed, keeping the rotated log" << std::endl;
+    }
+
+    return bResult;
+};
+
+void StartCheckpointThread(unsigned long ulSeconds)
+{
+    if (ulSeconds == 0 || g_pCheckpointThread != nullptr)
+        return;
+
+    g_bCheckpointStop   = false;
+    g_pCheckpointThread = new std::thread([ulSeconds]()
+    {
+        std::unique_lock<std::mutex> CheckpointLock(g_CheckpointMutex);
+
+        while (g_cvCheckpoint.wait_for(CheckpointLock, std::chrono::seconds(ulSeconds),
+                                       []() { return g_bCheckpointStop; }) == false)
+        {
+            CheckpointLock.unlock();
+            CheckpointServerDB();
+            CheckpointLock.lock();
+        }
+    });
+};
+
+void StopCheckpointThread(void)
+{
+    if (g_pCheckpointThread == nullptr)
+        return;
+
+    {
+        std::lock_guard<std::mutex> CheckpointLock(g_CheckpointMutex);
+        g_bCheckpointStop = true;
+    }
+    g_cvCheckpoint.notify_one();
+
+    // a checkpoint in progress is completed first
+    g_pCheckpointThread->join();
+    delete g_pCheckpointThread;
+    g_pCheckpointThread = nullptr;
+};
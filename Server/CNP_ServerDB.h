@@ -16,10 +16,18 @@
     #include "CNP_Common.h"
 #endif
 
+#ifndef __CNP_WRITE_AHEAD_LOG_H__
+    #include "CNP_WriteAheadLog.h"
+#endif
+
 #ifndef _MAP_
     #include <map>
 #endif
 
+#ifndef _VECTOR_
+    #include <vector>
+#endif
+
 /**
     ACCOUNT_INFO is used to maintain and persist 
     information as it relates to an individual
@@ -142,7 +150,48 @@ struct TRANSACTION_INFO :
 };
 
 typedef std::map<ACCOUNT_INFO::key_type,     ACCOUNT_INFO>     AccountMap_t;
-typedef std::map<TRANSACTION_INFO::key_type, TRANSACTION_INFO> TransactionMap_t;
+
+class CNP_TransactionLedger;
+
+/// Secondary index of the transaction ledger, mapping a customer ID to the
+/// IDs of that customer's transactions in ascending order
+typedef std::map<cnp::QWORD, std::vector<TRANSACTION_INFO::key_type> > CustomerTransactionIndex_t;
+
+/// Net amount of each customer's sealed transactions, the base their
+/// in-memory transactions are applied to when recomputing balances
+typedef std::map<cnp::QWORD, long long> CustomerBalanceMap_t;
+
+/// identifies a saved table file, "CNPD" in file order
+const cnp::DWORD SERVER_DB_MAGIC   = 0x44504E43;
+/// layout version of a saved table file
+const cnp::DWORD SERVER_DB_VERSION = 1;
+
+/// flags of a saved table file
+enum SERVER_DB_FLAGS
+{
+    SDF_SORTED  = 0x01      ///< records are in ascending primary key order
+};
+
+/**
+    SERVER_DB_FILE_HDR precedes the records of a saved table file, which
+    follow it as a packed array.  Files saved before it was introduced
+    hold just the records.
+ */
+struct SERVER_DB_FILE_HDR
+{
+    cnp::DWORD  m_dwMagic;      ///< SERVER_DB_MAGIC
+    cnp::DWORD  m_dwVersion;    ///< SERVER_DB_VERSION
+    cnp::DWORD  m_cbRecord;     ///< size of each record in bytes
+    cnp::DWORD  m_dwFlags;      ///< SERVER_DB_FLAGS
+    cnp::QWORD  m_qwRecords;    ///< number of records following the header
+};
+
+/// record types of the server database's write-ahead log
+enum SERVER_LOG_RECORD
+{
+    SLR_ACCOUNT      = 1,   ///< ACCOUNT_INFO of a newly created account
+    SLR_TRANSACTION  = 2    ///< TRANSACTION_INFO of a newly recorded transaction
+};
 
 /**
     Generate a unique customer ID from a given name + PIN combination
@@ -157,16 +206,100 @@ typedef std::map<TRANSACTION_INFO::key_type, TRANSACTION_INFO> TransactionMap_t;
 cnp::QWORD GenerateCustomerID(const char* szFirstName, size_t cbLen, cnp::WORD wPIN) noexcept;
 
 /**
-   Loads into runtime memory the server database records from the persisted store
+   Rebuilds the per-customer transaction index from the transaction ledger
+
+   @param [in]  Ledger   in-memory transactions to index
+   @param [out] Index    receives the index, any previous contents are discarded
+
+   @retval size_t containing the number of customers indexed
+*/
+size_t     BuildCustomerTransactionIndex(const CNP_TransactionLedger& Ledger,
+                                         CustomerTransactionIndex_t& Index);
+
+/**
+   Sets how the transaction ledger is tiered, before LoadServerDB()
+
+   @param [in] nHotTransactions   most recent transactions kept in memory, older
+                                  ones being sealed into on-disk segments once
+                                  twice as many are held, 0 keeps them all
+   @param [in] cbBlockCache       bytes of sealed segments cached in memory
+*/
+void       ConfigureLedger   (size_t nHotTransactions, size_t cbBlockCache);
+
+/**
+   Seals the oldest in-memory transactions into a new ledger segment, if
+   the in-memory table has outgrown its limit
+
+   @retval size_t containing the number of transactions sealed
+*/
+size_t     SealTransactions  (void);
+
+/**
+   Retrieves a customer's transactions, sealed or in memory
+
+   @param [in]  qwCustomerID      customer whose transactions to retrieve
+   @param [in]  dwStartID         lowest transaction ID to retrieve
+   @param [in]  nMax              most transactions to retrieve
+   @param [out] vecTransactions   receives the transactions, in ID order
+
+   @retval size_t containing the number of transactions retrieved
+*/
+size_t     QueryCustomerTransactions(const cnp::QWORD& qwCustomerID, cnp::DWORD dwStartID, size_t nMax,
+                                     std::vector<cnp::TRANSACTION>& vecTransactions);
+
+/**
+   Loads into runtime memory the server database records from the persisted store,
+   then replays the records logged since it was last saved
 
    @retval size_t containing the number of records loaded
 */
 size_t     LoadServerDB      (void);
 /**
-   Saves the current server database records to persisted store
+   Saves the current server database records to persisted store, then
+   discards the logged records it now holds
 
    @retval size_t contain the number of records saved to file
 */
 size_t     SaveServerDB      (void);
 
+/**
+   Saves a point-in-time snapshot of the server database without pausing
+   request processing for the length of the save, then discards the
+   logged records it holds.
+
+   On Linux the snapshot is written by a forked child process from its
+   copy-on-write image of the tables, elsewhere the tables are copied.
+
+   @retval true  on success
+   @retval false on failure, the logged records are then kept
+*/
+bool       CheckpointServerDB(void);
+
+/**
+   Starts a thread that calls CheckpointServerDB() periodically
+
+   @param [in] ulSeconds   interval between checkpoints, 0 disables them
+*/
+void       StartCheckpointThread(unsigned long ulSeconds);
+/**
+   Stops the checkpoint thread, completing any checkpoint in progress
+*/
+void       StopCheckpointThread (void);
+
+/**
+   Opens the server database's write-ahead log, which must follow LoadServerDB()
+
+   @param [in] eMode          durability of logged records
+   @param [in] ulGroupDelay   microseconds a batched group commit collects records for
+
+   @retval true  on success
+   @retval false on failure
+*/
+bool       OpenServerLog     (CNP_WriteAheadLog::SYNC_MODE eMode, unsigned long ulGroupDelay);
+/**
+   Commits any pending log records & closes the write-ahead log, which
+   must precede SaveServerDB()
+*/
+void       CloseServerLog    (void) noexcept;
+
 #endif
\ No newline at end of file
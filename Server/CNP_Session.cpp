@@ -1,6 +1,6 @@
 /**
  * @file   CNP_Session.cpp
- * @brief  SessionMap_t Global Instance
+ * @brief  CNP_SessionTable Global Instance
  *
  * @author Mark L. Short
  * @date   April 10, 2015
@@ -8,7 +8,10 @@
  * 
  */
 
-#include "CNP_Session.h"
+#include "CNP_SessionTable.h"
+#include "CNP_ClientIdAllocator.h"
 
-/// Global SessionMap_t instance
-SessionMap_t                                g_SessionInfo;
\ No newline at end of file
+/// Global CNP_SessionTable instance, a slot per Client ID
+CNP_SessionTable                            g_SessionTable;
+/// Global CNP_ClientIdAllocator instance, issuing the Client IDs
+CNP_ClientIdAllocator                       g_ClientIdAllocator;
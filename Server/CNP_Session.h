@@ -15,13 +15,8 @@
     #include "CNP_Common.h"
 #endif
 
-#ifndef __CNP_SOCKET_H__
-    #include "CNP_Socket.h"
-#endif
-
-#ifndef _MAP_
-    #include <map>
-#endif
+// forward declaration
+class CNP_Connection;
 
 /**
     A basic enumeration of allowable session states
@@ -39,7 +34,7 @@ enum SESSION_STATE
 /**
     SESSION_INFO is a runtime only data-structure
     used to maintain an association between Client ID,
-    session state, socket connection & Customer ID.
+    session state, client connection & Customer ID.
  */
 struct SESSION_INFO
 {
@@ -47,14 +42,25 @@ struct SESSION_INFO
 
     cnp::WORD     m_wClientID; ///< Key field
     cnp::WORD     m_wState;
-    CNP_Socket*   m_pSocket;
+    cnp::DWORD    m_dwGeneration; ///< tells apart the sessions issued the same Client ID
+    CNP_Connection* m_pConnection;
     cnp::QWORD    m_qwCustomerID;
 
+    /// Default Constructor
+    constexpr SESSION_INFO(void) noexcept
+        : m_wClientID   (cnp::INVALID_CLIENT_ID),
+          m_wState      (static_cast<cnp::WORD>(SS_INVALID)),
+          m_dwGeneration(0),
+          m_pConnection (nullptr),
+          m_qwCustomerID(INVALID_CUSTOMER_ID)
+    { };
+
     /// Initialization Constructor
-    constexpr SESSION_INFO(cnp::WORD wClientID, SESSION_STATE sState, CNP_Socket* pSocket = nullptr) noexcept
+    constexpr SESSION_INFO(cnp::WORD wClientID, SESSION_STATE sState, CNP_Connection* pConn = nullptr) noexcept
         : m_wClientID   (wClientID),
           m_wState      (static_cast<cnp::WORD>(sState)),
-          m_pSocket     (pSocket),
+          m_dwGeneration(0),
+          m_pConnection (pConn),
           m_qwCustomerID(INVALID_CUSTOMER_ID)
     { };
 
@@ -70,6 +76,12 @@ struct SESSION_INFO
     inline void             set_State(SESSION_STATE sSet) noexcept
     { m_wState = static_cast<cnp::WORD>(sSet); };
 
+    inline cnp::DWORD       get_Generation(void) const noexcept
+    { return m_dwGeneration; };
+
+    inline void             set_Generation(cnp::DWORD dwSet) noexcept
+    { m_dwGeneration = dwSet; };
+
     inline const cnp::QWORD& get_CustomerID(void) const noexcept
     { return m_qwCustomerID; };
 
@@ -78,6 +90,54 @@ struct SESSION_INFO
 
 };
 
-typedef std::map<SESSION_INFO::key_type, SESSION_INFO>     SessionMap_t;
+/**
+    QUERY_CURSOR is where a transaction query continues from, once its
+    response stream has been cut short at the connection's output limit.
+ */
+struct QUERY_CURSOR
+{
+    cnp::WORD   m_wClientID;    ///< copied from the TRANSACTION_QUERY_REQUEST
+    cnp::DWORD  m_dwSequence;   ///< copied from the TRANSACTION_QUERY_REQUEST
+    cnp::DWORD  m_dwContext;    ///< copied from the TRANSACTION_QUERY_REQUEST
+    cnp::DWORD  m_dwStartID;    ///< transaction ID the next frame starts at
+    size_t      m_nRemaining;   ///< records yet to be sent, 0 once the stream has ended
+
+    QUERY_CURSOR(void) noexcept
+        : m_wClientID (cnp::INVALID_CLIENT_ID),
+          m_dwSequence(0),
+          m_dwContext (0),
+          m_dwStartID (0),
+          m_nRemaining(0)
+    { };
+
+    /// @retval true if the query has frames yet to be sent
+    inline bool             IsPending(void) const noexcept
+    { return m_nRemaining > 0; };
+};
+
+/**
+    SESSION_CONTEXT is the session bound to a CNP_Connection, created by
+    its connect request & handed to each of its later requests' handlers.
+    Only the event loop servicing the connection touches it, so it needs
+    no lock.
+ */
+struct SESSION_CONTEXT
+{
+    SESSION_INFO    m_Info;       ///< SS_INVALID until a connect request succeeds
+    ACCOUNT_HANDLE  m_hAccount;   ///< account of the logged on customer
+    QUERY_CURSOR    m_Query;      ///< transaction query waiting on the output to drain
+
+    /// @retval true once a connect request has opened the session
+    inline bool             IsOpen(void) const noexcept
+    { return m_Info.get_State() != SS_INVALID; };
+
+    /// closes the session, freeing nothing
+    inline void             Reset(void) noexcept
+    {
+        m_Info     = SESSION_INFO();
+        m_hAccount = ACCOUNT_HANDLE();
+        m_Query    = QUERY_CURSOR();
+    };
+};
 
 #endif
\ No newline at end of file
@@ -0,0 +1,59 @@
+/**
+ * @file   CNP_SessionTable.cpp
+ * @brief  CNP_SessionTable class implementation
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#include "CNP_SessionTable.h"
+
+
+bool CNP_SessionTable::Open(cnp::WORD wClientID, CNP_Connection* pConn)
+{
+    if (wClientID == cnp::INVALID_CLIENT_ID)
+        return false;
+
+    SLOT& Slot = m_rgSlots[wClientID];
+
+    std::lock_guard<std::mutex> SlotLock(Slot.m_Mutex);
+
+    if (Slot.m_Session.get_State() != SS_INVALID)
+        return false;
+
+    // the generation outlives the session, telling it apart from the slot's earlier ones
+    cnp::DWORD dwGeneration = Slot.m_Session.get_Generation() + 1;
+
+    Slot.m_Session = SESSION_INFO(wClientID, SS_CONNECTED, pConn);
+    Slot.m_Session.set_Generation(dwGeneration);
+    return true;
+};
+
+bool CNP_SessionTable::Close(cnp::WORD wClientID)
+{
+    SLOT& Slot = m_rgSlots[wClientID];
+
+    std::lock_guard<std::mutex> SlotLock(Slot.m_Mutex);
+
+    if (Slot.m_Session.get_State() == SS_INVALID)
+        return false;
+
+    Slot.m_Session.set_State(SS_INVALID);
+    Slot.m_Session.set_CustomerID(INVALID_CUSTOMER_ID);
+    Slot.m_Session.m_pConnection = nullptr;
+    return true;
+};
+
+bool CNP_SessionTable::Find(cnp::WORD wClientID, SESSION_INFO& Session) const
+{
+    const SLOT& Slot = m_rgSlots[wClientID];
+
+    std::lock_guard<std::mutex> SlotLock(Slot.m_Mutex);
+
+    if (Slot.m_Session.get_State() == SS_INVALID)
+        return false;
+
+    Session = Slot.m_Session;
+    return true;
+};
@@ -0,0 +1,93 @@
+/**
+ * @file   CNP_SessionTable.h
+ * @brief  CNP_SessionTable class interface
+ *
+ * CNP_SessionTable holds a SESSION_INFO for every possible 16 bit Client
+ * ID in a flat array, so that finding a client's session is a single
+ * index operation rather than a tree search.  Each slot is a cache line
+ * apart from its neighbours & guarded by its own lock, which is only
+ * held while the slot is copied or changed.
+ *
+ * The table is only the directory of the open sessions & the
+ * connections they belong to.  Requests are handled against the
+ * SESSION_CONTEXT bound to their connection, never through the table.
+ * A slot's generation is incremented each time a session is opened in
+ * it, telling apart the sessions issued the same Client ID.
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#if !defined(__CNP_SESSION_TABLE_H__)
+#define __CNP_SESSION_TABLE_H__
+
+#ifndef __CNP_SESSION_H__
+    #include "CNP_Session.h"
+#endif
+
+#ifndef _MEMORY_
+    #include <memory>
+#endif
+
+#ifndef _MUTEX_
+    #include <mutex>
+#endif
+
+class CNP_SessionTable
+{
+public:
+    static const size_t SLOT_COUNT = size_t(1) << 16;   ///< one per 16 bit Client ID
+
+private:
+    struct alignas(64) SLOT
+    {
+        mutable std::mutex  m_Mutex;
+        SESSION_INFO        m_Session;   ///< guarded by m_Mutex, SS_INVALID while free
+    };
+
+    /// allocated at run time, keeping the 8 MB of initialized slots out of the executable
+    std::unique_ptr<SLOT[]>  m_rgSlots;
+
+public:
+    /// Default Constructor
+    CNP_SessionTable(void)
+        : m_rgSlots(new SLOT[SLOT_COUNT])
+    { };
+
+/**
+    @brief Opens a session in a free slot
+
+    @param [in] wClientID   Client ID of the new session
+    @param [in] pConn       connection the session belongs to
+
+    @retval true  on success
+    @retval false if the ID is invalid or its slot is already in use
+ */
+    bool          Open   (cnp::WORD wClientID, CNP_Connection* pConn);
+
+/**
+    @brief Frees a session's slot
+
+    @retval true  on success
+    @retval false if no such session is open
+ */
+    bool          Close  (cnp::WORD wClientID);
+
+/**
+    @brief Copies an open session
+
+    @param [in]  wClientID   Client ID of the session
+    @param [out] Session     receives the session, including its generation
+
+    @retval true  on success
+    @retval false if no such session is open
+ */
+    bool          Find   (cnp::WORD wClientID, SESSION_INFO& Session) const;
+
+private:
+    CNP_SessionTable(const CNP_SessionTable&);
+    CNP_SessionTable& operator=(const CNP_SessionTable&);
+};
+
+#endif
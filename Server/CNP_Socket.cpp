@@ -100,19 +100,29 @@ bool CNP_Socket::SetBlocking(bool bBlocking /* = true */) noexcept
 }
 
 
-bool CNP_Socket::Create(unsigned short wPort) noexcept
+bool CNP_Socket::Create(unsigned short wPort, bool bReusePort /* = false */, bool bLoopback /* = false */) noexcept
 {
     bool bResult = false;
+#ifdef __linux__
+    m_hSocket = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+#elif _MSC_VER
     m_hSocket = ::socket(AF_INET, SOCK_STREAM, 0);
+#endif
  
     if (m_hSocket != INVALID_SOCKET)
     {
         int iOn = 1;
         SetSocketOption(SOL_SOCKET, SO_REUSEADDR, &iOn, sizeof(iOn));
+#ifdef __linux__
+        if (bReusePort)
+            SetSocketOption(SOL_SOCKET, SO_REUSEPORT, &iOn, sizeof(iOn));
+#else
+        (void) bReusePort;
+#endif
 
         m_LocalAddr.sin_family      = AF_INET;
         m_LocalAddr.sin_port        = ::htons(wPort);
-        m_LocalAddr.sin_addr.s_addr = INADDR_ANY;
+        m_LocalAddr.sin_addr.s_addr = bLoopback ? ::htonl(INADDR_LOOPBACK) : INADDR_ANY;
         if (::bind(m_hSocket, reinterpret_cast<struct sockaddr *>( &m_LocalAddr), sizeof(m_LocalAddr)) != SOCKET_ERROR)
         {
             m_wPort = wPort;
@@ -175,7 +185,7 @@ bool CNP_Socket::Listen(int iBackLog) noexcept
     bool bResult = false;
     if (m_hSocket != INVALID_SOCKET)
     {
-       if (::listen(m_hSocket, iBackLog) != SOCKET_ERROR)
+       if (::listen(m_hSocket, iBackLog) == SOCKET_ERROR)
            m_iError = CNP_GetLastError(); //errno;
        else
            bResult = true;
@@ -193,6 +203,17 @@ void CNP_Socket::Close(void) noexcept
     }
 };
 
+void CNP_Socket::Attach(SOCKET hSocket, const sockaddr_in& remoteAddr) noexcept
+{
+    Close();
+
+    m_hSocket    = hSocket;
+    m_wPort      = 0;
+    m_iError     = 0;
+    m_RemoteAddr = remoteAddr;
+    memset(&m_LocalAddr, 0, sizeof(m_LocalAddr));
+};
+
 bool CNP_Socket::Accept(SOCKET& hSocket, sockaddr_in& remoteAddr) noexcept
 {
     bool bResult = false;
@@ -202,7 +223,12 @@ bool CNP_Socket::Accept(SOCKET& hSocket, sockaddr_in& remoteAddr) noexcept
     int sin_size = sizeof(struct sockaddr_in);
 #endif
 
+#ifdef __linux__
+    hSocket  = ::accept4(m_hSocket, reinterpret_cast< struct sockaddr * >(&remoteAddr), &sin_size, 
+                         SOCK_NONBLOCK | SOCK_CLOEXEC);
+#elif _MSC_VER
     hSocket  = ::accept(m_hSocket, reinterpret_cast< struct sockaddr * >(&remoteAddr), &sin_size);
+#endif
     if (hSocket != INVALID_SOCKET)
     {
         bResult = true;
@@ -232,6 +258,26 @@ int CNP_Socket::Send(const void* pData, size_t cbLen, int iFlags /* = 0 */) noex
     return nResult == -1 ? SOCKET_ERROR : nResult;
 };
 
+int CNP_Socket::SendV(const IO_BUFFER* pBuffers, size_t nCount, int iFlags /* = 0 */) noexcept
+{
+#ifdef __linux__
+    msghdr msg = { 0 };
+    msg.msg_iov    = const_cast<IO_BUFFER*>(pBuffers);
+    msg.msg_iovlen = nCount;
+
+    // a peer that has gone away is reported as EPIPE, rather than by SIGPIPE
+    ssize_t nResult = ::sendmsg(m_hSocket, &msg, iFlags | MSG_NOSIGNAL);
+    m_iError        = CNP_GetLastError();
+    return nResult == -1 ? SOCKET_ERROR : static_cast<int>(nResult);
+#elif _MSC_VER
+    DWORD dwSent    = 0;
+    int   nResult   = ::WSASend(m_hSocket, const_cast<IO_BUFFER*>(pBuffers), static_cast<DWORD>(nCount),
+                                &dwSent, static_cast<DWORD>(iFlags), nullptr, nullptr);
+    m_iError        = CNP_GetLastError();
+    return nResult == SOCKET_ERROR ? SOCKET_ERROR : static_cast<int>(dwSent);
+#endif
+};
+
 int CNP_Socket::SetSocketOption(int iLevel, int iOption, const void* pVal, size_t cbLen) noexcept
 {
 #ifdef __linux__
@@ -26,11 +26,22 @@
         #define SOCKET_ERROR            (-1)
     #endif
     #include <netinet/in.h>
+    #include <sys/uio.h>
+
+    typedef struct iovec IO_BUFFER;  ///< scatter/gather element for SendV()
+
+    inline void SetIOBuffer(IO_BUFFER& ioBuf, const void* pData, size_t cbLen) noexcept
+    { ioBuf.iov_base = const_cast<void*>(pData); ioBuf.iov_len = cbLen; };
 #elif _MSC_VER
     #define WIN32_LEAN_AND_MEAN
 
     #include <winsock2.h>
     #include <Ws2tcpip.h>
+
+    typedef WSABUF IO_BUFFER;        ///< scatter/gather element for SendV()
+
+    inline void SetIOBuffer(IO_BUFFER& ioBuf, const void* pData, size_t cbLen) noexcept
+    { ioBuf.buf = static_cast<char*>(const_cast<void*>(pData)); ioBuf.len = static_cast<ULONG>(cbLen); };
 #endif
 
 
@@ -62,7 +73,29 @@ public:
 
     void Close(void) noexcept;
 
-    bool Create (unsigned short wPort) noexcept;
+/**
+    closes any currently held handle & takes ownership of an accepted one,
+    allowing a CNP_Socket object to be reused across connections
+
+    @param [in] hSocket      accepted socket handle
+    @param [in] remoteAddr   address of the connected peer
+ */
+    void Attach(SOCKET hSocket, const sockaddr_in& remoteAddr) noexcept;
+
+/**
+    creates the underlying socket & binds it to the given local port
+
+    @param [in] wPort       local port to bind to
+    @param [in] bReusePort  [Linux] set SO_REUSEPORT so that several sockets may
+                            bind the same port, with the kernel distributing
+                            incoming connections between them
+    @param [in] bLoopback   bind the loopback address only, rather than every
+                            local address
+
+    @retval true  on success
+    @retval false on failure
+ */
+    bool Create (unsigned short wPort, bool bReusePort = false, bool bLoopback = false) noexcept;
     bool Connect(const char* szHostAddress, unsigned short wPort) noexcept;
 /**
     places the underlying socket in a state in which it is listening for an incoming connection
@@ -76,6 +109,17 @@ public:
  */
     bool Listen (int iBackLog) noexcept;
 
+/**
+    accepts a pending connection on a listening socket
+
+    On Linux the accepted socket is created non-blocking & close-on-exec.
+
+    @param [out] hSocket     receives the accepted socket handle
+    @param [out] remoteAddr  receives the address of the connecting peer
+
+    @retval true  on success
+    @retval false on failure  call GetError() to retrieve the specific error code
+ */
     bool Accept (SOCKET& hSocket, sockaddr_in& remoteAddr) noexcept;
 
 /**
@@ -93,6 +137,19 @@ public:
  */
     int  Receive(void* pData, size_t cbLen, int iFlags = 0) noexcept;
     int  Send   (const void* pData, size_t cbLen, int iFlags = 0) noexcept;
+
+/**
+    @brief Sends the contents of several buffers with a single gathering write
+
+    @param [in] pBuffers    array of buffers, sent in order
+    @param [in] nCount      number of elements in pBuffers
+    @param [in] iFlags      Optional parameter that influences the behavior of this function
+
+    @retval int             containing the number of bytes sent, which may be less than the
+                            total if the socket is non-blocking
+    @retval SOCKET_ERROR    on failure  call GetError() to retrieve the specific error code
+ */
+    int  SendV  (const IO_BUFFER* pBuffers, size_t nCount, int iFlags = 0) noexcept;
 /**
    @brief Sets the underlying socket option
 
@@ -128,6 +185,12 @@ public:
     @retval false on failure
  */
     bool Shutdown(int iHow) noexcept;
+/**
+    @retval SOCKET containing the underlying socket handle
+ */
+    constexpr SOCKET get_Handle(void) const noexcept
+    { return m_hSocket; };
+
 /**
     @retval int   containing the most recent error code
  */
@@ -0,0 +1,125 @@
+/**
+ * @file   CNP_TransactionLedger.cpp
+ * @brief  CNP_TransactionLedger class implementation
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#include "CNP_TransactionLedger.h"
+
+
+CNP_TransactionLedger::CNP_TransactionLedger(void) noexcept
+    : m_rgChunks(),
+      m_dwFirstID(1),
+      m_dwLastID(0),
+      m_nCount(0)
+{
+    for (auto& it : m_rgChunks)
+        it.store(nullptr, std::memory_order_relaxed);
+};
+
+CNP_TransactionLedger::~CNP_TransactionLedger()
+{
+    for (auto& it : m_rgChunks)
+        delete it.load();
+};
+
+CNP_TransactionLedger::SLOT* CNP_TransactionLedger::GetSlot(cnp::DWORD dwID)
+{
+    std::atomic<CHUNK*>& Entry  = m_rgChunks[dwID >> CHUNK_BITS];
+    CHUNK*               pChunk = Entry.load(std::memory_order_acquire);
+
+    if (pChunk == nullptr)
+    {
+        // value initialized, so every slot starts out unpublished
+        CHUNK* pNew = new CHUNK();
+
+        // whoever installs a chunk first wins, the others use theirs
+        if (Entry.compare_exchange_strong(pChunk, pNew, std::memory_order_acq_rel))
+            pChunk = pNew;
+        else
+            delete pNew;
+    }
+
+    return &pChunk->m_rgSlots[dwID & (CHUNK_SIZE - 1)];
+};
+
+bool CNP_TransactionLedger::Publish(const TRANSACTION_INFO& Record)
+{
+    cnp::DWORD dwID = Record.get_ID();
+
+    if (dwID < m_dwFirstID.load() || dwID > MAX_ID)
+        return false;
+
+    SLOT* pSlot = GetSlot(dwID);
+
+    // a replayed transaction may already have been loaded
+    if (pSlot->m_bPublished.load(std::memory_order_acquire))
+        return false;
+
+    pSlot->m_Record = Record;
+    pSlot->m_bPublished.store(true, std::memory_order_release);
+    m_nCount++;
+
+    // a loaded or replayed ID may lie beyond any reserved so far
+    cnp::DWORD dwLastID = m_dwLastID.load();
+    while (dwLastID < dwID && m_dwLastID.compare_exchange_weak(dwLastID, dwID) == false)
+        ;
+
+    return true;
+};
+
+bool CNP_TransactionLedger::Find(cnp::DWORD dwID, TRANSACTION_INFO& Record) const
+{
+    if (dwID < m_dwFirstID.load() || dwID > MAX_ID)
+        return false;
+
+    const CHUNK* pChunk = m_rgChunks[dwID >> CHUNK_BITS].load(std::memory_order_acquire);
+    if (pChunk == nullptr)
+        return false;
+
+    const SLOT& Slot = pChunk->m_rgSlots[dwID & (CHUNK_SIZE - 1)];
+    if (Slot.m_bPublished.load(std::memory_order_acquire) == false)
+        return false;
+
+    Record = Slot.m_Record;
+    return true;
+};
+
+size_t CNP_TransactionLedger::Count(cnp::DWORD dwFirstID, cnp::DWORD dwLastID) const
+{
+    size_t nResult = 0;
+
+    ForEach(dwFirstID, dwLastID, [&nResult](const TRANSACTION_INFO&) { nResult++; });
+
+    return nResult;
+};
+
+size_t CNP_TransactionLedger::Release(cnp::DWORD dwLastID)
+{
+    cnp::DWORD dwFirstID = m_dwFirstID.load();
+
+    if (dwLastID < dwFirstID)
+        return 0;
+
+    if (dwLastID > MAX_ID)
+        dwLastID = MAX_ID;
+
+    size_t nResult = Count(dwFirstID, dwLastID);
+
+    // IDs carry on past the released ones, even if none later are held
+    cnp::DWORD dwReserved = m_dwLastID.load();
+    while (dwReserved < dwLastID && m_dwLastID.compare_exchange_weak(dwReserved, dwLastID) == false)
+        ;
+
+    m_dwFirstID.store(dwLastID + 1);
+    m_nCount -= nResult;
+
+    // only the chunks lying wholly below the first ID kept are freed
+    for (size_t nChunk = dwFirstID >> CHUNK_BITS; nChunk < ((dwLastID + 1) >> CHUNK_BITS); nChunk++)
+        delete m_rgChunks[nChunk].exchange(nullptr);
+
+    return nResult;
+};
@@ -0,0 +1,174 @@
+/**
+ * @file   CNP_TransactionLedger.h
+ * @brief  CNP_TransactionLedger class interface
+ *
+ * CNP_TransactionLedger holds the in-memory TRANSACTION_INFO table as an
+ * append-only array of fixed size slots, indexed directly by transaction
+ * ID & allocated a chunk at a time.  A writer reserves the next ID with
+ * a single atomic increment, fills in the slot it owns & then publishes
+ * it; readers only ever see published slots.  Recording a transaction
+ * therefore takes no lock & allocates no node, & both appends & lookups
+ * are O(1).
+ *
+ * Once the oldest transactions are sealed into a ledger segment they are
+ * released, freeing each chunk they filled entirely.
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#if !defined(__CNP_TRANSACTION_LEDGER_H__)
+#define __CNP_TRANSACTION_LEDGER_H__
+
+#ifndef __CNP_SERVER_DB_H__
+    #include "CNP_ServerDB.h"
+#endif
+
+#ifndef _ATOMIC_
+    #include <atomic>
+#endif
+
+class CNP_TransactionLedger
+{
+public:
+    static const unsigned CHUNK_BITS = 16;
+    static const size_t   CHUNK_SIZE = size_t(1) << CHUNK_BITS;          ///< 65,536 slots per chunk
+    static const size_t   MAX_CHUNKS = size_t(1) << (32 - CHUNK_BITS);   ///< enough for every 32 bit ID
+    static const cnp::DWORD MAX_ID   = static_cast<cnp::DWORD>(MAX_CHUNKS * CHUNK_SIZE - 1);
+
+private:
+    struct SLOT
+    {
+        TRANSACTION_INFO   m_Record;
+        std::atomic<bool>  m_bPublished;   ///< set once m_Record is complete
+    };
+
+    struct CHUNK
+    {
+        SLOT  m_rgSlots[CHUNK_SIZE];
+    };
+
+    std::atomic<CHUNK*>      m_rgChunks[MAX_CHUNKS];   ///< allocated on first use
+    std::atomic<cnp::DWORD>  m_dwFirstID;              ///< lower IDs have been released
+    std::atomic<cnp::DWORD>  m_dwLastID;               ///< highest ID reserved or published
+    std::atomic<size_t>      m_nCount;                 ///< published from m_dwFirstID on
+
+public:
+    /// Default Constructor
+    CNP_TransactionLedger(void) noexcept;
+
+    ~CNP_TransactionLedger();
+
+/**
+    @brief Reserves the next transaction ID, whose slot the caller then
+           fills in through Publish()
+
+    @retval cnp::DWORD containing the new ID
+ */
+    inline cnp::DWORD  Reserve(void) noexcept
+    { return ++m_dwLastID; };
+
+/**
+    @brief Stores a transaction in the slot of its ID & makes it visible
+           to readers
+
+    Also used to load & replay transactions, whose IDs need not have
+    been reserved.
+
+    @retval true  on success
+    @retval false if the ID has been released, is out of range, or is
+                  already published
+ */
+    bool         Publish(const TRANSACTION_INFO& Record);
+
+/**
+    @brief Retrieves a published transaction
+
+    @param [in]  dwID     ID of the transaction
+    @param [out] Record   receives the transaction
+
+    @retval true  on success
+    @retval false if no transaction of that ID is published
+ */
+    bool         Find   (cnp::DWORD dwID, TRANSACTION_INFO& Record) const;
+
+/**
+    @brief Invokes fnVisit(const TRANSACTION_INFO&) for each published
+           transaction with an ID in [dwFirstID, dwLastID], in ID order
+ */
+    template <class _Fn>
+    void         ForEach(cnp::DWORD dwFirstID, cnp::DWORD dwLastID, _Fn fnVisit) const
+    {
+        if (dwFirstID < m_dwFirstID.load())
+            dwFirstID = m_dwFirstID.load();
+        if (dwLastID > m_dwLastID.load())
+            dwLastID = m_dwLastID.load();
+        if (dwLastID > MAX_ID)
+            dwLastID = MAX_ID;
+
+        for (cnp::DWORD dwID = dwFirstID; dwID <= dwLastID && dwID >= dwFirstID; )
+        {
+            const CHUNK* pChunk = m_rgChunks[dwID >> CHUNK_BITS].load(std::memory_order_acquire);
+            cnp::DWORD   dwNext = ((dwID >> CHUNK_BITS) + 1) << CHUNK_BITS;
+
+            for (; pChunk && dwID <= dwLastID && dwID < dwNext; dwID++)
+            {
+                const SLOT& Slot = pChunk->m_rgSlots[dwID & (CHUNK_SIZE - 1)];
+
+                if (Slot.m_bPublished.load(std::memory_order_acquire))
+                    fnVisit(Slot.m_Record);
+            }
+
+            // a chunk never allocated holds nothing
+            dwID = dwNext;
+        }
+    };
+
+/**
+    @brief Invokes fnVisit(const TRANSACTION_INFO&) for each published
+           transaction, in ID order
+ */
+    template <class _Fn>
+    void         ForEach(_Fn fnVisit) const
+    { ForEach(m_dwFirstID.load(), m_dwLastID.load(), fnVisit); };
+
+/**
+    @retval size_t containing the number of published transactions with
+            an ID in [dwFirstID, dwLastID]
+ */
+    size_t       Count  (cnp::DWORD dwFirstID, cnp::DWORD dwLastID) const;
+
+/**
+    @brief Drops every transaction up to & including an ID, freeing the
+           chunks they filled
+
+    @pre no reader accesses the released IDs concurrently
+
+    @param [in] dwLastID   highest ID to release, every later ID reserved
+                           or published is kept
+
+    @retval size_t containing the number of transactions released
+ */
+    size_t       Release(cnp::DWORD dwLastID);
+
+    /// lowest ID still held
+    inline cnp::DWORD  get_FirstID(void) const noexcept
+    { return m_dwFirstID.load(); };
+
+    /// highest ID reserved or published
+    inline cnp::DWORD  get_LastID(void) const noexcept
+    { return m_dwLastID.load(); };
+
+    inline size_t      Size(void) const noexcept
+    { return m_nCount.load(); };
+
+private:
+    /// @retval address of the slot of an ID, allocating its chunk if need be
+    SLOT*        GetSlot(cnp::DWORD dwID);
+
+    CNP_TransactionLedger(const CNP_TransactionLedger&);
+    CNP_TransactionLedger& operator=(const CNP_TransactionLedger&);
+};
+
+#endif
@@ -0,0 +1,676 @@
+/**
+ * @file   CNP_UringReactor.cpp
+ * @brief  CNP_UringReactor class implementation
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#ifdef __linux__
+
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <set>
+#include <thread>
+#include <iostream>
+
+#include "CNP_Connection.h"
+#include "CNP_IoUring.h"
+#include "CNP_Server.h"
+#include "CNP_Logger.h"
+#include "CNP_UringReactor.h"
+
+/// submission queue entries per event loop
+static const unsigned RING_ENTRIES       = 256;
+/// provided receive buffers per event loop, a power of 2
+static const unsigned RECV_BUFFERS       = 256;
+/// size of each provided receive buffer
+static const unsigned RECV_BUFFER_SIZE   = 4096;
+/// most sends linked into a single chain
+static const size_t   MAX_LINKED_SENDS   = 8;
+/// upper bound on the number of closed connection contexts kept for reuse, per event loop
+static const size_t   MAX_FREE_CONNECTIONS = 256;
+
+/**
+    The operation a completion belongs to is encoded in the low bits of
+    its user data, the remaining bits hold the URING_CONN address
+ */
+enum URING_OP : uint64_t
+{
+    OP_WAKEUP       = 1,
+    OP_ACCEPT       = 2,
+    OP_ACCEPT_RETRY = 3,
+    OP_RECV         = 4,
+    OP_SEND         = 5,
+    OP_CANCEL       = 6,
+    OP_MASK         = 7
+};
+
+/**
+    A connection along with the state of the io_uring requests
+    outstanding on it.  The context is only released once none are.
+ */
+struct CNP_UringReactor::URING_CONN
+{
+    CNP_Connection  m_Conn;
+    size_t          m_nSends;      ///< linked sends in flight
+    bool            m_bRecvArmed;  ///< multishot receive in flight
+    bool            m_bRecvPaused; ///< receive cancelled until the output drains
+    bool            m_bClosing;
+    bool            m_bDirty;      ///< on the loop's dirty list
+
+    URING_CONN(void) noexcept
+        : m_Conn(),
+          m_nSends(0),
+          m_bRecvArmed(false),
+          m_bRecvPaused(false),
+          m_bClosing(false),
+          m_bDirty(false)
+    { };
+};
+
+/**
+    A single event loop thread, its io_uring instance & the connections
+    it services.  Everything here is only touched by the loop thread,
+    with the exception of the wakeup descriptor.
+ */
+struct CNP_UringReactor::RING_LOOP
+{
+    size_t                       m_nIndex;
+    CNP_IoUring                  m_Ring;
+    CNP_Socket*                  m_pListener;  ///< owned by CNP_UringReactor::m_vecSockets
+    int                          m_hWakeup;    ///< eventfd used to interrupt io_uring_enter
+    uint64_t                     m_qwWakeup;   ///< read target of the wakeup request
+    __kernel_timespec            m_tsRetry;    ///< accept retry delay
+    std::thread*                 m_pThread;
+    std::set<URING_CONN*>        m_setConns;
+    std::vector<URING_CONN*>     m_vecDirty;   ///< connections with responses to submit
+    std::vector<URING_CONN*>     m_vecFree;
+
+    explicit RING_LOOP(size_t nIndex) noexcept
+        : m_nIndex(nIndex),
+          m_Ring(),
+          m_pListener(nullptr),
+          m_hWakeup(-1),
+          m_qwWakeup(0),
+          m_tsRetry(),
+          m_pThread(nullptr),
+          m_setConns(),
+          m_vecDirty(),
+          m_vecFree()
+    { };
+};
+
+/// whether IsSupported() found provided buffer rings to work, rather
+/// than falling back to IORING_OP_PROVIDE_BUFFERS
+static bool g_bBufferRing = true;
+
+static inline uint64_t MakeUserData(const void* pContext, URING_OP opType) noexcept
+{
+    return reinterpret_cast<uint64_t>(pContext) | opType;
+}
+
+
+CNP_UringReactor::CNP_UringReactor(size_t nEventLoops /* = 0 */)
+    : m_vecSockets(),
+      m_vecLoops(),
+      m_bTerminate(false)
+{
+    if (nEventLoops == 0)
+        nEventLoops = std::thread::hardware_concurrency();
+    if (nEventLoops == 0)
+        nEventLoops = 1;
+
+    for (size_t i = 0; i < nEventLoops; i++)
+        m_vecLoops.push_back(new RING_LOOP(i));
+};
+
+CNP_UringReactor::~CNP_UringReactor()
+{
+    Stop();
+
+    for (auto& it : m_vecLoops)
+        delete it;
+};
+
+/**
+    @brief Exercises a multishot receive into provided buffers on a socket
+           pair, since a missing or broken feature is only reported when
+           the request completes
+
+    @param [in] bBufferRing   provide the buffers through a buffer ring
+ */
+static bool ProbeMultishotRecv(bool bBufferRing) noexcept
+{
+    static const unsigned char rgOps[] = { IORING_OP_ACCEPT, IORING_OP_RECV, IORING_OP_SEND,
+                                           IORING_OP_READ, IORING_OP_TIMEOUT, IORING_OP_ASYNC_CANCEL,
+                                           IORING_OP_PROVIDE_BUFFERS };
+    CNP_IoUring Ring;
+
+    if (Ring.Create(4) == false || Ring.ProbeOps(rgOps, COUNTOF(rgOps)) == false)
+        return false;
+
+    if (Ring.ProvideBuffers(0, 2, 64, bBufferRing) == false)
+        return false;
+
+    int rghPair[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, rghPair) == -1)
+        return false;
+
+    bool bResult = false;
+    char chData  = 0;
+
+    if (::write(rghPair[1], &chData, sizeof(chData)) == sizeof(chData))
+    {
+        io_uring_sqe* pSqe = Ring.GetSQE();
+        pSqe->opcode    = IORING_OP_RECV;
+        pSqe->fd        = rghPair[0];
+        pSqe->ioprio    = IORING_RECV_MULTISHOT;
+        pSqe->flags     = IOSQE_BUFFER_SELECT;
+        pSqe->buf_group = Ring.get_BufferGroup();
+
+        if (Ring.Submit(1) == 1)
+        {
+            io_uring_cqe* pCqe = Ring.PeekCQE();
+            bResult = pCqe && pCqe->res == 1 && (pCqe->flags & IORING_CQE_F_MORE);
+        }
+    }
+
+    ::close(rghPair[0]);
+    ::close(rghPair[1]);
+
+    return bResult;
+}
+
+bool CNP_UringReactor::IsSupported(void) noexcept
+{
+    // some kernels accept a buffer ring registration, yet never select
+    // from it, the older provide buffers request is the fallback
+    if (ProbeMultishotRecv(true))
+    {
+        g_bBufferRing = true;
+        return true;
+    }
+
+    if (ProbeMultishotRecv(false))
+    {
+        g_bBufferRing = false;
+        return true;
+    }
+
+    return false;
+};
+
+bool CNP_UringReactor::Start(unsigned short wPort, int iBackLog, bool bReusePort)
+{
+    for (auto& pLoop : m_vecLoops)
+    {
+        if (pLoop->m_Ring.Create(RING_ENTRIES) == false ||
+            pLoop->m_Ring.ProvideBuffers(0, RECV_BUFFERS, RECV_BUFFER_SIZE, g_bBufferRing) == false)
+        {
+            std::cerr << "failed to create io_uring event loop, Error:" << errno << std::endl;
+            return false;
+        }
+
+        pLoop->m_hWakeup = ::eventfd(0, EFD_CLOEXEC);
+        if (pLoop->m_hWakeup == -1)
+        {
+            std::cerr << "failed to create io_uring event loop, Error:" << errno << std::endl;
+            return false;
+        }
+
+        pLoop->m_tsRetry.tv_nsec = 100 * 1000 * 1000;
+
+        // without SO_REUSEPORT, every loop's multishot accept shares one socket
+        if (m_vecSockets.empty() || bReusePort)
+        {
+            CNP_Socket* pSocket = new CNP_Socket();
+            m_vecSockets.push_back(pSocket);
+
+            if (pSocket->Create(wPort, bReusePort) == false)
+                return false;
+
+            if (pSocket->Listen(iBackLog) == false)
+            {
+                std::cerr << "failed to listen on Port:" << wPort << " Error:" << pSocket->GetError() << std::endl;
+                return false;
+            }
+        }
+        pLoop->m_pListener = m_vecSockets.back();
+    }
+
+    for (auto& pLoop : m_vecLoops)
+        pLoop->m_pThread = new std::thread(&CNP_UringReactor::Run, this, pLoop);
+
+    std::cout << "Listening for connections on Port:" << wPort
+              << " with " << m_vecLoops.size() << " io_uring event loop(s), BackLog:" << iBackLog << std::endl;
+
+    return true;
+};
+
+void CNP_UringReactor::Stop(void) noexcept
+{
+    m_bTerminate = true;
+
+    for (auto& pLoop : m_vecLoops)
+    {
+        if (pLoop->m_pThread)
+        {
+            uint64_t qwSignal = 1;
+            if (::write(pLoop->m_hWakeup, &qwSignal, sizeof(qwSignal)) < 0)
+                std::cerr << "failed to signal event loop, Error:" << errno << std::endl;
+
+            pLoop->m_pThread->join();
+            delete pLoop->m_pThread;
+            pLoop->m_pThread = nullptr;
+        }
+
+        for (auto& pConn : pLoop->m_setConns)
+            pConn->m_Conn.get_Socket().Shutdown(SHUT_RDWR);
+
+        // tearing down the ring cancels every request still referencing a connection
+        pLoop->m_Ring.Close();
+
+        for (auto& pConn : pLoop->m_setConns)
+            delete pConn;
+        pLoop->m_setConns.clear();
+
+        for (auto& pConn : pLoop->m_vecFree)
+            delete pConn;
+        pLoop->m_vecFree.clear();
+
+        if (pLoop->m_hWakeup != -1)
+            ::close(pLoop->m_hWakeup);
+        pLoop->m_hWakeup = -1;
+    }
+
+    for (auto& pSocket : m_vecSockets)
+    {
+        pSocket->Close();
+        delete pSocket;
+    }
+    m_vecSockets.clear();
+};
+
+void CNP_UringReactor::Run(RING_LOOP* pLoop)
+{
+    std::cout << "Event loop ThreadID:" << GetThreadID() << std::endl;
+
+    CNP_IoUring& Ring = pLoop->m_Ring;
+
+    ArmWakeup(pLoop);
+    ArmAccept(pLoop);
+
+    while (m_bTerminate == false)
+    {
+        // submits everything queued by the previous pass & sleeps until
+        // at least one request completes
+        if (Ring.Submit(1) == -1 && errno != EINTR && errno != EBUSY)
+        {
+            std::cerr << "io_uring_enter failed, Error:" << errno << std::endl;
+            break;
+        }
+
+        io_uring_cqe* pCqe = nullptr;
+        while ((pCqe = Ring.PeekCQE()) != nullptr)
+        {
+            uint64_t qwUserData = pCqe->user_data;
+            int      iResult    = pCqe->res;
+            unsigned uFlags     = pCqe->flags;
+            Ring.SeenCQE();
+
+            URING_CONN* pConn = reinterpret_cast<URING_CONN*>(qwUserData & ~static_cast<uint64_t>(OP_MASK));
+
+            switch (qwUserData & OP_MASK)
+            {
+                case OP_WAKEUP:
+                    // woken up by Stop(), the terminate flag is rechecked by the loop
+                    if (m_bTerminate == false)
+                        ArmWakeup(pLoop);
+                    break;
+
+                case OP_ACCEPT:
+                    OnAccept(pLoop, iResult, uFlags);
+                    break;
+
+                case OP_ACCEPT_RETRY:
+                    ArmAccept(pLoop);
+                    break;
+
+                case OP_RECV:
+                    OnRecv(pLoop, pConn, iResult, uFlags);
+                    break;
+
+                case OP_SEND:
+                    OnSend(pLoop, pConn, iResult);
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
+        // responses generated while processing this pass go out as one chain
+        // per connection, one that finds no room in the submission queue
+        // staying dirty until the next pass
+        size_t nDeferred = 0;
+        for (size_t i = 0; i < pLoop->m_vecDirty.size(); i++)
+        {
+            URING_CONN* pConn = pLoop->m_vecDirty[i];
+
+            if (pConn->m_bClosing == false && pConn->m_nSends == 0 &&
+                SubmitSends(pLoop, pConn) == false)
+            {
+                pLoop->m_vecDirty[nDeferred++] = pConn;
+                continue;
+            }
+
+            pConn->m_bDirty = false;
+            if (pConn->m_bClosing)
+                EndClose(pLoop, pConn);
+        }
+        pLoop->m_vecDirty.resize(nDeferred);
+    }
+
+    std::cout << "Exiting ThreadID:" << GetThreadID() << std::endl;
+};
+
+void CNP_UringReactor::ArmWakeup(RING_LOOP* pLoop) noexcept
+{
+    io_uring_sqe* pSqe = pLoop->m_Ring.GetSQE();
+    if (pSqe == nullptr)
+        return;
+
+    pSqe->opcode    = IORING_OP_READ;
+    pSqe->fd        = pLoop->m_hWakeup;
+    pSqe->addr      = reinterpret_cast<uint64_t>(&pLoop->m_qwWakeup);
+    pSqe->len       = sizeof(pLoop->m_qwWakeup);
+    pSqe->user_data = MakeUserData(nullptr, OP_WAKEUP);
+};
+
+void CNP_UringReactor::ArmAccept(RING_LOOP* pLoop) noexcept
+{
+    io_uring_sqe* pSqe = pLoop->m_Ring.GetSQE();
+    if (pSqe == nullptr)
+        return;
+
+    pSqe->opcode       = IORING_OP_ACCEPT;
+    pSqe->fd           = pLoop->m_pListener->get_Handle();
+    pSqe->ioprio       = IORING_ACCEPT_MULTISHOT;
+    pSqe->accept_flags = SOCK_CLOEXEC;
+    pSqe->user_data    = MakeUserData(nullptr, OP_ACCEPT);
+};
+
+void CNP_UringReactor::ArmRecv(RING_LOOP* pLoop, URING_CONN* pConn) noexcept
+{
+    io_uring_sqe* pSqe = pLoop->m_Ring.GetSQE();
+    if (pSqe == nullptr)
+    {
+        BeginClose(pLoop, pConn);
+        return;
+    }
+
+    pSqe->opcode    = IORING_OP_RECV;
+    pSqe->fd        = pConn->m_Conn.get_Socket().get_Handle();
+    pSqe->ioprio    = IORING_RECV_MULTISHOT;
+    pSqe->flags     = IOSQE_BUFFER_SELECT;
+    pSqe->buf_group = pLoop->m_Ring.get_BufferGroup();
+    pSqe->user_data = MakeUserData(pConn, OP_RECV);
+
+    pConn->m_bRecvArmed = true;
+};
+
+/**
+    Queues the connection's batched output as a chain of linked sends
+
+    @retval true  if the chain, if any, has been queued
+    @retval false if the submission queue has no room for it, even once
+                  submitted, the caller retrying on a later pass
+ */
+bool CNP_UringReactor::SubmitSends(RING_LOOP* pLoop, URING_CONN* pConn)
+{
+    IO_BUFFER rgBuffers[MAX_LINKED_SENDS];
+    size_t    nCount = pConn->m_Conn.get_OutputBuffers(rgBuffers, MAX_LINKED_SENDS);
+
+    if (nCount == 0)
+        return true;
+
+    // a chain must not straddle two submissions; the submission may fail,
+    // as with EBUSY while completions overflow, leaving the queue full
+    if (pLoop->m_Ring.get_SqSpace() < nCount &&
+        (pLoop->m_Ring.Submit() == -1 || pLoop->m_Ring.get_SqSpace() < nCount))
+    {
+        return false;
+    }
+
+    size_t        nQueued = 0;
+    io_uring_sqe* pPrev   = nullptr;
+
+    for (size_t i = 0; i < nCount; i++)
+    {
+        io_uring_sqe* pSqe = pLoop->m_Ring.GetSQE();
+
+        // only the links queued are counted, the rest of the output is
+        // queued once they complete
+        if (pSqe == nullptr)
+            break;
+
+        // linked only once the next link is queued, so that a chain cut
+        // short never links to an unrelated entry
+        if (pPrev)
+            pPrev->flags = IOSQE_IO_LINK;
+
+        pSqe->opcode    = IORING_OP_SEND;
+        pSqe->fd        = pConn->m_Conn.get_Socket().get_Handle();
+        pSqe->addr      = reinterpret_cast<uint64_t>(rgBuffers[i].iov_base);
+        pSqe->len       = static_cast<uint32_t>(rgBuffers[i].iov_len);
+        // MSG_WAITALL has short sends retried, so the next link never overtakes one
+        pSqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+        pSqe->user_data = MakeUserData(pConn, OP_SEND);
+
+        pPrev = pSqe;
+        nQueued++;
+    }
+
+    pConn->m_nSends = nQueued;
+    return nQueued > 0;
+};
+
+void CNP_UringReactor::OnAccept(RING_LOOP* pLoop, int iResult, unsigned uFlags)
+{
+    if (iResult >= 0)
+    {
+        CNP_LOG_INFO("Accepting a new connection");
+
+        sockaddr_in remoteAddr;
+        socklen_t   cbAddr = sizeof(remoteAddr);
+        if (::getpeername(iResult, reinterpret_cast<sockaddr*>(&remoteAddr), &cbAddr) == -1)
+            memset(&remoteAddr, 0, sizeof(remoteAddr));
+
+        URING_CONN* pConn = nullptr;
+        if (!pLoop->m_vecFree.empty())
+        {
+            pConn = pLoop->m_vecFree.back();
+            pLoop->m_vecFree.pop_back();
+        }
+        else
+        {
+            pConn = new URING_CONN();
+        }
+
+        pConn->m_Conn.Open(iResult, remoteAddr, pLoop->m_nIndex, nullptr);
+        pConn->m_nSends      = 0;
+        pConn->m_bRecvArmed  = false;
+        pConn->m_bRecvPaused = false;
+        pConn->m_bClosing   = false;
+        pConn->m_bDirty     = false;
+
+        pLoop->m_setConns.insert(pConn);
+        ArmRecv(pLoop, pConn);
+    }
+    else if (iResult != -ECANCELED)
+    {
+        std::cerr << "failed to accept new connection, Error:" << -iResult << std::endl;
+    }
+
+    if ((uFlags & IORING_CQE_F_MORE) || m_bTerminate)
+        return;
+
+    if (iResult >= 0 || iResult == -ECONNABORTED || iResult == -EINTR)
+    {
+        ArmAccept(pLoop);
+        return;
+    }
+
+    // typically out of descriptors, back off rather than spin
+    io_uring_sqe* pSqe = pLoop->m_Ring.GetSQE();
+    if (pSqe)
+    {
+        pSqe->opcode    = IORING_OP_TIMEOUT;
+        pSqe->addr      = reinterpret_cast<uint64_t>(&pLoop->m_tsRetry);
+        pSqe->len       = 1;
+        pSqe->user_data = MakeUserData(nullptr, OP_ACCEPT_RETRY);
+    }
+};
+
+void CNP_UringReactor::OnRecv(RING_LOOP* pLoop, URING_CONN* pConn, int iResult, unsigned uFlags)
+{
+    if (uFlags & IORING_CQE_F_BUFFER)
+    {
+        unsigned short wBufferID = static_cast<unsigned short>(uFlags >> IORING_CQE_BUFFER_SHIFT);
+
+        if (iResult > 0 && pConn->m_bClosing == false)
+        {
+            pConn->m_Conn.OnReceived(pLoop->m_Ring.get_Buffer(wBufferID), iResult);
+
+            if (pConn->m_bDirty == false)
+            {
+                pConn->m_bDirty = true;
+                pLoop->m_vecDirty.push_back(pConn);
+            }
+
+            // backed up output, stop receiving until OnSend() has drained it
+            if (pConn->m_bRecvPaused == false && (uFlags & IORING_CQE_F_MORE) &&
+                pConn->m_Conn.PauseReading())
+            {
+                pConn->m_bRecvPaused = true;
+                CancelRecv(pLoop, pConn);
+            }
+        }
+
+        pLoop->m_Ring.RecycleBuffer(wBufferID);
+    }
+
+    if (uFlags & IORING_CQE_F_MORE)
+        return;
+
+    pConn->m_bRecvArmed = false;
+
+    // the multishot receive has ended, it is re-armed unless the client has
+    // disconnected, the connection failed or reading has been paused.
+    // Running out of provided buffers is transient since this pass
+    // recycles them, cancellation is only ever requested to pause.
+    if (pConn->m_bClosing == false && (iResult > 0 || iResult == -ENOBUFS || iResult == -ECANCELED))
+    {
+        if (pConn->m_bRecvPaused == false && pConn->m_Conn.PauseReading())
+            pConn->m_bRecvPaused = true;
+
+        if (pConn->m_bRecvPaused == false)
+            ArmRecv(pLoop, pConn);
+    }
+    else
+    {
+        BeginClose(pLoop, pConn);
+    }
+};
+
+void CNP_UringReactor::OnSend(RING_LOOP* pLoop, URING_CONN* pConn, int iResult)
+{
+    pConn->m_nSends--;
+
+    if (iResult > 0)
+    {
+        // the output has drained, resume receiving.  A receive still being
+        // cancelled is re-armed by OnRecv() once it has ended.
+        if (pConn->m_Conn.ConsumeOutput(static_cast<size_t>(iResult)) && pConn->m_bRecvPaused &&
+            pConn->m_bClosing == false)
+        {
+            // the messages left buffered at the output limit come first, &
+            // may fill it again
+            pConn->m_Conn.DispatchPending();
+
+            if (pConn->m_Conn.PauseReading() == false)
+            {
+                pConn->m_bRecvPaused = false;
+                if (pConn->m_bRecvArmed == false)
+                    ArmRecv(pLoop, pConn);
+            }
+        }
+    }
+    else if (iResult < 0 && iResult != -ECANCELED)
+    {
+        BeginClose(pLoop, pConn);
+    }
+
+    if (pConn->m_nSends > 0)
+        return;
+
+    if (pConn->m_bClosing)
+    {
+        EndClose(pLoop, pConn);
+    }
+    else if (pConn->m_bDirty == false)
+    {
+        // more responses may have been batched while the chain was in flight
+        pConn->m_bDirty = true;
+        pLoop->m_vecDirty.push_back(pConn);
+    }
+};
+
+void CNP_UringReactor::CancelRecv(RING_LOOP* pLoop, URING_CONN* pConn) noexcept
+{
+    io_uring_sqe* pSqe = pLoop->m_Ring.GetSQE();
+    if (pSqe == nullptr)
+        return;
+
+    pSqe->opcode    = IORING_OP_ASYNC_CANCEL;
+    pSqe->addr      = MakeUserData(pConn, OP_RECV);
+    pSqe->user_data = MakeUserData(nullptr, OP_CANCEL);
+};
+
+void CNP_UringReactor::BeginClose(RING_LOOP* pLoop, URING_CONN* pConn) noexcept
+{
+    if (pConn->m_bClosing == false)
+    {
+        pConn->m_bClosing = true;
+
+        // fails the outstanding requests, which then complete
+        pConn->m_Conn.get_Socket().Shutdown(SHUT_RDWR);
+
+        if (pConn->m_bRecvArmed)
+            CancelRecv(pLoop, pConn);
+    }
+
+    EndClose(pLoop, pConn);
+};
+
+void CNP_UringReactor::EndClose(RING_LOOP* pLoop, URING_CONN* pConn) noexcept
+{
+    // the context is only reused once the kernel is done with it
+    if (pConn->m_bRecvArmed || pConn->m_nSends > 0 || pConn->m_bDirty)
+        return;
+
+    pLoop->m_setConns.erase(pConn);
+    pConn->m_Conn.OnClose();
+
+    if (pLoop->m_vecFree.size() < MAX_FREE_CONNECTIONS)
+        pLoop->m_vecFree.push_back(pConn);
+    else
+        delete pConn;
+};
+
+#endif  // __linux__
@@ -0,0 +1,116 @@
+/**
+ * @file   CNP_UringReactor.h
+ * @brief  CNP_UringReactor class interface
+ *
+ * CNP_UringReactor is the io_uring transport, an alternative to the
+ * epoll based CNP_Acceptor & CNP_Reactor pair that is selected at
+ * startup.  Each event loop owns an io_uring instance on which it
+ * keeps a multishot accept armed on the listening socket, a multishot
+ * receive armed on every connection, drawing from a pool of provided
+ * buffers, & submits each connection's batched responses as a chain
+ * of linked sends.  A connection whose unsent output has backed up has
+ * its receive cancelled until the sends have drained it.  Requests are
+ * processed on the event loop itself, so a request/response pair costs
+ * no system calls of its own beyond the loop's single io_uring_enter.
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#if !defined(__CNP_URING_REACTOR_H__)
+#define __CNP_URING_REACTOR_H__
+
+#ifdef __linux__
+
+#ifndef __CNP_SOCKET_H__
+    #include "CNP_Socket.h"
+#endif
+
+#ifndef _ATOMIC_
+    #include <atomic>
+#endif
+
+#ifndef _VECTOR_
+    #include <vector>
+#endif
+
+class CNP_UringReactor
+{
+    struct URING_CONN;  ///< defined in the implementation
+    struct RING_LOOP;   ///< defined in the implementation
+
+    std::vector<CNP_Socket*>  m_vecSockets;
+    std::vector<RING_LOOP*>   m_vecLoops;
+    std::atomic<bool>         m_bTerminate;
+
+public:
+/**
+    @brief Initialization Constructor
+
+    @param [in] nEventLoops   number of event loop threads to run, if 0
+                              then one per available hardware thread
+*/
+    explicit CNP_UringReactor(size_t nEventLoops = 0);
+
+    ~CNP_UringReactor();
+
+/**
+    @brief Determines whether the running kernel supports every io_uring
+           feature the transport relies on
+
+    Multishot receive into provided buffers is exercised on a socket pair,
+    since its absence is only reported when a request is completed.  This
+    also settles how the buffers are provided, so it must be called before
+    Start().
+
+    @retval true  if the io_uring transport can be used
+    @retval false if the server should fall back to epoll
+ */
+    static bool IsSupported(void) noexcept;
+
+/**
+    @brief Creates the listening socket(s), the io_uring instances & starts
+           the event loop threads
+
+    @param [in] wPort        port to listen on
+    @param [in] iBackLog     length of each socket's pending connection queue
+    @param [in] bReusePort   give each event loop its own SO_REUSEPORT socket,
+                             otherwise they all accept on a single socket
+
+    @retval true  on success
+    @retval false on failure
+ */
+    bool   Start(unsigned short wPort, int iBackLog, bool bReusePort);
+
+/**
+    @brief Stops the event loop threads & closes every socket
+ */
+    void   Stop (void) noexcept;
+
+    inline size_t get_EventLoopCount(void) const noexcept
+    { return m_vecLoops.size(); };
+
+private:
+    void   Run        (RING_LOOP* pLoop);
+
+    void   ArmWakeup  (RING_LOOP* pLoop) noexcept;
+    void   ArmAccept  (RING_LOOP* pLoop) noexcept;
+    void   ArmRecv    (RING_LOOP* pLoop, URING_CONN* pConn) noexcept;
+    bool   SubmitSends(RING_LOOP* pLoop, URING_CONN* pConn);
+
+    void   OnAccept   (RING_LOOP* pLoop, int iResult, unsigned uFlags);
+    void   OnRecv     (RING_LOOP* pLoop, URING_CONN* pConn, int iResult, unsigned uFlags);
+    void   OnSend     (RING_LOOP* pLoop, URING_CONN* pConn, int iResult);
+
+    void   CancelRecv (RING_LOOP* pLoop, URING_CONN* pConn) noexcept;
+    void   BeginClose (RING_LOOP* pLoop, URING_CONN* pConn) noexcept;
+    void   EndClose   (RING_LOOP* pLoop, URING_CONN* pConn) noexcept;
+
+    CNP_UringReactor(const CNP_UringReactor&);
+    CNP_UringReactor& operator=(const CNP_UringReactor&);
+};
+
+#endif  // __linux__
+
+#endif
@@ -0,0 +1,75 @@
+/**
+ * @file   CNP_WorkerPool.cpp
+ * @brief  CNP_WorkerPool class implementation
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#include <iostream>
+
+#include "CNP_Server.h"
+#include "CNP_WorkerPool.h"
+
+/// each connection is queued at most once at a time, so this bounds the
+/// number of ready connections before the event loops are held up
+static const size_t WORK_QUEUE_CAPACITY = 65536;
+
+CNP_WorkerPool::CNP_WorkerPool(const handler_type& fnHandler)
+    : m_fnHandler(fnHandler),
+      m_vecThreads(),
+      m_queWork(WORK_QUEUE_CAPACITY)
+{ };
+
+CNP_WorkerPool::~CNP_WorkerPool()
+{
+    Stop();
+};
+
+void CNP_WorkerPool::Start(size_t nWorkers)
+{
+    if (nWorkers == 0)
+        nWorkers = std::thread::hardware_concurrency();
+    if (nWorkers == 0)
+        nWorkers = 1;
+
+    m_queWork.Open();
+
+    for (size_t i = 0; i < nWorkers; i++)
+        m_vecThreads.push_back(new std::thread(&CNP_WorkerPool::Run, this));
+};
+
+void CNP_WorkerPool::Stop(void) noexcept
+{
+    m_queWork.Close();
+
+    for (auto& it : m_vecThreads)
+    {
+        it->join();
+        delete it;
+    }
+    m_vecThreads.clear();
+
+    CNP_Connection* pConn;
+    while (m_queWork.TryPop(pConn))
+        ;
+};
+
+void CNP_WorkerPool::Submit(CNP_Connection* pConn)
+{
+    m_queWork.Push(pConn);
+};
+
+void CNP_WorkerPool::Run(void)
+{
+    std::cout << "Worker ThreadID:" << GetThreadID() << std::endl;
+
+    CNP_Connection* pConn = nullptr;
+
+    // fails once the pool has been stopped
+    while (m_queWork.Pop(pConn))
+        m_fnHandler(pConn);
+
+    std::cout << "Exiting ThreadID:" << GetThreadID() << std::endl;
+};
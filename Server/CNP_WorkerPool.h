@@ -0,0 +1,91 @@
+/**
+ * @file   CNP_WorkerPool.h
+ * @brief  CNP_WorkerPool class interface
+ *
+ * CNP_WorkerPool is a fixed-size pool of threads fed through a work
+ * queue of connections that are ready to be serviced.  The reactor's
+ * event loops only detect readiness, the request processing itself
+ * happens on the workers.  The work queue is a bounded lock-free
+ * TMPMCQueue, idle workers block on it without holding a lock.
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#if !defined(__CNP_WORKER_POOL_H__)
+#define __CNP_WORKER_POOL_H__
+
+#ifndef __RING_QUEUE_H__
+    #include "RingQueue.h"
+#endif
+
+#ifndef _FUNCTIONAL_
+    #include <functional>
+#endif
+
+#ifndef _THREAD_
+    #include <thread>
+#endif
+
+#ifndef _VECTOR_
+    #include <vector>
+#endif
+
+class CNP_Connection;
+
+class CNP_WorkerPool
+{
+public:
+    typedef std::function<void (CNP_Connection*)>  handler_type;
+
+private:
+    handler_type                     m_fnHandler;
+    std::vector<std::thread*>        m_vecThreads;
+    TMPMCQueue<CNP_Connection*>      m_queWork;
+
+public:
+/**
+    @brief Initialization Constructor
+
+    @param [in] fnHandler   invoked on a worker thread for each queued connection
+*/
+    explicit CNP_WorkerPool(const handler_type& fnHandler);
+
+    ~CNP_WorkerPool();
+
+/**
+    @brief Starts the worker threads
+
+    @param [in] nWorkers   number of worker threads, if 0 then one per
+                           available hardware thread
+ */
+    void   Start (size_t nWorkers);
+
+/**
+    @brief Stops the worker threads
+
+    Connections still waiting in the queue are discarded, those being
+    serviced are finished first.
+ */
+    void   Stop  (void) noexcept;
+
+/**
+    @brief Queues a ready connection for servicing by the next idle worker
+
+    Blocks while the work queue is full, which only happens once more
+    connections are ready than the queue holds.
+ */
+    void   Submit(CNP_Connection* pConn);
+
+    inline size_t get_WorkerCount(void) const noexcept
+    { return m_vecThreads.size(); };
+
+private:
+    void   Run   (void);
+
+    CNP_WorkerPool(const CNP_WorkerPool&);
+    CNP_WorkerPool& operator=(const CNP_WorkerPool&);
+};
+
+#endif
@@ -0,0 +1,516 @@
+/**
+ * @file   CNP_WriteAheadLog.cpp
+ * @brief  CNP_WriteAheadLog class implementation
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#ifdef __linux__
+    #include <unistd.h>
+#elif _MSC_VER
+    #include <io.h>
+#endif
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#include "CNP_WriteAheadLog.h"
+
+/// no record is anywhere near this long, a larger length marks a corrupt tail
+static const size_t MAX_RECORD_SIZE = 64 * 1024;
+
+/// m_cbValid before Replay() has been called, the file is then appended to as is
+static const size_t UNKNOWN_LENGTH  = static_cast<size_t>(~0);
+
+/**
+    32bit FNV-1a hash of a record's payload, a byte at a time so that it
+    never reads past the end of the payload
+
+    @retval cnp::DWORD containing the checksum
+ */
+static cnp::DWORD RecordChecksum(const void* pData, size_t cbLen) noexcept
+{
+    const unsigned char* pByte  = static_cast<const unsigned char*>(pData);
+    cnp::DWORD           dwHash = 2166136261U;
+
+    for (size_t i = 0; i < cbLen; i++)
+        dwHash = (dwHash ^ pByte[i]) * 16777619U;
+
+    return dwHash;
+};
+
+/**
+    @retval std::string containing the name of a log file's rotated segment
+ */
+static std::string RotatedFileName(const std::string& strFileName)
+{
+    return strFileName + ".old";
+};
+
+/**
+    Reads back every intact record of a single log file
+
+    @param [in]  szFileName   log file to read, a missing file holds no records
+    @param [in]  fnReplay     invoked for each record, in the order appended
+    @param [out] cbValid      receives the length of the file's intact prefix
+
+    @retval size_t containing the number of records replayed
+ */
+static size_t ReplayFile(const char* szFileName, const CNP_WriteAheadLog::replay_type& fnReplay,
+                         size_t& cbValid)
+{
+    size_t            nResult = 0;
+    std::vector<char> vecPayload;
+
+    cbValid = 0;
+
+    std::ifstream ifs(szFileName, std::ios_base::binary);
+
+    while (ifs)
+    {
+        WAL_RECORD_HDR Hdr;
+        if (!ifs.read(reinterpret_cast<char*>( &Hdr ), sizeof(Hdr)))
+            break;
+
+        if (Hdr.m_cbLen > MAX_RECORD_SIZE)
+            break;
+
+        vecPayload.resize(Hdr.m_cbLen);
+        if (!ifs.read(vecPayload.data(), Hdr.m_cbLen))
+            break;
+
+        // a record torn by a crash part way through its write
+        if (RecordChecksum(vecPayload.data(), Hdr.m_cbLen) != Hdr.m_dwChecksum)
+            break;
+
+        fnReplay(Hdr.m_dwType, vecPayload.data(), Hdr.m_cbLen);
+
+        cbValid += sizeof(Hdr) + Hdr.m_cbLen;
+        nResult++;
+    }
+
+    ifs.close();
+    return nResult;
+};
+
+CNP_WriteAheadLog::CNP_WriteAheadLog(void) noexcept
+    : m_strFileName(),
+      m_hFile(-1),
+      m_eMode(SM_OFF),
+      m_ulGroupDelay(0),
+      m_cbValid(UNKNOWN_LENGTH),
+      m_pThread(nullptr),
+      m_Mutex(),
+      m_cvPending(),
+      m_cvDurable(),
+      m_vecPending(),
+      m_vecRotated(),
+      m_qwAppended(0),
+      m_qwDurable(0),
+      m_qwRotated(0),
+      m_bRotate(false),
+      m_bFailed(false),
+      m_bTerminate(false)
+{ };
+
+CNP_WriteAheadLog::~CNP_WriteAheadLog()
+{
+    Close();
+};
+
+size_t CNP_WriteAheadLog::Replay(const char* szFileName, const replay_type& fnReplay)
+{
+    size_t          nResult     = 0;
+    size_t          cbValid     = 0;
+    std::string     strRotated  = RotatedFileName(szFileName);
+    std::error_code ec;
+
+    // the rotated segment holds the older records
+    nResult += ReplayFile(strRotated.c_str(), fnReplay, cbValid);
+
+    // a later rotation appends to the segment, which must not follow a torn record
+    auto cbSize = std::filesystem::file_size(strRotated, ec);
+    if (!ec && cbSize != cbValid)
+        std::filesystem::resize_file(strRotated, cbValid, ec);
+
+    nResult += ReplayFile(szFileName, fnReplay, m_cbValid);
+
+    return nResult;
+};
+
+bool CNP_WriteAheadLog::Open(const char* szFileName, SYNC_MODE eMode, unsigned long ulGroupDelay)
+{
+    m_eMode        = eMode;
+    m_ulGroupDelay = ulGroupDelay;
+    m_strFileName  = szFileName;
+
+    if (eMode == SM_OFF)
+        return true;
+
+    if (OpenFile(m_strFileName) == false)
+        return false;
+
+    // appending after a torn record would leave every later one unreadable
+    if (m_cbValid != UNKNOWN_LENGTH)
+    {
+#ifdef __linux__
+        int iResult = ::ftruncate(m_hFile, static_cast<off_t>(m_cbValid));
+#elif _MSC_VER
+        int iResult = ::_chsize_s(m_hFile, static_cast<__int64>(m_cbValid));
+#endif
+        if (iResult != 0)
+            std::cerr << "failed to discard torn log records, Error:" << errno << std::endl;
+    }
+
+    m_qwAppended = 0;
+    m_qwDurable  = 0;
+    m_bRotate    = false;
+    m_bFailed    = false;
+    m_bTerminate = false;
+    m_pThread    = new std::thread(&CNP_WriteAheadLog::Run, this);
+
+    return true;
+};
+
+void CNP_WriteAheadLog::Close(void) noexcept
+{
+    if (m_pThread)
+    {
+        {
+            std::lock_guard<std::mutex> LogLock(m_Mutex);
+            m_bTerminate = true;
+        }
+        m_cvPending.notify_one();
+
+        // the log thread commits whatever is still pending before exiting
+        m_pThread->join();
+        delete m_pThread;
+        m_pThread = nullptr;
+    }
+
+    CloseFile();
+};
+
+bool CNP_WriteAheadLog::Truncate(void)
+{
+    if (m_eMode == SM_OFF || m_strFileName.empty())
+        return true;
+
+#ifdef __linux__
+    bool bResult = (::truncate(m_strFileName.c_str(), 0) == 0) || (errno == ENOENT);
+#elif _MSC_VER
+    int  hFile   = ::_open(m_strFileName.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+    bool bResult = (hFile != -1);
+    if (bResult)
+        ::_close(hFile);
+#endif
+
+    if (bResult == false)
+        std::cerr << "failed to truncate log file:" << m_strFileName << ", Error:" << errno << std::endl;
+
+    std::error_code ec;
+    std::filesystem::remove(RotatedFileName(m_strFileName), ec);
+
+    m_cbValid = 0;
+    return bResult;
+};
+
+cnp::QWORD CNP_WriteAheadLog::Append(cnp::DWORD dwType, const void* pData, size_t cbLen)
+{
+    if (m_pThread == nullptr)
+        return 0;
+
+    WAL_RECORD_HDR Hdr;
+    Hdr.m_dwType     = dwType;
+    Hdr.m_cbLen      = static_cast<cnp::DWORD>(cbLen);
+    Hdr.m_dwChecksum = RecordChecksum(pData, cbLen);
+
+    cnp::QWORD qwSequence = 0;
+    bool       bNotify    = false;
+    {
+        std::lock_guard<std::mutex> LogLock(m_Mutex);
+
+        bool bWasEmpty = m_vecPending.empty();
+
+        const char* pHdr = reinterpret_cast<const char*>( &Hdr );
+        m_vecPending.insert(m_vecPending.end(), pHdr, pHdr + sizeof(Hdr));
+        m_vecPending.insert(m_vecPending.end(), static_cast<const char*>(pData),
+                            static_cast<const char*>(pData) + cbLen);
+
+        qwSequence = ++m_qwAppended;
+
+        // the log thread is only waiting for the first record of a group,
+        // or for a batched group to fill up
+        bNotify = bWasEmpty || (m_vecPending.size() >= MAX_GROUP_SIZE);
+    }
+
+    if (bNotify)
+        m_cvPending.notify_one();
+
+    return qwSequence;
+};
+
+bool CNP_WriteAheadLog::WaitDurable(cnp::QWORD qwSequence)
+{
+    if (m_eMode != SM_SYNC || qwSequence == 0)
+        return true;
+
+    std::unique_lock<std::mutex> LogLock(m_Mutex);
+    m_cvDurable.wait(LogLock, [this, qwSequence]() { return m_qwDurable >= qwSequence || m_bFailed; });
+
+    return m_qwDurable >= qwSequence;
+};
+
+void CNP_WriteAheadLog::Rotate(void)
+{
+    if (m_pThread == nullptr)
+        return;
+
+    {
+        std::unique_lock<std::mutex> LogLock(m_Mutex);
+
+        // the log thread is still busy with an earlier rotation
+        m_cvDurable.wait(LogLock, [this]() { return m_bRotate == false; });
+
+        m_vecRotated.swap(m_vecPending);
+        m_qwRotated = m_qwAppended;
+        m_bRotate   = true;
+    }
+
+    m_cvPending.notify_one();
+};
+
+void CNP_WriteAheadLog::DiscardRotated(void)
+{
+    if (m_strFileName.empty())
+        return;
+
+    {
+        std::unique_lock<std::mutex> LogLock(m_Mutex);
+        m_cvDurable.wait(LogLock, [this]() { return m_bRotate == false; });
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(RotatedFileName(m_strFileName), ec);
+    if (ec)
+        std::cerr << "failed to remove rotated log file, Error:" << ec.value() << std::endl;
+};
+
+bool CNP_WriteAheadLog::OpenFile(const std::string& strFileName)
+{
+#ifdef __linux__
+    m_hFile = ::open(strFileName.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+#elif _MSC_VER
+    m_hFile = ::_open(strFileName.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, _S_IREAD | _S_IWRITE);
+#endif
+
+    if (m_hFile == -1)
+    {
+        std::cerr << "failed to open log file:" << strFileName << ", Error:" << errno << std::endl;
+        return false;
+    }
+
+    return true;
+};
+
+void CNP_WriteAheadLog::CloseFile(void) noexcept
+{
+    if (m_hFile != -1)
+    {
+#ifdef __linux__
+        // SM_ASYNC never synced the file while it was open
+        if (m_eMode == SM_ASYNC)
+            ::fdatasync(m_hFile);
+        ::close(m_hFile);
+#elif _MSC_VER
+        if (m_eMode == SM_ASYNC)
+            ::_commit(m_hFile);
+        ::_close(m_hFile);
+#endif
+        m_hFile = -1;
+    }
+};
+
+/**
+    Moves the log file, followed by the rotated records, into the rotated
+    segment & reopens an empty log file.  Only called by the log thread.
+
+    @retval true  if the rotated records have been committed, to the
+                  rotated segment or, should the rotation fail, the log file
+ */
+bool CNP_WriteAheadLog::SwitchFile(std::vector<char>& vecRotated)
+{
+    std::string     strRotated = RotatedFileName(m_strFileName);
+    std::error_code ec;
+    bool            bResult    = true;
+
+    CloseFile();
+
+    bool bExtend = std::filesystem::exists(strRotated, ec);
+    if (bExtend)
+    {
+        // an earlier checkpoint failed & its segment is still needed, so the
+        // log file's records are copied to the end of it
+        std::ifstream     ifs(m_strFileName, std::ios_base::binary);
+        std::vector<char> vecFile((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+
+        vecRotated.insert(vecRotated.begin(), vecFile.begin(), vecFile.end());
+    }
+    else
+    {
+        std::filesystem::rename(m_strFileName, strRotated, ec);
+        if (ec)
+        {
+            std::cerr << "failed to rotate log file, Error:" << ec.value() << std::endl;
+            bResult = false;
+        }
+    }
+
+    if (bResult && OpenFile(strRotated))
+    {
+        bResult = vecRotated.empty() || Write(vecRotated);
+        CloseFile();
+
+        // the records are now in both files until the log file is removed,
+        // which replay tolerates
+        if (bResult && bExtend)
+            std::filesystem::remove(m_strFileName, ec);
+    }
+    else
+    {
+        bResult = false;
+    }
+
+    bool bCommitted = bResult;
+
+    // should the rotation fail, the records are appended to the log file instead
+    if (OpenFile(m_strFileName) && bResult == false)
+    {
+        std::cerr << "failed to rotate log file:" << m_strFileName << std::endl;
+        bCommitted = vecRotated.empty() || Write(vecRotated);
+    }
+
+    return bCommitted;
+};
+
+bool CNP_WriteAheadLog::Write(const std::vector<char>& vecData) noexcept
+{
+    const char* pData  = vecData.data();
+    size_t      cbLeft = vecData.size();
+
+    while (cbLeft > 0)
+    {
+#ifdef __linux__
+        ssize_t cbWritten = ::write(m_hFile, pData, cbLeft);
+#elif _MSC_VER
+        int     cbWritten = ::_write(m_hFile, pData, static_cast<unsigned>(cbLeft));
+#endif
+        if (cbWritten < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+
+        pData  += cbWritten;
+        cbLeft -= cbWritten;
+    }
+
+    if (m_eMode == SM_ASYNC)
+        return true;
+
+#ifdef __linux__
+    return ::fdatasync(m_hFile) == 0;
+#elif _MSC_VER
+    return ::_commit(m_hFile) == 0;
+#endif
+};
+
+void CNP_WriteAheadLog::Run(void)
+{
+    std::vector<char> vecGroup;
+
+    std::unique_lock<std::mutex> LogLock(m_Mutex);
+
+    for (;;)
+    {
+        m_cvPending.wait(LogLock, [this]() { return m_bTerminate || m_bRotate || !m_vecPending.empty(); });
+
+        // a rotation goes ahead of the records appended after it
+        if (m_bRotate)
+        {
+            vecGroup.swap(m_vecRotated);
+            cnp::QWORD qwGroupEnd = m_qwRotated;
+
+            bool       bFailed    = m_bFailed;
+
+            LogLock.unlock();
+
+            // once failed, nothing more is written
+            bool bCommitted = (bFailed == false) && SwitchFile(vecGroup);
+
+            vecGroup.clear();
+
+            LogLock.lock();
+
+            m_bRotate = false;
+            Commit(bCommitted, qwGroupEnd);
+            continue;
+        }
+
+        if (m_vecPending.empty())
+            break;
+
+        // in SM_SYNC the group is whatever was appended while the last
+        // commit was in progress, in SM_BATCH it is also given time to grow
+        if (m_eMode == SM_BATCH && m_bTerminate == false)
+        {
+            m_cvPending.wait_for(LogLock, std::chrono::microseconds(m_ulGroupDelay),
+                                 [this]() { return m_bTerminate || m_bRotate || m_vecPending.size() >= MAX_GROUP_SIZE; });
+
+            if (m_bRotate)
+                continue;
+        }
+
+        vecGroup.swap(m_vecPending);
+        cnp::QWORD qwGroupEnd = m_qwAppended;
+        bool       bFailed    = m_bFailed;
+
+        LogLock.unlock();
+
+        bool bCommitted = (bFailed == false) && Write(vecGroup);
+
+        vecGroup.clear();
+
+        LogLock.lock();
+
+        Commit(bCommitted, qwGroupEnd);
+    }
+};
+
+void CNP_WriteAheadLog::Commit(bool bCommitted, cnp::QWORD qwGroupEnd) noexcept
+{
+    if (bCommitted)
+    {
+        m_qwDurable = qwGroupEnd;
+    }
+    else if (m_bFailed == false)
+    {
+        // a torn or unsynced group cannot safely be written again, nor
+        // can any later record be read back after it
+        std::cerr << "failed to commit log records, Error:" << errno
+                  << ", no further records are logged" << std::endl;
+        m_bFailed = true;
+    }
+
+    m_cvDurable.notify_all();
+};
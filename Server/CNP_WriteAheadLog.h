@@ -0,0 +1,217 @@
+/**
+ * @file   CNP_WriteAheadLog.h
+ * @brief  CNP_WriteAheadLog class interface
+ *
+ * CNP_WriteAheadLog is an append-only log of the records changed since
+ * the server database was last saved, replayed on start-up so that
+ * accounts & transactions survive a crash.  Request handlers only copy
+ * their records into an in-memory buffer, a dedicated log thread writes
+ * the buffer out & syncs it, so a single fdatasync() commits every
+ * record appended in the meantime (group commit).
+ *
+ * The sync mode chooses how durable a record is when its request is
+ * answered:
+ *
+ *   SM_SYNC   the handler waits for the group commit holding its record
+ *   SM_BATCH  the log is synced at most every group delay, a crash may
+ *             lose the records of the last window
+ *   SM_ASYNC  the log is written but never synced, only an operating
+ *             system crash loses records
+ *   SM_OFF    nothing is logged
+ *
+ * Each record is a WAL_RECORD_HDR followed by its payload, a torn or
+ * corrupt tail is discarded on replay.
+ *
+ * Should a group fail to be written or synced, the log fails: no record
+ * from then on is reported as committed, nor written, & WaitDurable()
+ * returns false.
+ *
+ * A checkpoint calls Rotate() at the point its snapshot is taken, the
+ * records logged until then are moved into a rotated segment that is
+ * kept, & replayed, until DiscardRotated() is called once the snapshot
+ * has been saved.
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#if !defined(__CNP_WRITE_AHEAD_LOG_H__)
+#define __CNP_WRITE_AHEAD_LOG_H__
+
+#ifndef __CNP_COMMON_H__
+    #include "CNP_Common.h"
+#endif
+
+#ifndef _CONDITION_VARIABLE_
+    #include <condition_variable>
+#endif
+
+#ifndef _FUNCTIONAL_
+    #include <functional>
+#endif
+
+#ifndef _MUTEX_
+    #include <mutex>
+#endif
+
+#ifndef _STRING_
+    #include <string>
+#endif
+
+#ifndef _THREAD_
+    #include <thread>
+#endif
+
+#ifndef _VECTOR_
+    #include <vector>
+#endif
+
+/// header preceding each record's payload in the log file
+struct WAL_RECORD_HDR
+{
+    cnp::DWORD  m_dwType;       ///< caller defined record type
+    cnp::DWORD  m_cbLen;        ///< length of the payload in bytes
+    cnp::DWORD  m_dwChecksum;   ///< 32bit FNV-1a hash of the payload
+};
+
+class CNP_WriteAheadLog
+{
+public:
+    enum SYNC_MODE
+    {
+        SM_OFF   = 0,
+        SM_ASYNC = 1,
+        SM_BATCH = 2,
+        SM_SYNC  = 3
+    };
+
+    /// receives each replayed record's type, payload & payload length
+    typedef std::function<void (cnp::DWORD, const void*, size_t)>  replay_type;
+
+    /// pending bytes at which a batched group commit does not wait out its delay
+    static const size_t MAX_GROUP_SIZE = 1024 * 1024;
+
+private:
+    std::string              m_strFileName;
+    int                      m_hFile;
+    SYNC_MODE                m_eMode;
+    unsigned long            m_ulGroupDelay;   ///< microseconds a batched group commit collects records for
+    size_t                   m_cbValid;        ///< length of the intact prefix found by Replay()
+    std::thread*             m_pThread;
+    std::mutex               m_Mutex;
+    std::condition_variable  m_cvPending;
+    std::condition_variable  m_cvDurable;
+    std::vector<char>        m_vecPending;     ///< records yet to be written, guarded by m_Mutex
+    std::vector<char>        m_vecRotated;     ///< records yet to be written to the rotated segment
+    cnp::QWORD               m_qwAppended;     ///< sequence number of the last record appended
+    cnp::QWORD               m_qwDurable;      ///< sequence number of the last record committed
+    cnp::QWORD               m_qwRotated;      ///< sequence number of the last record of m_vecRotated
+    bool                     m_bRotate;        ///< a rotation is waiting for the log thread
+    bool                     m_bFailed;        ///< a group could not be committed, nor can any later one
+    bool                     m_bTerminate;
+
+public:
+    /// Default Constructor
+    CNP_WriteAheadLog(void) noexcept;
+
+    ~CNP_WriteAheadLog();
+
+/**
+    @brief Reads back every intact record of a log file, those of its
+           rotated segment first
+
+    Should be called before Open(), which then discards any torn tail.
+
+    @param [in] szFileName   log file to read, a missing file holds no records
+    @param [in] fnReplay     invoked for each record, in the order appended
+
+    @retval size_t containing the number of records replayed
+ */
+    size_t      Replay(const char* szFileName, const replay_type& fnReplay);
+
+/**
+    @brief Opens the log file for appending & starts the log thread
+
+    @param [in] szFileName     log file to append to, created if missing
+    @param [in] eMode          durability of appended records
+    @param [in] ulGroupDelay   microseconds a batched group commit collects records for
+
+    @retval true  on success, or if eMode is SM_OFF
+    @retval false on failure
+ */
+    bool        Open  (const char* szFileName, SYNC_MODE eMode, unsigned long ulGroupDelay);
+
+/**
+    @brief Commits every pending record, stops the log thread & closes the file
+ */
+    void        Close (void) noexcept;
+
+/**
+    @brief Discards every record, rotated or not, once they are all held
+           by a saved database
+
+    Only valid while the log is closed.
+
+    @retval true  on success
+    @retval false on failure
+ */
+    bool        Truncate(void);
+
+/**
+    @brief Appends a record
+
+    @param [in] dwType   caller defined record type
+    @param [in] pData    address of the record's payload
+    @param [in] cbLen    length of the payload in bytes
+
+    @retval cnp::QWORD containing the record's sequence number, to pass
+            to WaitDurable(), or 0 if the log is not open
+ */
+    cnp::QWORD  Append(cnp::DWORD dwType, const void* pData, size_t cbLen);
+
+/**
+    @brief Blocks until the record with the given sequence number has
+           been committed, only waits in SM_SYNC mode
+
+    @retval true  if the record has been committed, or need not be waited for
+    @retval false if the log failed before the record could be committed
+ */
+    bool        WaitDurable(cnp::QWORD qwSequence);
+
+/**
+    @brief Starts a new segment, every record appended so far is moved
+           into the rotated segment
+
+    Only the cut is made by the caller, the log thread writes out &
+    renames the segment.  Should a rotated segment still exist, the
+    records are added to it.
+ */
+    void        Rotate(void);
+
+/**
+    @brief Deletes the rotated segment, once its records are all held by
+           a saved database
+ */
+    void        DiscardRotated(void);
+
+    inline SYNC_MODE get_Mode(void) const noexcept
+    { return m_eMode; };
+
+    inline bool      IsOpen(void) const noexcept
+    { return m_pThread != nullptr; };
+
+private:
+    void        Run   (void);
+    bool        Write (const std::vector<char>& vecData) noexcept;
+    bool        OpenFile  (const std::string& strFileName);
+    void        CloseFile (void) noexcept;
+    bool        SwitchFile(std::vector<char>& vecRotated);
+/// Marks a group committed, or else fails the log, called under m_Mutex
+    void        Commit    (bool bCommitted, cnp::QWORD qwGroupEnd) noexcept;
+
+    CNP_WriteAheadLog(const CNP_WriteAheadLog&);
+    CNP_WriteAheadLog& operator=(const CNP_WriteAheadLog&);
+};
+
+#endif
@@ -0,0 +1,242 @@
+/**
+ * @file   QueueBench.cpp
+ * @brief  Hand-off queue microbenchmark
+ *
+ * Measures the throughput of TTSQueue against TRingQueue, in MPMC & MPSC
+ * configuration, with single element & batched operations.  Every queue
+ * moves the same sequence of values from the producer to the consumer
+ * threads, whose sum is checked once they are done.  TTSQueue has no
+ * blocking pop, so its consumers poll, yielding when it is empty.
+ *
+ * Built by 'make bench', not part of the server.
+ *
+ *    usage: QueueBench [--producers=<n>] [--consumers=<n>] [--items=<n>]
+ *                      [--batch=<n>] [--capacity=<n>]
+ *
+ * @author Mark L. Short
+ * @date   October 16, 2026
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "TSQueue.h"
+#include "RingQueue.h"
+
+typedef unsigned long long  item_type;
+
+/// parameters shared by every run
+struct BENCH_CONFIG
+{
+    size_t  m_nProducers;
+    size_t  m_nConsumers;
+    size_t  m_nItems;      ///< items per producer
+    size_t  m_nBatch;
+    size_t  m_nCapacity;
+};
+
+/// outcome of a single run
+struct BENCH_RESULT
+{
+    double  m_dSeconds;
+    bool    m_bValid;      ///< every item was received exactly once
+};
+
+/**
+    Runs nProducers threads calling fnProduce(first, count) & nConsumers
+    threads calling fnConsume(sum&) until it returns false, then checks
+    that the sum of the consumed items matches what was produced
+ */
+template<class _Produce, class _Consume>
+static BENCH_RESULT RunBench(const BENCH_CONFIG& Config, _Produce fnProduce, _Consume fnConsume)
+{
+    std::atomic<item_type>      qwSum(0);
+    std::vector<std::thread>    vecThreads;
+
+    auto tpStart = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < Config.m_nConsumers; i++)
+    {
+        vecThreads.emplace_back([&]()
+        {
+            item_type qwLocal = 0;
+            fnConsume(qwLocal);
+            qwSum += qwLocal;
+        });
+    }
+
+    for (size_t i = 0; i < Config.m_nProducers; i++)
+        vecThreads.emplace_back([&, i]() { fnProduce(i * Config.m_nItems + 1, Config.m_nItems); });
+
+    for (auto& it : vecThreads)
+        it.join();
+
+    std::chrono::duration<double> dElapsed = std::chrono::steady_clock::now() - tpStart;
+
+    // items are numbered 1..n
+    item_type qwTotal    = static_cast<item_type>(Config.m_nProducers) * Config.m_nItems;
+    item_type qwExpected = qwTotal * (qwTotal + 1) / 2;
+
+    BENCH_RESULT Result = { dElapsed.count(), qwSum.load() == qwExpected };
+    return Result;
+}
+
+static BENCH_RESULT BenchTSQueue(const BENCH_CONFIG& Config)
+{
+    TTSQueue<item_type>  Queue;
+    std::atomic<size_t>  nRemaining(Config.m_nProducers * Config.m_nItems);
+
+    return RunBench(Config,
+        [&](item_type qwFirst, size_t nCount)
+        {
+            for (size_t i = 0; i < nCount; i++)
+                Queue.Push(qwFirst + i);
+        },
+        [&](item_type& qwSum)
+        {
+            item_type qwItem = 0;
+            while (nRemaining.load(std::memory_order_relaxed) > 0)
+            {
+                if (Queue.PopFront(qwItem))
+                {
+                    qwSum += qwItem;
+                    nRemaining--;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+}
+
+template<bool _bSingleConsumer>
+static BENCH_RESULT BenchRingQueue(const BENCH_CONFIG& Config, size_t nBatch)
+{
+    TRingQueue<item_type, _bSingleConsumer>  Queue(Config.m_nCapacity);
+    std::atomic<size_t>                      nRemaining(Config.m_nProducers * Config.m_nItems);
+
+    return RunBench(Config,
+        [&](item_type qwFirst, size_t nCount)
+        {
+            std::vector<item_type> vecBatch(nBatch);
+
+            for (size_t i = 0; i < nCount; )
+            {
+                size_t nFill = (nCount - i < nBatch) ? nCount - i : nBatch;
+                for (size_t j = 0; j < nFill; j++)
+                    vecBatch[j] = qwFirst + i + j;
+
+                // pushes what fits, then waits for room for the remainder
+                size_t nPushed = Queue.TryPushN(vecBatch.data(), nFill);
+                for (size_t j = nPushed; j < nFill; j++)
+                    Queue.Push(vecBatch[j]);
+
+                i += nFill;
+            }
+        },
+        [&](item_type& qwSum)
+        {
+            std::vector<item_type> vecBatch(nBatch);
+
+            for (;;)
+            {
+                size_t nCount = Queue.PopN(vecBatch.data(), nBatch);
+                if (nCount == 0)
+                    break;
+
+                for (size_t j = 0; j < nCount; j++)
+                    qwSum += vecBatch[j];
+
+                // the last consumer out releases the others
+                if (nRemaining.fetch_sub(nCount) == nCount)
+                    Queue.Close();
+            }
+        });
+}
+
+static void PrintResult(const char* szName, const BENCH_CONFIG& Config, const BENCH_RESULT& Result)
+{
+    double dItems = static_cast<double>(Config.m_nProducers * Config.m_nItems);
+
+    printf("  %-28s %10.3f s  %10.2f Mitems/s  %s\n", szName, Result.m_dSeconds,
+           dItems / Result.m_dSeconds / 1e6, Result.m_bValid ? "ok" : "CHECKSUM MISMATCH");
+}
+
+static bool ParseOption(const char* szArg, const char* szName, size_t& nValue)
+{
+    size_t cbName = strlen(szName);
+
+    if (strncmp(szArg, szName, cbName) != 0 || szArg[cbName] != '=')
+        return false;
+
+    nValue = strtoul(szArg + cbName + 1, nullptr, 10);
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    BENCH_CONFIG Config = { 2, 2, 1000000, 32, 4096 };
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!ParseOption(argv[i], "--producers", Config.m_nProducers) &&
+            !ParseOption(argv[i], "--consumers", Config.m_nConsumers) &&
+            !ParseOption(argv[i], "--items",     Config.m_nItems)     &&
+            !ParseOption(argv[i], "--batch",     Config.m_nBatch)     &&
+            !ParseOption(argv[i], "--capacity",  Config.m_nCapacity))
+        {
+            fprintf(stderr, "usage: %s [--producers=<n>] [--consumers=<n>] [--items=<n>] [--batch=<n>] [--capacity=<n>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (Config.m_nProducers == 0 || Config.m_nConsumers == 0 || Config.m_nBatch == 0)
+    {
+        fprintf(stderr, "producers, consumers & batch must be at least 1\n");
+        return 1;
+    }
+
+    printf("%zu producer(s), %zu consumer(s), %zu items each, batch %zu, capacity %zu\n",
+           Config.m_nProducers, Config.m_nConsumers, Config.m_nItems, Config.m_nBatch, Config.m_nCapacity);
+
+    bool bValid = true;
+    BENCH_RESULT Result;
+
+    Result = BenchTSQueue(Config);
+    PrintResult("TTSQueue", Config, Result);
+    bValid &= Result.m_bValid;
+
+    Result = BenchRingQueue<false>(Config, 1);
+    PrintResult("TMPMCQueue", Config, Result);
+    bValid &= Result.m_bValid;
+
+    Result = BenchRingQueue<false>(Config, Config.m_nBatch);
+    PrintResult("TMPMCQueue PushN/PopN", Config, Result);
+    bValid &= Result.m_bValid;
+
+    // the single consumer variant, whatever the configured consumer count
+    BENCH_CONFIG ConfigSC = Config;
+    ConfigSC.m_nConsumers = 1;
+
+    Result = BenchTSQueue(ConfigSC);
+    PrintResult("TTSQueue (1 consumer)", ConfigSC, Result);
+    bValid &= Result.m_bValid;
+
+    Result = BenchRingQueue<true>(ConfigSC, 1);
+    PrintResult("TMPSCQueue", ConfigSC, Result);
+    bValid &= Result.m_bValid;
+
+    Result = BenchRingQueue<true>(ConfigSC, Config.m_nBatch);
+    PrintResult("TMPSCQueue PushN/PopN", ConfigSC, Result);
+    bValid &= Result.m_bValid;
+
+    return bValid ? 0 : 1;
+}
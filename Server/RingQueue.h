@@ -0,0 +1,423 @@
+/******************************************/
+/**
+  @file   RingQueue.h
+  @brief  interface for the TRingQueue class.
+
+  Lock-free, bounded, multi-producer queue over a power of 2 ring of
+  sequenced cells, with optional blocking waits.  Intended to supersede
+  TTSQueue at the server's hand-off points: it never allocates once
+  constructed, producers & consumers only contend on their own cache
+  line, batches are claimed with a single atomic operation & idle
+  consumers sleep rather than spin.
+
+  @author Mark L. Short
+  @date   October 16, 2026
+*/
+/******************************************/
+
+#if !defined(__RING_QUEUE_H__)
+#define __RING_QUEUE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
+
+#ifdef __linux__
+    #include <linux/futex.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+#ifndef _ATOMIC_
+    #include <atomic>
+#endif
+
+#ifndef _CONDITION_VARIABLE_
+    #include <condition_variable>
+#endif
+
+#ifndef _MUTEX_
+    #include <mutex>
+#endif
+
+#ifndef _THREAD_
+    #include <thread>
+#endif
+
+#ifndef _UTILITY_
+    #include <utility>
+#endif
+
+/// size of the cache line the producer & consumer positions are kept apart by
+static const size_t   RING_CACHE_LINE_SIZE = 64;
+
+/// number of times a blocking call retries, yielding in between, before it sleeps
+static const unsigned RING_SPIN_COUNT      = 64;
+
+
+/// @brief Event count used to sleep until a queue changes state
+///
+/// A waiter registers with PrepareWait(), re-checks its condition & only
+/// then sleeps in Wait() on the key it was given, so that a notification
+/// issued in between is never lost.  Notifying without any registered
+/// waiters costs a fence & a load.  Sleeps on a futex on Linux, on a
+/// condition variable elsewhere.
+class CEventCount
+{
+    std::atomic<uint32_t>    m_uEpoch;
+    std::atomic<uint32_t>    m_nWaiters;
+#ifndef __linux__
+    std::mutex               m_Mutex;
+    std::condition_variable  m_cv;
+#endif
+
+public:
+    CEventCount(void) noexcept
+        : m_uEpoch(0), m_nWaiters(0)
+        { };
+
+/// Registers the caller as a waiter, returns the key to pass to Wait()
+    uint32_t PrepareWait(void) noexcept
+    {
+        m_nWaiters.fetch_add(1, std::memory_order_seq_cst);
+        return m_uEpoch.load(std::memory_order_seq_cst);
+    };
+
+/// Unregisters a waiter whose condition was met before it had to sleep
+    void CancelWait(void) noexcept
+    {
+        m_nWaiters.fetch_sub(1, std::memory_order_seq_cst);
+    };
+
+/// Sleeps until a notification issued after PrepareWait() returned uKey
+    void Wait(uint32_t uKey) noexcept
+    {
+#ifdef __linux__
+        while (m_uEpoch.load(std::memory_order_acquire) == uKey)
+            ::syscall(SYS_futex, &m_uEpoch, FUTEX_WAIT_PRIVATE, uKey, nullptr, nullptr, 0);
+#else
+        {
+            std::unique_lock<std::mutex> WaitLock(m_Mutex);
+            m_cv.wait(WaitLock, [this, uKey]() { return m_uEpoch.load() != uKey; });
+        }
+#endif
+        m_nWaiters.fetch_sub(1, std::memory_order_seq_cst);
+    };
+
+/// Wakes up to nCount waiters, if there are any
+    void Notify(unsigned nCount = 1) noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (m_nWaiters.load(std::memory_order_seq_cst) == 0)
+            return;
+
+#ifdef __linux__
+        m_uEpoch.fetch_add(1, std::memory_order_seq_cst);
+        ::syscall(SYS_futex, &m_uEpoch, FUTEX_WAKE_PRIVATE,
+                  (nCount > INT_MAX) ? INT_MAX : static_cast<int>(nCount), nullptr, nullptr, 0);
+#else
+        {
+            std::lock_guard<std::mutex> WaitLock(m_Mutex);
+            m_uEpoch.fetch_add(1, std::memory_order_seq_cst);
+        }
+        if (nCount == 1)
+            m_cv.notify_one();
+        else
+            m_cv.notify_all();
+#endif
+    };
+
+    void NotifyAll(void) noexcept
+        { Notify(UINT_MAX); };
+
+private:
+    CEventCount(const CEventCount&);
+    CEventCount& operator=(const CEventCount&);
+};
+
+
+/// @brief Bounded lock-free ring queue
+///
+/// Each cell carries a sequence number telling producers whether it is
+/// free & consumers whether it has been filled for the current lap, so
+/// positions are claimed with a compare-and-swap & no lock is ever taken
+/// on the fast path.  With _bSingleConsumer only one thread may pop, which
+/// spares it the compare-and-swap (MPSC), otherwise any number of threads
+/// may (MPMC).
+///
+/// @warning _Ty must be default constructible & assignable
+template<class _Ty, bool _bSingleConsumer = false>
+class TRingQueue
+{
+    struct CELL
+    {
+        std::atomic<size_t>  m_nSequence;
+        _Ty                  m_Item;
+    };
+
+    alignas(RING_CACHE_LINE_SIZE) std::atomic<size_t>  m_nEnqueuePos;
+    alignas(RING_CACHE_LINE_SIZE) std::atomic<size_t>  m_nDequeuePos;
+    alignas(RING_CACHE_LINE_SIZE) CELL*                m_pCells;
+    size_t                                             m_nMask;
+    std::atomic<bool>                                  m_bClosed;
+    CEventCount                                        m_ecNotEmpty;
+    CEventCount                                        m_ecNotFull;
+
+public:
+/// @param [in] nCapacity   number of items the queue holds, rounded up to a power of 2
+    explicit TRingQueue(size_t nCapacity)
+        : m_nEnqueuePos(0), m_nDequeuePos(0), m_pCells(nullptr), m_nMask(0),
+          m_bClosed(false), m_ecNotEmpty(), m_ecNotFull()
+    {
+        size_t nCells = 2;
+        while (nCells < nCapacity)
+            nCells <<= 1;
+
+        m_pCells = new CELL[nCells];
+        m_nMask  = nCells - 1;
+
+        for (size_t i = 0; i < nCells; i++)
+            m_pCells[i].m_nSequence.store(i, std::memory_order_relaxed);
+    };
+
+    ~TRingQueue()
+        { delete [] m_pCells; };
+
+/// Adds an element to the back of the queue, returns false if it is full
+    bool   TryPush (const _Ty& Item)
+        { return TryPushN(&Item, 1) == 1; };
+
+/// Removes the element at the front of the queue, returns false if it is empty
+    bool   TryPop  (_Ty& Item)
+        { return TryPopN(&Item, 1) == 1; };
+
+/// Adds up to nCount elements, in order, returns how many fit
+    size_t TryPushN(const _Ty* rgItems, size_t nCount);
+
+/// Removes up to nMax elements, in order, returns how many were removed
+    size_t TryPopN (_Ty* rgItems, size_t nMax);
+
+/// Adds an element, waiting for room if the queue is full.
+/// Returns false if the queue has been closed.
+    bool   Push    (const _Ty& Item);
+
+/// Removes an element, waiting for one if the queue is empty.
+/// Returns false if the queue has been closed.
+    bool   Pop     (_Ty& Item)
+        { return PopN(&Item, 1) == 1; };
+
+/// Removes up to nMax elements, waiting for at least one.
+/// Returns 0 if the queue has been closed.
+    size_t PopN    (_Ty* rgItems, size_t nMax);
+
+/// Releases every waiting thread & fails any further blocking call,
+/// elements still queued may be drained with TryPop()
+    void   Close   (void) noexcept
+    {
+        m_bClosed.store(true, std::memory_order_seq_cst);
+        m_ecNotEmpty.NotifyAll();
+        m_ecNotFull.NotifyAll();
+    };
+
+/// Reopens a closed queue
+    void   Open    (void) noexcept
+        { m_bClosed.store(false, std::memory_order_seq_cst); };
+
+    bool   IsClosed(void) const noexcept
+        { return m_bClosed.load(std::memory_order_acquire); };
+
+/// Returns the number of queued elements, only a snapshot while in use
+    size_t Size    (void) const noexcept
+    {
+        size_t nDequeue = m_nDequeuePos.load(std::memory_order_acquire);
+        size_t nEnqueue = m_nEnqueuePos.load(std::memory_order_acquire);
+        return (nEnqueue > nDequeue) ? nEnqueue - nDequeue : 0;
+    };
+
+    bool   IsEmpty (void) const noexcept
+        { return Size() == 0; };
+
+    size_t Capacity(void) const noexcept
+        { return m_nMask + 1; };
+
+private:
+    TRingQueue(const TRingQueue&);
+    TRingQueue& operator=(const TRingQueue&);
+};
+
+
+template<class _Ty, bool _bSingleConsumer>
+size_t TRingQueue<_Ty, _bSingleConsumer>::TryPushN(const _Ty* rgItems, size_t nCount)
+{
+    size_t nPos = m_nEnqueuePos.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+        // count the consecutive cells that are free for this lap
+        size_t nFree = 0;
+        while (nFree < nCount &&
+               m_pCells[(nPos + nFree) & m_nMask].m_nSequence.load(std::memory_order_acquire) == nPos + nFree)
+        {
+            nFree++;
+        }
+
+        if (nFree == 0)
+        {
+            intptr_t iDiff = static_cast<intptr_t>(m_pCells[nPos & m_nMask].m_nSequence.load(std::memory_order_acquire)) -
+                             static_cast<intptr_t>(nPos);
+
+            // the cell still holds last lap's element, the queue is full
+            if (iDiff < 0)
+                return 0;
+
+            // another producer has claimed the cell
+            nPos = m_nEnqueuePos.load(std::memory_order_relaxed);
+            continue;
+        }
+
+        if (m_nEnqueuePos.compare_exchange_weak(nPos, nPos + nFree, std::memory_order_relaxed))
+        {
+            for (size_t i = 0; i < nFree; i++)
+            {
+                CELL& Cell = m_pCells[(nPos + i) & m_nMask];
+                Cell.m_Item = rgItems[i];
+                Cell.m_nSequence.store(nPos + i + 1, std::memory_order_release);
+            }
+
+            m_ecNotEmpty.Notify(static_cast<unsigned>(nFree));
+            return nFree;
+        }
+    }
+};
+
+template<class _Ty, bool _bSingleConsumer>
+size_t TRingQueue<_Ty, _bSingleConsumer>::TryPopN(_Ty* rgItems, size_t nMax)
+{
+    size_t nPos = m_nDequeuePos.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+        // count the consecutive cells that have been filled for this lap
+        size_t nReady = 0;
+        while (nReady < nMax &&
+               m_pCells[(nPos + nReady) & m_nMask].m_nSequence.load(std::memory_order_acquire) == nPos + nReady + 1)
+        {
+            nReady++;
+        }
+
+        if (nReady == 0)
+        {
+            intptr_t iDiff = static_cast<intptr_t>(m_pCells[nPos & m_nMask].m_nSequence.load(std::memory_order_acquire)) -
+                             static_cast<intptr_t>(nPos + 1);
+
+            // the cell has not been filled yet, the queue is empty
+            if (iDiff < 0 || _bSingleConsumer)
+                return 0;
+
+            // another consumer has claimed the cell
+            nPos = m_nDequeuePos.load(std::memory_order_relaxed);
+            continue;
+        }
+
+        if (_bSingleConsumer)
+            m_nDequeuePos.store(nPos + nReady, std::memory_order_relaxed);
+        else if (m_nDequeuePos.compare_exchange_weak(nPos, nPos + nReady, std::memory_order_relaxed) == false)
+            continue;
+
+        for (size_t i = 0; i < nReady; i++)
+        {
+            CELL& Cell = m_pCells[(nPos + i) & m_nMask];
+            rgItems[i] = std::move(Cell.m_Item);
+            // frees the cell for the next lap
+            Cell.m_nSequence.store(nPos + i + m_nMask + 1, std::memory_order_release);
+        }
+
+        m_ecNotFull.Notify(static_cast<unsigned>(nReady));
+        return nReady;
+    }
+};
+
+template<class _Ty, bool _bSingleConsumer>
+bool TRingQueue<_Ty, _bSingleConsumer>::Push(const _Ty& Item)
+{
+    for (unsigned nSpin = 0; ; nSpin++)
+    {
+        if (IsClosed())
+            return false;
+
+        if (TryPush(Item))
+            return true;
+
+        // a consumer is usually about to make room, sleeping costs a system call either side
+        if (nSpin < RING_SPIN_COUNT)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        uint32_t uKey = m_ecNotFull.PrepareWait();
+
+        if (IsClosed())
+        {
+            m_ecNotFull.CancelWait();
+            return false;
+        }
+
+        if (TryPush(Item))
+        {
+            m_ecNotFull.CancelWait();
+            return true;
+        }
+
+        m_ecNotFull.Wait(uKey);
+    }
+};
+
+template<class _Ty, bool _bSingleConsumer>
+size_t TRingQueue<_Ty, _bSingleConsumer>::PopN(_Ty* rgItems, size_t nMax)
+{
+    for (unsigned nSpin = 0; ; nSpin++)
+    {
+        if (IsClosed())
+            return 0;
+
+        size_t nCount = TryPopN(rgItems, nMax);
+        if (nCount > 0)
+            return nCount;
+
+        if (nSpin < RING_SPIN_COUNT)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        uint32_t uKey = m_ecNotEmpty.PrepareWait();
+
+        if (IsClosed())
+        {
+            m_ecNotEmpty.CancelWait();
+            return 0;
+        }
+
+        nCount = TryPopN(rgItems, nMax);
+        if (nCount > 0)
+        {
+            m_ecNotEmpty.CancelWait();
+            return nCount;
+        }
+
+        m_ecNotEmpty.Wait(uKey);
+    }
+};
+
+
+/// Multi-producer, multi-consumer ring queue
+template<class _Ty>
+using TMPMCQueue = TRingQueue<_Ty, false>;
+
+/// Multi-producer, single-consumer ring queue
+template<class _Ty>
+using TMPSCQueue = TRingQueue<_Ty, true>;
+
+#endif
@@ -5,6 +5,9 @@
 
   Thread Safe Queue with Associated Critical Section.
 
+  Superseded by TRingQueue (RingQueue.h), which does not allocate per
+  element & supports blocking pops.
+
   @author Mark L. Short
   @date February 1, 2006
 */
@@ -118,16 +121,17 @@ bool TTSQueue<_Ty>::GetItems(items_type& Items, bool bLock /* = true */) const
 {  
     bool bResult = false;
 
-    _Lock lock;
+    TLock<const _Myt> lock;
     if (bLock)
         lock.SetLock(this);
 
     if (m_que.empty() == false)
         {
         bResult = true;
-// m_que is not empty... now start filling the returned Items for the caller
-        for (auto it = m_que.begin(); it != m_que.end(); it++)
-            Items.push_back(it->GetItem());
+// m_que is not empty... std::queue cannot be iterated, so drain a copy of it
+        que_type queCopy(m_que);
+        for (; queCopy.empty() == false; queCopy.pop())
+            Items.push_back(queCopy.front());
         }
 
     return bResult;
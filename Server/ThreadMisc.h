@@ -38,22 +38,27 @@ template<class _Ty>
 class TLock
 {
     _Ty* m_pCS;
+    bool m_bLocked;
 
 protected:
 
 /// Declare the Default and Copy Constructor protected 
 /// so the class cannot be instantiated in this manner
-    TLock(const TLock<_Ty>&):m_pCS(0) {};
-    TLock(_Ty* pCS):m_pCS(pCS)        {};
+    TLock(const TLock<_Ty>&):m_pCS(0), m_bLocked(false) {};
+    TLock(_Ty* pCS):m_pCS(pCS), m_bLocked(false)        {};
 
 public:
-    TLock():m_pCS(0)                  {};
+    TLock():m_pCS(0), m_bLocked(false)                  {};
+
+/// Releases a lock still held when going out of scope
+    ~TLock()
+        { Unlock(); };
 
     void Lock(void)
-        { if (m_pCS) m_pCS->Lock(); };
+        { if (m_pCS && !m_bLocked) { m_pCS->Lock(); m_bLocked = true; } };
 
     void Unlock(void)
-        { if (m_pCS) m_pCS->Unlock(); };
+        { if (m_pCS && m_bLocked) { m_bLocked = false; m_pCS->Unlock(); } };
 
     void SetLock(_Ty* pCS)
         { m_pCS = pCS; Lock(); };